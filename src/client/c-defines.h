@@ -8,7 +8,7 @@
 
 #define CLIENT_VERSION_MAJOR	1
 #define CLIENT_VERSION_MINOR	5
-#define CLIENT_VERSION_PATCH	3
+#define CLIENT_VERSION_PATCH	4
 
 /*
  * This value specifys the suffix to the version info sent to the metaserver.
@@ -59,6 +59,9 @@
 /* Speed of slash fx effect */
 #define SLASH_FX_THRESHOLD 500
 
+/* Slash fx animation frame length (in ms) */
+#define SLASH_FX_FRAME 20
+
 /*** SERVER DEFINES ***/
 /* Sometimes, we just copy defines from server.
  * Why not have them in common/ ? Because they ultimately are different values
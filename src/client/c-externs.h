@@ -22,6 +22,7 @@ extern cptr macro_trigger_keycode[2][MAX_MACRO_TRIGGER];
 /* c-tables.c */
 extern s16b ddx[10];
 extern s16b ddy[10];
+extern s16b ddd[9];
 extern char hexsym[16];
 extern byte ascii_to_color[128]; 
 extern option_type local_option_info[MAX_OPTIONS];
@@ -107,6 +108,7 @@ extern cptr stream_desc[32];
 
 extern cave_view_type sfx_info[MAX_HGT][MAX_WID];
 extern s32b sfx_delay[MAX_HGT][MAX_WID];
+extern s32b sfx_next;
 extern void slashfx_dir_offset(int *x, int *y, int dir, bool invert);
 
 extern cave_view_type air_info[MAX_HGT][MAX_WID];
@@ -114,6 +116,7 @@ extern s32b air_delay[MAX_HGT][MAX_WID];
 extern s32b air_fade[MAX_HGT][MAX_WID];
 extern bool air_updates;
 extern bool air_refresh;
+extern s32b air_next;
 
 extern player_type player;
 extern player_type *p_ptr;
@@ -519,7 +522,9 @@ extern int cavestr(cave_view_type* dest, cptr src, byte attr, int max_col);
 extern void mem_line(int y, int x, int cols);
 extern void show_line(int y, s16b cols, bool mem, int st);
 extern void show_char(s16b y, s16b x, byte a, char c, byte ta, char tc, bool mem);
+extern void wake_air(void);
 extern void update_air(void);
+extern void wake_slashfx(void);
 extern void update_slashfx(void);
 extern void prt_num(cptr header, int num, int row, int col, byte color);
 extern void prt_lnum(cptr header, s32b num, int row, int col, byte color);
@@ -576,6 +581,8 @@ extern void do_handle_message(cptr mesg, u16b type);
 
 /* net-client.c */
 extern s16b state;
+extern void (*packet_aux)(byte pkt, int len);
+extern int (*wait_aux)(int fd, int timeout);
 extern bool net_term_clamp(byte win, byte *y, byte *x);
 extern u32b net_term_manage(u32b* old_flag, u32b* new_flag, bool clear);
 extern u32b net_term_update(bool clear);
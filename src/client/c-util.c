@@ -2402,11 +2402,34 @@ void slashfx_dir_offset(int *x, int *y, int dir, bool invert)
 	*x = dir_offset_x[dir - 1] * (invert ? 1 : 1);
 	*y = dir_offset_y[dir - 1] * (invert ? 1 : 1);
 }
+static micro sfx_left = 0;
+
+/*
+ * Start the slash effect clock, unless it's already running
+ */
+void wake_slashfx()
+{
+	/* Don't count the time we spent idle */
+	if (!sfx_next)
+	{
+		static_timer(3);
+		sfx_left = 0;
+	}
+	sfx_next = 1;
+}
 void update_slashfx()
 {
-	micro passed = static_timer(3);
-	u16b milli = (u16b)(passed / 1000);
+	micro passed = static_timer(3) + sfx_left;
+	s32b milli = (s32b)(passed / 1000);
+	s32b next = 0;
 	int j, i;
+
+	/* Keep the fraction of a millisecond for next time */
+	sfx_left = passed % 1000;
+
+	/* Nothing to animate */
+	if (!sfx_next) return;
+
 	for (j = 0; j < MAX_HGT; j++)
 	{
 		for (i = 0; i < MAX_WID; i++)
@@ -2419,11 +2442,19 @@ void update_slashfx()
 				{
 					sfx_delay[j][i] = 0;
 				}
+				/* Remember the soonest one */
+				else if (!next || sfx_delay[j][i] < next)
+				{
+					next = sfx_delay[j][i];
+				}
 				/* Draw same tile */
 				refresh_char_aux(i, j);
 			}
 		}
 	}
+
+	/* Come back for the next frame */
+	sfx_next = (next ? MIN(next, SLASH_FX_FRAME) : 0);
 }
 void discard_slashfx(int y, int x)
 {
@@ -2679,6 +2710,22 @@ void show_line(int sy, s16b cols, bool mem, int st)
 		cavedraw(stream_cave(st, sy)+xoff, cols+coff, xoff, sy);
 }
 
+static micro air_left = 0;
+
+/*
+ * Start the air layer clock, unless it's already running
+ */
+void wake_air()
+{
+	/* Don't count the time we spent idle */
+	if (!air_next)
+	{
+		static_timer(2);
+		air_left = 0;
+	}
+	air_next = 1;
+}
+
 /*
  * Handle the air layer
  */
@@ -2715,9 +2762,17 @@ void show_line(int sy, s16b cols, bool mem, int st)
  */
 void update_air()
 {
-	micro passed = static_timer(2);
-	u16b milli = (u16b)(passed / 1000);
+	micro passed = static_timer(2) + air_left;
+	s32b milli = (s32b)(passed / 1000);
+	s32b next = 0;
 	int j, i;
+
+	/* Keep the fraction of a millisecond for next time */
+	air_left = passed % 1000;
+
+	/* Nothing in the air */
+	if (!air_next) return;
+
 	for (j = 0; j < MAX_HGT; j++)
 	{
 		for (i = 0; i < MAX_WID; i++)
@@ -2738,6 +2793,11 @@ void update_air()
 							p_ptr->trn_info[j][i].c, FALSE);
 					}
 				}
+				/* Remember the soonest one */
+				else if (!next || air_delay[j][i] < next)
+				{
+					next = air_delay[j][i];
+				}
 			}
 			if (air_fade[j][i] > 0)
 			{
@@ -2756,9 +2816,17 @@ void update_air()
 							p_ptr->trn_info[j][i].c, FALSE);
 					}
 				}
+				/* Remember the soonest one */
+				else if (!next || air_fade[j][i] < next)
+				{
+					next = air_fade[j][i];
+				}
 			}
 		}
 	}
+
+	/* Come back when it's time */
+	air_next = next;
 }
 
 void prt_num(cptr header, int num, int row, int col, byte color)
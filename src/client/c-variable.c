@@ -70,12 +70,14 @@ cptr stream_desc[32];
 
 cave_view_type sfx_info[MAX_HGT][MAX_WID] = { 0 };
 s32b sfx_delay[MAX_HGT][MAX_WID] = { 0 };
+s32b sfx_next = 0; /* Milliseconds until "update_slashfx()" has work, 0 if none */
 
 cave_view_type air_info[MAX_HGT][MAX_WID] = { 0 };
 s32b air_delay[MAX_HGT][MAX_WID] = { 0 };
 s32b air_fade[MAX_HGT][MAX_WID] = { 0 };
 bool air_updates = TRUE;
 bool air_refresh = TRUE;
+s32b air_next = 0; /* Milliseconds until "update_air()" has work, 0 if none */
 
 int lag_ok;				/* server understands lag-check packets */
 
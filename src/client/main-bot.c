@@ -0,0 +1,840 @@
+/* File: main-bot.c */
+
+/* Purpose: Headless load-testing client, "mangbot" */
+
+/*
+ * Usage: mangbot [--bots N] [--time SEC] [--seed S] [--first K]
+ *                [--depth D] [--delay MSEC] [SERVER [PORT]]
+ *
+ * Forks N processes, each of which runs the normal client code on top
+ * of a "null" terminal, and plays character "BotK", "BotK+1", etc. A
+ * bot answers the birth prompts (so new characters are created, and old
+ * ones are simply logged in), then walks about, fights whatever gets in
+ * its way, rests once in a while and takes stairs down to level D and
+ * back.  All decisions come from a per-bot random seed, so the same
+ * command line always produces the same workload.
+ *
+ * When every bot is done, the parent prints a summary:
+ *
+ *  - Command round-trip latency, from sending a "walk" or "stairs"
+ *    command until the first player cursor update or message arrives.
+ *  - Bytes per second received by each client.
+ *  - Tick jitter, as the spread of keepalive round-trips: the server
+ *    echoes those as soon as it reads them, so any delay on top of the
+ *    network is time spent waiting for the game turn to finish.
+ *
+ * This is a Unix-only tool (it needs "fork()").
+ */
+
+#include "c-angband.h"
+
+#include <sys/wait.h>
+#include <math.h>
+
+
+#define BOT_HIST	10000	/* Histogram size */
+#define BOT_RTT_STEP	1000	/* Command round-trip buckets (usec) */
+#define BOT_TICK_STEP	100	/* Keepalive round-trip buckets (usec) */
+#define BOT_TIMEOUT	1000000	/* Give up waiting for a reply (usec) */
+#define BOT_LOGIN	60000000	/* Give up trying to enter the game (usec) */
+#define BOT_THINK	100000	/* Pause between commands (usec) */
+#define BOT_REST_EVERY	40	/* Rest after that many commands */
+#define BOT_REST_TIME	2000000	/* Pause after resting (usec) */
+
+#define BOT_PASS	"botpass"
+
+/* What the bot is waiting for */
+#define BOT_IDLE	0
+#define BOT_WALK	1
+#define BOT_STAIRS	2
+
+/*
+ * Everything a bot reports back to the parent
+ */
+typedef struct bot_report bot_report;
+
+struct bot_report
+{
+	s32b id;
+	s32b playing;	/* Entered the game */
+	s32b failed;	/* Quit with an error */
+
+	micro login;	/* Time it took to enter the game */
+	micro played;	/* Time spent playing */
+
+	u32b walks;
+	u32b fights;
+	u32b rests;
+	u32b stairs;
+	u32b levels;
+	u32b timeouts;
+
+	u32b bytes;	/* Received while playing */
+	u32b packets;
+
+	micro rtt_sum;	/* Command round-trips */
+	micro rtt_max;
+	u32b rtt[BOT_HIST + 1];		/* (BOT_RTT_STEP buckets) */
+
+	micro tick_max;	/* Keepalive round-trips */
+	u32b tick[BOT_HIST + 1];	/* (BOT_TICK_STEP buckets) */
+};
+
+static bot_report bot;
+
+static term bot_term;
+
+static int bot_fd = -1;		/* Pipe to the parent */
+
+static u32b bot_seed;
+static s32b bot_depth;		/* Deepest level to visit */
+static s32b bot_secs;		/* How long to play */
+
+static micro bot_begin;		/* Started connecting */
+static micro bot_entered;	/* Entered the game */
+static micro bot_until;		/* Time to quit */
+static micro bot_sent;		/* Sent the last command */
+static micro bot_next;		/* Time for the next command */
+static micro bot_key;		/* Refused the last prompt */
+
+static int bot_wait;		/* Waiting for a reply (BOT_xxx) */
+static int bot_count;		/* Commands since the last rest */
+static int bot_dir;		/* Wandering direction */
+static bool bot_down = TRUE;	/* Heading down */
+static bool bot_on_stairs;	/* Standing on the right stairs */
+static s16b bot_old_depth;
+
+static int bot_sy, bot_sx;	/* Screen location */
+static int bot_wy, bot_wx;	/* ... and matching world location */
+
+
+/*
+ * Current time in usec
+ */
+static micro bot_time(void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+
+	return ((micro)tv.tv_sec * 1000000 + tv.tv_usec);
+}
+
+/*
+ * Simple reproducible random numbers
+ */
+static int bot_rand(int m)
+{
+	bot_seed = bot_seed * 1103515245L + 12345;
+
+	return ((int)((bot_seed >> 16) % m));
+}
+
+/*
+ * Add a sample to a histogram
+ */
+static void bot_note(u32b *hist, int step, micro usec)
+{
+	hist[MIN(MAX(usec, 0) / step, BOT_HIST)]++;
+}
+
+
+/*
+ * Handle every packet from the server
+ */
+static void bot_packet(byte pkt, int len)
+{
+	micro now;
+
+	/* Only count the game itself */
+	if (state != PLAYER_PLAYING) return;
+
+	bot.bytes += len;
+	bot.packets++;
+
+	/* Keepalive round-trip (in 100 usec units, may overflow to negative) */
+	if (pkt == PKT_KEEPALIVE)
+	{
+		now = (micro)(u16b)lag_mark * 100;
+
+		bot_note(bot.tick, BOT_TICK_STEP, now);
+		bot.tick_max = MAX(bot.tick_max, now);
+	}
+
+	/* Reply to our command */
+	if (bot_wait && ((pkt == PKT_CURSOR) || (pkt == PKT_MESSAGE)))
+	{
+		now = bot_time() - bot_sent;
+
+		bot_note(bot.rtt, BOT_RTT_STEP, now);
+		bot.rtt_sum += now;
+		bot.rtt_max = MAX(bot.rtt_max, now);
+
+		bot_wait = BOT_IDLE;
+	}
+}
+
+
+/*
+ * Does screen row "row" contain "what"?
+ */
+static bool bot_row_has(int row, cptr what)
+{
+	char buf[256];
+	int w = MIN(Term->wid, 255);
+
+	if (row >= Term->hgt) return (FALSE);
+
+	memcpy(buf, Term->scr->c[row], w);
+	buf[w] = '\0';
+
+	return (strstr(buf, what) != NULL);
+}
+
+/*
+ * Answer a prompt, and erase it so it is not answered twice
+ */
+static void bot_answer(int row, char key)
+{
+	Term_erase(0, row, 255);
+	Term_keypress(key);
+}
+
+/*
+ * Answer the name, password and birth prompts
+ */
+static void bot_birth(void)
+{
+	int x;
+
+	/* Give up */
+	if (bot_time() - bot_begin > BOT_LOGIN) quit("Unable to enter the game");
+
+	/* Keep the default name and password */
+	if (bot_row_has(21, "Enter your player's name") ||
+	    bot_row_has(21, "Enter your password"))
+	{
+		bot_answer(21, '\r');
+	}
+
+	else if (bot_row_has(20, "Choose a sex"))
+	{
+		bot_answer(20, (bot.id % 2) ? 'f' : 'm');
+	}
+
+	else if (bot_row_has(20, "Choose a race"))
+	{
+		bot_answer(20, I2A(bot.id % 4));
+	}
+
+	else if (bot_row_has(20, "Choose a class"))
+	{
+		bot_answer(20, I2A((bot.id / 4) % 4));
+	}
+
+	/* Take the first stat still available */
+	else if (bot_row_has(20, "Choose your stat order"))
+	{
+		for (x = 1; x < Term->wid; x++)
+		{
+			if (Term->scr->c[21][x] != ')') continue;
+
+			bot_answer(20, Term->scr->c[21][x - 1]);
+			break;
+		}
+	}
+
+	else if (bot_row_has(21, "Entering game"))
+	{
+		bot_answer(21, ' ');
+	}
+}
+
+
+/*
+ * What is shown at screen grid (y, x) of the map
+ */
+static char bot_look(int y, int x)
+{
+	int y0 = DUNGEON_OFFSET_Y;
+	int x0 = DUNGEON_OFFSET_X;
+
+	if ((y < y0) || (y >= y0 + p_ptr->stream_hgt[0])) return (0);
+	if ((x < x0) || (x >= x0 + p_ptr->stream_wid[0])) return (0);
+	if ((y >= Term->hgt) || (x >= Term->wid)) return (0);
+
+	return (Term->scr->c[y][x]);
+}
+
+/*
+ * Can we walk onto a grid showing "c"?
+ */
+static bool bot_passable(char c)
+{
+	if (!c || isalpha((unsigned char)c)) return (FALSE);
+
+	return (strchr("#%:*^@", c) == NULL);
+}
+
+/*
+ * Find ourselves on the map
+ *
+ * Other players look just the same, so pick the "@" closest to where
+ * the last move (as reported by the server) should have taken us.
+ */
+static void bot_locate(void)
+{
+	int y, x, d, best = 1000;
+	int ey, ex;
+
+	ey = bot_sy + (p_ptr->py - bot_wy);
+	ex = bot_sx + (p_ptr->px - bot_wx);
+
+	for (y = 0; y < Term->hgt; y++)
+	{
+		for (x = 0; x < Term->wid; x++)
+		{
+			if (bot_look(y, x) != '@') continue;
+
+			d = MAX(ABS(y - ey), ABS(x - ex));
+			if (d >= best) continue;
+
+			best = d;
+			bot_sy = y;
+			bot_sx = x;
+		}
+	}
+
+	bot_wy = p_ptr->py;
+	bot_wx = p_ptr->px;
+}
+
+/*
+ * Send a custom command by its key
+ */
+static bool bot_command(char key)
+{
+	custom_command_type *cc_ptr = match_custom_command(key, FALSE);
+
+	if (!cc_ptr) return (FALSE);
+
+	send_custom_command((byte)(cc_ptr - custom_command), 0, 0, 0, NULL);
+
+	return (TRUE);
+}
+
+/*
+ * Start waiting for a reply
+ */
+static void bot_send(int what)
+{
+	bot_wait = what;
+	bot_sent = bot_time();
+}
+
+/*
+ * Pick and send the next command
+ */
+static void bot_think(void)
+{
+	micro now = bot_time();
+	char stairs, c;
+	int i, y, x, d, best;
+	int dir = 0;
+
+	/* Just entered the game */
+	if (!bot_entered)
+	{
+		bot_entered = now;
+		bot_until = now + (micro)bot_secs * 1000000;
+
+		bot.playing = 1;
+		bot.login = now - bot_begin;
+
+		bot_old_depth = p_ptr->dun_depth;
+
+		/* New characters start on the town stairs, try them */
+		bot_on_stairs = TRUE;
+	}
+
+	/* Done */
+	if (now >= bot_until) quit(NULL);
+
+	/* Something is asking a question, refuse */
+	if (!inkey_flag)
+	{
+		if (now - bot_key > BOT_THINK)
+		{
+			Term_keypress(ESCAPE);
+			bot_key = now;
+		}
+		return;
+	}
+
+	/* Waiting for a reply */
+	if (bot_wait)
+	{
+		if (now - bot_sent < BOT_TIMEOUT) return;
+
+		bot.timeouts++;
+		bot_wait = BOT_IDLE;
+	}
+
+	/* Not yet */
+	if (now < bot_next) return;
+	bot_next = now + BOT_THINK;
+
+	/* Changed level */
+	if (p_ptr->dun_depth != bot_old_depth)
+	{
+		bot_old_depth = p_ptr->dun_depth;
+		bot.levels++;
+
+		if (p_ptr->dun_depth >= bot_depth) bot_down = FALSE;
+		if (p_ptr->dun_depth <= 0) bot_down = TRUE;
+	}
+
+	stairs = (bot_down ? '>' : '<');
+
+	/* Rest once in a while */
+	if (++bot_count >= BOT_REST_EVERY)
+	{
+		bot_count = 0;
+		bot.rests++;
+
+		send_rest();
+		bot_next = now + BOT_REST_TIME;
+		return;
+	}
+
+	/* Take the stairs */
+	if (bot_on_stairs)
+	{
+		bot_on_stairs = FALSE;
+
+		if (bot_command(stairs))
+		{
+			bot.stairs++;
+			bot_send(BOT_STAIRS);
+			return;
+		}
+	}
+
+	bot_locate();
+
+	/* Fight */
+	for (i = 1; i < 10; i++)
+	{
+		c = bot_look(bot_sy + ddy[i], bot_sx + ddx[i]);
+
+		if ((i == 5) || !isalpha((unsigned char)c)) continue;
+
+		bot.fights++;
+
+		send_walk(i);
+		bot_send(BOT_WALK);
+		return;
+	}
+
+	/* Head for the stairs */
+	for (best = 1000, y = 0; y < Term->hgt; y++)
+	{
+		for (x = 0; x < Term->wid; x++)
+		{
+			if (bot_look(y, x) != stairs) continue;
+
+			d = MAX(ABS(y - bot_sy), ABS(x - bot_sx));
+			if (d >= best) continue;
+
+			i = 5 + 3 * SGN(y - bot_sy) + SGN(x - bot_sx);
+			if (!bot_passable(bot_look(bot_sy + ddy[i], bot_sx + ddx[i]))) continue;
+
+			best = d;
+			dir = i;
+		}
+	}
+
+	/* Wander, keeping the same direction for a while (to explore) */
+	if (!dir)
+	{
+		if (bot_dir && !bot_rand(32)) bot_dir = 0;
+
+		if (bot_dir && bot_passable(bot_look(bot_sy + ddy[bot_dir], bot_sx + ddx[bot_dir])))
+		{
+			dir = bot_dir;
+		}
+
+		for (i = 0; !dir && (i < 16); i++)
+		{
+			d = ddd[bot_rand(8)];
+
+			if (bot_passable(bot_look(bot_sy + ddy[d], bot_sx + ddx[d]))) dir = d;
+		}
+
+		/* Trapped, try anything */
+		if (!dir) dir = ddd[bot_rand(8)];
+
+		bot_dir = dir;
+	}
+
+	/* Remember if we are about to step on the stairs */
+	bot_on_stairs = (bot_look(bot_sy + ddy[dir], bot_sx + ddx[dir]) == stairs);
+
+	bot.walks++;
+
+	send_walk(dir);
+	bot_send(BOT_WALK);
+}
+
+
+/*
+ * Sleep until the server says something, or it's time to think again
+ */
+static int bot_sleep(int fd, int timeout)
+{
+	micro now = bot_time();
+	micro next;
+
+	/* Still logging in, the screen tells us what to do */
+	if (state != PLAYER_PLAYING || !bot_entered) return (timeout);
+
+	/* Waiting for a reply */
+	if (bot_wait) next = bot_sent + BOT_TIMEOUT;
+
+	/* Waiting for the next command */
+	else next = bot_next;
+
+	/* Refusing a prompt */
+	if (bot_key + BOT_THINK > now) next = MIN(next, bot_key + BOT_THINK);
+
+	next = MIN(next, bot_until);
+
+	/* Hack -- never spin, we might be stuck in a prompt */
+	return ((int)MIN((micro)timeout, MAX(1, (next - now + 999) / 1000)));
+}
+
+/*
+ * The "null" terminal: nothing is drawn, and waiting for events is
+ * where the bot does its thinking
+ */
+static errr Term_xtra_bot(int n, int v)
+{
+	switch (n)
+	{
+		/* Wait for (or look for) an event */
+		case TERM_XTRA_EVENT:
+		{
+			if (state == PLAYER_PLAYING) bot_think();
+			else bot_birth();
+
+			return (0);
+		}
+
+		/* Nothing to flush, clear or refresh */
+		case TERM_XTRA_FLUSH:
+		case TERM_XTRA_CLEAR:
+		case TERM_XTRA_FRESH:
+		{
+			return (0);
+		}
+	}
+
+	/* Unknown */
+	return (1);
+}
+
+static void bot_term_init(void)
+{
+	term *t = &bot_term;
+
+	term_init(t, 80, 24, 256);
+
+	t->attr_blank = TERM_WHITE;
+	t->char_blank = ' ';
+
+	t->xtra_hook = Term_xtra_bot;
+
+	Term_activate(t);
+
+	ang_term[0] = t;
+
+	ANGBAND_SYS = "bot";
+}
+
+
+/*
+ * Report back to the parent and close down
+ */
+static void bot_quit(cptr s)
+{
+	if (bot_entered) bot.played = bot_time() - bot_entered;
+	if (s && s[0]) bot.failed = 1;
+
+	cleanup_network_client();
+
+	/* Hack -- the report is larger than a pipe, so disconnect first */
+	if (bot_fd != -1)
+	{
+		if (write(bot_fd, &bot, sizeof(bot)) != sizeof(bot))
+		{
+			/* Parent is gone, nothing to do */
+		}
+		close(bot_fd);
+		bot_fd = -1;
+	}
+
+	conf_done();
+
+	free_file_paths();
+}
+
+/*
+ * Play one bot (never returns)
+ */
+static void bot_play(int id, u32b seed, int argc, char **argv)
+{
+	const char **args;
+	char name[MAX_CHARS];
+	int i;
+
+	bot.id = id;
+	bot_seed = seed + id * 7919;
+	bot_begin = bot_time();
+
+	/* Hack -- put "--nick BotNNN" in front of the real arguments */
+	strnfmt(name, sizeof(name), "Bot%03d", id);
+
+	C_MAKE(args, argc + 2, cptr);
+	args[0] = argv[0];
+	args[1] = "--nick";
+	args[2] = name;
+	for (i = 1; i < argc; i++) args[i + 2] = argv[i];
+
+	clia_init(argc + 2, args);
+
+	/* Client Config-file */
+	conf_init(NULL);
+
+	/* Setup the file paths */
+	init_stuff();
+
+	bot_term_init();
+
+	/* Default name and password */
+	my_strcpy(nick, name, MAX_CHARS);
+	my_strcpy(pass, BOT_PASS, MAX_CHARS);
+	my_strcpy(real_name, "mangbot", MAX_CHARS);
+
+	/* Never save the config */
+	quit_aux = bot_quit;
+
+	packet_aux = bot_packet;
+	wait_aux = bot_sleep;
+
+	/** Initialize client and run main loop **/
+	client_init();
+}
+
+
+/*
+ * Pick a percentile from a histogram (in usec)
+ */
+static micro bot_percentile(u32b *hist, int step, int pct)
+{
+	u32b total = 0, seen = 0;
+	int i;
+
+	for (i = 0; i <= BOT_HIST; i++) total += hist[i];
+
+	for (i = 0; i <= BOT_HIST; i++)
+	{
+		seen += hist[i];
+
+		if ((double)seen * 100 >= (double)total * pct) break;
+	}
+
+	return ((micro)MIN(i, BOT_HIST) * step);
+}
+
+/*
+ * Standard deviation of a histogram (in usec)
+ */
+static double bot_stddev(u32b *hist, int step)
+{
+	double n = 0, sum = 0, sq = 0, v;
+	int i;
+
+	for (i = 0; i <= BOT_HIST; i++)
+	{
+		v = (i + 0.5) * step;
+
+		n += hist[i];
+		sum += hist[i] * v;
+		sq += hist[i] * v * v;
+	}
+
+	if (!n) return (0);
+
+	v = sq / n - (sum / n) * (sum / n);
+
+	return (v > 0 ? sqrt(v) : 0);
+}
+
+static void bot_summary(bot_report *all, int bots, s32b secs, s32b seed)
+{
+	static bot_report sum;
+	double bps, bps_min = 0, bps_max = 0, bps_sum = 0;
+	micro login = 0, tick50, tick99;
+	int i, j, playing = 0, failed = 0;
+	u32b cmds;
+
+	WIPE(&sum, bot_report);
+
+	for (i = 0; i < bots; i++)
+	{
+		bot_report *b = &all[i];
+
+		if (b->failed) failed++;
+		if (!b->playing) continue;
+
+		playing++;
+		login += b->login;
+
+		sum.walks += b->walks;
+		sum.fights += b->fights;
+		sum.rests += b->rests;
+		sum.stairs += b->stairs;
+		sum.levels += b->levels;
+		sum.timeouts += b->timeouts;
+		sum.bytes += b->bytes;
+		sum.packets += b->packets;
+
+		sum.rtt_sum += b->rtt_sum;
+		sum.rtt_max = MAX(sum.rtt_max, b->rtt_max);
+		sum.tick_max = MAX(sum.tick_max, b->tick_max);
+
+		for (j = 0; j <= BOT_HIST; j++)
+		{
+			sum.rtt[j] += b->rtt[j];
+			sum.tick[j] += b->tick[j];
+		}
+
+		/* Bytes per second */
+		bps = b->played ? (double)b->bytes * 1000000 / b->played : 0;
+
+		if (playing == 1 || bps < bps_min) bps_min = bps;
+		if (playing == 1 || bps > bps_max) bps_max = bps;
+		bps_sum += bps;
+	}
+
+	cmds = sum.walks + sum.fights + sum.stairs;
+
+	tick50 = bot_percentile(sum.tick, BOT_TICK_STEP, 50);
+	tick99 = bot_percentile(sum.tick, BOT_TICK_STEP, 99);
+
+	printf("mangbot: %d bots, %d seconds, seed %d\n", bots, (int)secs, (int)seed);
+	printf("Entered game : %d/%d (%d failed), %.2f sec average login\n",
+	       playing, bots, failed, playing ? (double)login / playing / 1000000 : 0.0);
+	printf("Commands     : %lu walks, %lu fights, %lu stairs, %lu rests, %lu levels, %lu timeouts\n",
+	       (unsigned long)sum.walks, (unsigned long)sum.fights,
+	       (unsigned long)sum.stairs, (unsigned long)sum.rests,
+	       (unsigned long)sum.levels, (unsigned long)sum.timeouts);
+	printf("Round-trip   : avg %.1f ms, p50 %.1f, p90 %.1f, p99 %.1f, max %.1f\n",
+	       (cmds > sum.timeouts) ? (double)sum.rtt_sum / (cmds - sum.timeouts) / 1000 : 0.0,
+	       bot_percentile(sum.rtt, BOT_RTT_STEP, 50) / 1000.0,
+	       bot_percentile(sum.rtt, BOT_RTT_STEP, 90) / 1000.0,
+	       bot_percentile(sum.rtt, BOT_RTT_STEP, 99) / 1000.0, sum.rtt_max / 1000.0);
+	printf("Bandwidth    : %.0f B/s per client (min %.0f, max %.0f), %lu packets\n",
+	       playing ? bps_sum / playing : 0.0, bps_min, bps_max,
+	       (unsigned long)sum.packets);
+	printf("Tick jitter  : keepalive p50 %.1f ms, p99 %.1f, max %.1f, stddev %.1f, p99-p50 %.1f\n",
+	       tick50 / 1000.0, tick99 / 1000.0, sum.tick_max / 1000.0,
+	       bot_stddev(sum.tick, BOT_TICK_STEP) / 1000.0, (tick99 - tick50) / 1000.0);
+}
+
+
+int main(int argc, char *argv[])
+{
+	s32b bots = 1, secs = 60, seed = 1, first = 1, delay = 100;
+	bot_report *all;
+	int *fds;
+	pid_t *pids;
+	int i, n, got;
+
+	/* Save the program name */
+	argv0 = argv[0];
+
+	/* Save command-line arguments */
+	clia_init(argc, (const char**)argv);
+
+	bot_depth = 3;
+	clia_read_int(&bots, "bots");
+	clia_read_int(&secs, "time");
+	clia_read_int(&seed, "seed");
+	clia_read_int(&first, "first");
+	clia_read_int(&bot_depth, "depth");
+	clia_read_int(&delay, "delay");
+
+	if (bots < 1) bots = 1;
+	bot_secs = secs;
+
+	C_MAKE(all, bots, bot_report);
+	C_MAKE(fds, bots, int);
+	C_MAKE(pids, bots, pid_t);
+
+	/* Spawn the bots, a little apart */
+	for (i = 0; i < bots; i++)
+	{
+		int pfd[2];
+
+		if (pipe(pfd)) quit("Unable to create a pipe");
+
+		pids[i] = fork();
+
+		if (pids[i] < 0) quit("Unable to fork");
+
+		/* Child */
+		if (!pids[i])
+		{
+			for (n = 0; n < i; n++) close(fds[n]);
+			close(pfd[0]);
+
+			bot_fd = pfd[1];
+			bot_play(first + i, (u32b)seed, argc, argv);
+
+			/* Not reached */
+			exit(1);
+		}
+
+		close(pfd[1]);
+		fds[i] = pfd[0];
+
+		usleep(delay * 1000);
+	}
+
+	/* Collect the reports */
+	for (i = 0; i < bots; i++)
+	{
+		for (got = 0; got < (int)sizeof(bot_report); got += n)
+		{
+			n = read(fds[i], (char *)&all[i] + got, sizeof(bot_report) - got);
+			if (n <= 0) break;
+		}
+
+		/* Died without a word */
+		if (got < (int)sizeof(bot_report))
+		{
+			WIPE(&all[i], bot_report);
+			all[i].id = first + i;
+			all[i].failed = 1;
+		}
+
+		close(fds[i]);
+	}
+
+	for (i = 0; i < bots; i++) waitpid(pids[i], NULL, 0);
+
+	bot_summary(all, bots, secs, seed);
+
+	return (0);
+}
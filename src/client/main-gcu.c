@@ -45,6 +45,9 @@
 
 #include "c-angband.h"
 
+#include "../common/net-basics.h"
+#include "../common/net-imps.h"
+
 
 #ifdef USE_GCU
 
@@ -760,6 +763,34 @@ static errr Term_xtra_gcu_event(int v)
 #endif	/* USE_GETCH */
 
 
+/*
+ * Prepare to sleep until a keypress or the network (see "wait_aux")
+ */
+static int Term_wait_gcu(int fd, int timeout)
+{
+#ifdef USE_GETCH
+	int i;
+
+	/* Curses may have read ahead, check its buffer */
+	nodelay(stdscr, TRUE);
+	i = getch();
+	nodelay(stdscr, FALSE);
+
+	/* A key is ready already, put it back */
+	if (i != ERR)
+	{
+		ungetch(i);
+		return (0);
+	}
+#endif
+
+	/* Let network_pause() watch the keyboard, too */
+	network_watch(0, NET_WANT_READ);
+
+	return (timeout);
+}
+
+
 /*
  * Handle a "special request"
  */
@@ -1145,6 +1176,9 @@ errr init_gcu(void)
 
 	term_screen = &tdata[0].t;
 
+	/* Wake up on keypresses, instead of polling for them */
+	wait_aux = Term_wait_gcu;
+
 	/* Success */
 	return (0);
 }
@@ -22,10 +22,15 @@ TODO:
 
 #include "c-angband.h"
 
+#include <float.h>
+
 #include "main-sdl2.h"
 #include "sdl-font.h"
 #include "sdl-sound.h"
 
+#include "../common/net-basics.h"
+#include "../common/net-imps.h"
+
 #ifdef WINDOWS
 double fmin(double x, double y)
 {
@@ -225,6 +230,15 @@ static bool sdl_combine_arrowkeys = FALSE;
 static int  sdl_combiner_delay = 50;
 static bool ignore_keyboard_layout = FALSE;
 static bool collapse_numpad_keys = FALSE;
+static bool sdl_batch_cells = FALSE; /* Opt-in until measured on real SDL */
+
+/* Frame statistics, see "--frame-stats" and "--benchmark" */
+static bool sdl_frame_stats = FALSE;
+static Uint32 stat_frames = 0;
+static Uint64 stat_ticks = 0;
+static Uint64 stat_worst = 0;
+static Uint32 stat_calls = 0;
+static Uint32 stat_quads = 0;
 
   ////////////////////////////
  /* ==== Icon Overlay ==== */
@@ -450,12 +464,32 @@ errr init_sdl2(void) {
 	z_ask_confirm_aux = Term2_ask_confirm;
 	z_ask_menu_aux = Term2_ask_menu;
 
+	/* Activate network sleeping hook */
+	wait_aux = waitHook;
+
+	/* Report frame times on exit */
+	clia_read_bool(&sdl_frame_stats, "frame-stats");
+
+	/* Measure cell drawing and quit */
+	{
+		s32b frames = 0;
+		if (clia_read_int(&frames, "benchmark") && frames > 0)
+		{
+			benchmarkTerm(frames);
+		}
+	}
+
 	return 0;
 }
 
 /* Our de-initializer */
 void quit_sdl2(cptr s)
 {
+	if (sdl_frame_stats)
+	{
+		printFrameStats("frames", stat_frames, stat_ticks, stat_worst);
+	}
+
 	/* save all values */
 	saveConfig();
 
@@ -976,6 +1010,7 @@ static errr refreshTerm(TermData *td) {
 	}
 
 	if (td->fb_w == w && td->fb_h == h) return 0;
+	discardTermCells(td);
 	if (td->framebuffer) SDL_DestroyTexture(td->framebuffer);
 
 	if ((td->framebuffer = SDL_CreateTexture(td->renderer,
@@ -1157,6 +1192,7 @@ This function destroys the SDL_Texture created by attachFont
 */
 errr detachFont(TermData *td)
 {
+	flushTermCells(td);
 	if (td->font_texture) SDL_DestroyTexture(td->font_texture);
 	td->font_texture = NULL;
 	td->font_data = NULL;
@@ -1238,6 +1274,7 @@ and deactivates pict-related settings
 */
 static errr detachPict(TermData *td)
 {
+	flushTermCells(td);
 	if (td->pict_texture) SDL_DestroyTexture(td->pict_texture);
 	td->pict_texture = NULL;
 	td->pict_data = NULL;
@@ -1256,6 +1293,12 @@ static void nukeTermHook(term *t)
 	unloadPict(td);
 
 	// destroy self
+	discardTermCells(td);
+#ifdef USE_SDL2_BATCH
+	freeBatch(&td->wipes);
+	freeBatch(&td->tiles);
+	freeBatch(&td->glyphs);
+#endif
 	if (td->framebuffer) SDL_DestroyTexture(td->framebuffer);
 	if (td->alt_framebuffer) SDL_DestroyTexture(td->alt_framebuffer);
 	td->framebuffer = td->alt_framebuffer = NULL;
@@ -1433,8 +1476,11 @@ static void altDungeonCutout(void)
 static void rerender()
 {
 	int i;
+	bool rendered = FALSE;
+	Uint64 start = SDL_GetPerformanceCounter();
 	for (i = 0; i < TERM_MAX; i++) {
 		if (!(terms[i].config & TERM_IS_ONLINE)) continue;
+		flushTermCells(&terms[i]);
 		if (terms[i].need_redraw) {
 			term *old_td = Term;
 			//if (i == TERM_MAIN) {
@@ -1468,8 +1514,16 @@ static void rerender()
 
 			renderWindow(&terms[i]);
 			terms[i].win_need_render = FALSE;
+			rendered = TRUE;
 		}
 	}
+	if (rendered)
+	{
+		Uint64 ticks = SDL_GetPerformanceCounter() - start;
+		stat_frames++;
+		stat_ticks += ticks;
+		if (ticks > stat_worst) stat_worst = ticks;
+	}
 }
 
 static void mustRerender(void)
@@ -2767,6 +2821,72 @@ static void TimeoutDelayedArrow()
 		DropDelayedArrow();
 	}
 }
+
+/* ==== Sleeping ==== */
+/* The main thread sleeps in SDL_WaitEventTimeout(), while a helper
+ * thread sleeps on the server socket, and wakes it up with an event. */
+static SDL_Thread *watch_thread = NULL;
+static SDL_sem *watch_sem = NULL;
+static SDL_atomic_t watch_fd;
+static SDL_atomic_t watch_armed;
+static Uint32 watch_event = (Uint32)-1;
+
+static int SDLCALL watchSocket(void *unused)
+{
+	SDL_Event event;
+	int fd;
+	while (SDL_SemWait(watch_sem) == 0)
+	{
+		/* Nap in slices, in case the socket changes under us */
+		while ((fd = SDL_AtomicGet(&watch_fd)) >= 0)
+		{
+			if (!network_readable(fd, 100000)) continue;
+			/* Ring the bell */
+			SDL_zero(event);
+			event.type = watch_event;
+			SDL_PushEvent(&event);
+			break;
+		}
+		SDL_AtomicSet(&watch_armed, 0);
+	}
+	return 0;
+}
+static int waitHook(int fd, int timeout)
+{
+	/* Don't sit on a delayed arrow key */
+	if (has_prev_arrow)
+	{
+		Uint32 diff = SDL_GetTicks() - prev_arrow_timestamp;
+		if (diff >= (Uint32)sdl_combiner_delay) return 0;
+		timeout = MIN(timeout, sdl_combiner_delay - (int)diff);
+	}
+	/* Start the watcher */
+	if (!watch_sem)
+	{
+		SDL_AtomicSet(&watch_fd, -1);
+		SDL_AtomicSet(&watch_armed, 0);
+		watch_event = SDL_RegisterEvents(1);
+		watch_sem = SDL_CreateSemaphore(0);
+		if (watch_sem && watch_event != (Uint32)-1)
+		{
+			watch_thread = SDL_CreateThread(watchSocket, "watchSocket", NULL);
+		}
+	}
+	/* No watcher, so keep polling */
+	if (!watch_thread)
+	{
+		timeout = MIN(timeout, 1);
+	}
+	/* Arm it, unless it's still watching */
+	else
+	{
+		SDL_AtomicSet(&watch_fd, fd);
+		if (fd >= 0 && SDL_AtomicCAS(&watch_armed, 0, 1)) SDL_SemPost(watch_sem);
+	}
+	SDL_WaitEventTimeout(NULL, timeout);
+	/* Just check the network, without waiting */
+	return 0;
+}
 /* Main function responsible for combining arrow keys.
  * It's a bit verbose, and has a measurable amount of code duplication,
  * but it's easier to debug specific cases, by following specific branches this way.
@@ -3094,9 +3214,11 @@ static errr xtraTermHook(int n, int v) {
 		/* HACK !!! -- Terminate current sound if necessary */
 		if (use_sound) sdl_play_sound_end(TRUE);
 #endif
+		flushTermCells(td);
 		td->need_render = TRUE;
 		return 0;
 	case TERM_XTRA_CLEAR:
+		discardTermCells(td);
 		SDL_SetRenderTarget(td->renderer, td->framebuffer);
 		SDL_SetRenderDrawBlendMode(td->renderer, SDL_BLENDMODE_NONE);
 		SDL_SetRenderDrawColor(td->renderer, 0, 0, 0, 255);
@@ -3133,7 +3255,9 @@ static errr cursTermHook(int x, int y)
 	     td->cell_h
 	};
 
-	/* Regular cursor */
+	/* Regular cursor goes on top of the cells */
+	flushTermCells(td);
+	SDL_SetRenderTarget(td->renderer, td->framebuffer);
 	SDL_SetRenderDrawColor(td->renderer, 128, 255, 64, 255);
 	SDL_RenderDrawRect(td->renderer, &cell_rect);
 
@@ -3150,6 +3274,289 @@ static errr cursTermHook(int x, int y)
 	return 0;
 }
 
+/* ==== Batched drawing ==== */
+/* Instead of one SDL_RenderCopy() per cell, the z-term hooks queue a
+ * quad for every cell background, tile and character, and
+ * flushTermCells() hands each kind to SDL_RenderGeometry() at once,
+ * with the color in the vertices: backgrounds, then tiles, then text.
+ * A cell may only be queued once between flushes, so that the order
+ * of overlapping draws stays the same. */
+#ifdef USE_SDL2_BATCH
+static int *quad_index = NULL;
+static int quad_index_max = 0;
+static bool quad_index_soft = FALSE;
+
+/* Two triangles per quad, corners numbered as in batchRect(). Hardware
+ * renderers draw SDL_RenderCopy() as a strip, split along the 1-2
+ * diagonal. The software renderer only turns a pair of triangles back
+ * into an SDL_RenderCopy() if they share the 0-3 diagonal, otherwise it
+ * rasterizes them itself, a pixel off. */
+static const int quad_corners[2][6] = {
+	{ 0, 1, 2, 2, 1, 3 },
+	{ 0, 1, 3, 0, 3, 2 },
+};
+
+static SDL_Vertex *batchQuad(CellBatch *b)
+{
+	if (b->num == b->max)
+	{
+		SDL_Vertex *vertices;
+		int max = MAX(b->max * 2, 256);
+		C_MAKE(vertices, max * 4, SDL_Vertex);
+		if (b->num) C_COPY(vertices, b->vertices, b->num * 4, SDL_Vertex);
+		if (b->vertices) FREE(b->vertices);
+		b->vertices = vertices;
+		b->max = max;
+	}
+	return &b->vertices[4 * b->num++];
+}
+
+/* Texture coordinates are queued in pixels, see flushBatch() */
+static void batchRect(CellBatch *b, const SDL_Rect *dst, const SDL_Rect *src, Uint8 r, Uint8 g, Uint8 bl)
+{
+	SDL_Vertex *v = batchQuad(b);
+	SDL_Color color;
+	float x0 = dst->x, y0 = dst->y;
+	float x1 = dst->x + dst->w, y1 = dst->y + dst->h;
+	float u0 = 0, v0 = 0, u1 = 0, v1 = 0;
+	int i;
+
+	if (src)
+	{
+		u0 = src->x;
+		v0 = src->y;
+		u1 = src->x + src->w;
+		v1 = src->y + src->h;
+	}
+
+	color.r = r;
+	color.g = g;
+	color.b = bl;
+	color.a = 255;
+
+	v[0].position.x = x0; v[0].position.y = y0;
+	v[0].tex_coord.x = u0; v[0].tex_coord.y = v0;
+	v[1].position.x = x1; v[1].position.y = y0;
+	v[1].tex_coord.x = u1; v[1].tex_coord.y = v0;
+	v[2].position.x = x0; v[2].position.y = y1;
+	v[2].tex_coord.x = u0; v[2].tex_coord.y = v1;
+	v[3].position.x = x1; v[3].position.y = y1;
+	v[3].tex_coord.x = u1; v[3].tex_coord.y = v1;
+	for (i = 0; i < 4; i++) v[i].color = color;
+}
+
+/* Turn pixel "px" into a texture coordinate. When the software renderer
+ * turns it back into pixels, it truncates, so round up by a hair to
+ * land on the same texel SDL_RenderCopy() would. */
+static float texelCoord(float px, int size, bool soft)
+{
+	float c = px / size;
+	if (soft) while (c * size < px) c *= 1.0f + FLT_EPSILON;
+	return c;
+}
+
+static void flushBatch(TermData *td, CellBatch *b, SDL_Texture *texture)
+{
+	SDL_RendererInfo info;
+	bool soft;
+	int i, tw, th;
+
+	if (!b->num) return;
+
+	soft = (SDL_GetRendererInfo(td->renderer, &info) == 0
+	     && (info.flags & SDL_RENDERER_SOFTWARE));
+
+	/* Indices are shared by all batches */
+	if (b->num > quad_index_max || soft != quad_index_soft)
+	{
+		int max = MAX(b->num, quad_index_max * 2);
+		if (quad_index) FREE(quad_index);
+		C_MAKE(quad_index, max * 6, int);
+		for (i = 0; i < max * 6; i++)
+		{
+			quad_index[i] = (i / 6) * 4 + quad_corners[soft ? 1 : 0][i % 6];
+		}
+		quad_index_max = max;
+		quad_index_soft = soft;
+	}
+
+	/* Normalize texture coordinates */
+	if (texture && SDL_QueryTexture(texture, NULL, NULL, &tw, &th) == 0)
+	{
+		for (i = 0; i < b->num * 4; i++)
+		{
+			b->vertices[i].tex_coord.x = texelCoord(b->vertices[i].tex_coord.x, tw, soft);
+			b->vertices[i].tex_coord.y = texelCoord(b->vertices[i].tex_coord.y, th, soft);
+		}
+	}
+
+	if (SDL_RenderGeometry(td->renderer, texture,
+	    b->vertices, b->num * 4, quad_index, b->num * 6) != 0)
+	{
+		plog_fmt("SDL_RenderGeometry(): %s", SDL_GetError());
+	}
+
+	stat_calls++;
+	stat_quads += b->num;
+	b->num = 0;
+}
+
+static void freeBatch(CellBatch *b)
+{
+	if (b->vertices) KILL(b->vertices);
+	b->num = b->max = 0;
+}
+
+/* Remember cell x, y is about to be queued. If it already was, flush
+ * first, so that the new quads end up on top of the old ones. */
+static void queueTermCell(TermData *td, int x, int y)
+{
+	int bit = y * 256 + x;
+	if (td->queued[bit >> 3] & (1 << (bit & 7)))
+	{
+		flushTermCells(td);
+	}
+	td->queued[bit >> 3] |= (1 << (bit & 7));
+}
+#endif
+
+static void flushTermCells(TermData *td)
+{
+#ifdef USE_SDL2_BATCH
+	if (!td->wipes.num && !td->tiles.num && !td->glyphs.num) return;
+
+	SDL_SetRenderTarget(td->renderer, td->framebuffer);
+
+	/* Backgrounds replace whatever was there, like wipeTermCell_UI() */
+	SDL_SetRenderDrawBlendMode(td->renderer, SDL_BLENDMODE_NONE);
+	flushBatch(td, &td->wipes, NULL);
+	SDL_SetRenderDrawBlendMode(td->renderer, SDL_BLENDMODE_BLEND);
+
+	/* Colors come with the vertices */
+	if (td->pict_texture)
+	{
+		flushBatch(td, &td->tiles, td->pict_texture);
+	}
+	if (td->font_texture)
+	{
+		SDL_SetTextureColorMod(td->font_texture, 255, 255, 255);
+		flushBatch(td, &td->glyphs, td->font_texture);
+	}
+
+	discardTermCells(td);
+#endif
+}
+
+static void discardTermCells(TermData *td)
+{
+#ifdef USE_SDL2_BATCH
+	td->wipes.num = td->tiles.num = td->glyphs.num = 0;
+	memset(td->queued, 0, sizeof(td->queued));
+#endif
+}
+
+/* Are the z-term hooks queueing cells right now? */
+static bool batchingCells(TermData *td)
+{
+#ifdef USE_SDL2_BATCH
+	return (sdl_batch_cells && td->framebuffer != NULL);
+#else
+	return FALSE;
+#endif
+}
+
+/* ==== Frame statistics ==== */
+static void printFrameStats(cptr what, Uint32 frames, Uint64 ticks, Uint64 worst)
+{
+	double ms = 1000.0 / (double)SDL_GetPerformanceFrequency();
+	if (!frames) return;
+	printf("%s: %lu frames, %.3f ms/frame avg, %.3f ms worst, %.1f draw calls/frame",
+		what, (unsigned long)frames, ticks * ms / frames, worst * ms,
+		(double)stat_calls / frames);
+	if (stat_quads) printf(", %.1f quads/call", (double)stat_quads / stat_calls);
+	printf("\n");
+}
+
+/* "mangclient --benchmark N" fills the main window with random
+ * characters (and tiles, in graphics mode) N times drawing one cell at
+ * a time, then N times batched, prints both timings and quits. No
+ * server is needed, and it runs headless with SDL_VIDEODRIVER=dummy
+ * SDL_RENDER_DRIVER=software. */
+static Uint64 benchmarkFrames(int frames, bool batch, Uint64 *worst)
+{
+	TermData *td = &terms[TERM_MAIN];
+	PictData *pd = td->pict_data;
+	int tiles_x = 0, tiles_y = 0;
+	Uint64 total = 0;
+	int i, x, y;
+
+	if (pd && use_graphics)
+	{
+		tiles_x = MIN(pd->surface->w / pd->w, 128);
+		tiles_y = MIN(pd->surface->h / pd->h, 128);
+	}
+
+	sdl_batch_cells = batch;
+	stat_calls = stat_quads = 0;
+	*worst = 0;
+
+	for (i = 0; i < frames; i++)
+	{
+		Uint64 start = SDL_GetPerformanceCounter();
+		Uint64 ticks;
+
+		for (y = 0; y < td->rows; y++)
+		{
+			for (x = 0; x < td->cols; x++)
+			{
+				if (tiles_x && tiles_y && (x + y + i) % 2)
+				{
+					byte a = 0x80 | randint0(tiles_y);
+					char c = 0x80 | randint0(tiles_x);
+					Term_queue_char(Term, x, y, a, c, a, c);
+				}
+				else
+				{
+					Term_putch(x, y, (byte)randint1(15), (char)(33 + randint0(94)));
+				}
+			}
+		}
+		Term_fresh();
+		rerender();
+
+		ticks = SDL_GetPerformanceCounter() - start;
+		total += ticks;
+		if (ticks > *worst) *worst = ticks;
+	}
+	return total;
+}
+
+static void benchmarkTerm(int frames)
+{
+	Uint64 plain, worst;
+	bool old_batch = sdl_batch_cells;
+
+	/* Settle the windows first */
+	rerender();
+
+	plain = benchmarkFrames(frames, FALSE, &worst);
+	printFrameStats("per-cell", frames, plain, worst);
+#ifdef USE_SDL2_BATCH
+	{
+		Uint64 batched = benchmarkFrames(frames, TRUE, &worst);
+		printFrameStats("batched ", frames, batched, worst);
+		if (batched) printf("speedup: %.2fx\n", (double)plain / batched);
+	}
+#else
+	printf("batched: needs SDL 2.0.18 or later\n");
+#endif
+
+	/* Don't report the benchmark again */
+	sdl_batch_cells = old_batch;
+	sdl_frame_stats = FALSE;
+	quit(NULL);
+}
+
 static void wipeTermCell_Cave(int x, int y)
 {
 	int n = 1;
@@ -3188,6 +3595,16 @@ static void wipeTermCell_UI(int x, int y, int cutout)
 	TermData *td = (TermData*)(Term->data);
 	SDL_Rect cell_rect = { x*td->cell_w, y*td->cell_h, td->cell_w*n, td->cell_h };
 
+#ifdef USE_SDL2_BATCH
+	if (!cutout && batchingCells(td))
+	{
+		queueTermCell(td, x, y);
+		batchRect(&td->wipes, &cell_rect, NULL, 0, 0, 0);
+		return;
+	}
+#endif
+	stat_calls++;
+
 	SDL_SetRenderTarget(td->renderer, td->framebuffer);
 	SDL_SetRenderDrawColor(td->renderer, 0, 0, 0, 255 - cutout * 255);
 	SDL_SetRenderDrawBlendMode(td->renderer, SDL_BLENDMODE_NONE);
@@ -3217,7 +3634,7 @@ static errr wipeTermHook(int x, int y, int n)
 	return 0;
 }
 
-static void textTermCell_Char(int x, int y, byte attr, char c)
+static void textTermCell_Char(int x, int y, byte attr, char c, bool queue)
 {
 	int w, h, offsetx, offsety;
 	float r;
@@ -3255,6 +3672,14 @@ static void textTermCell_Char(int x, int y, byte attr, char c)
 		int col = si - (row*16);
 		SDL_Rect char_rect = { col*fd->w, row*fd->h, fd->w, fd->h };
 
+#ifdef USE_SDL2_BATCH
+		if (queue)
+		{
+			batchRect(&td->glyphs, &cell_rect, &char_rect, TERM_RGB(attr));
+			return;
+		}
+#endif
+		stat_calls++;
 		SDL_RenderCopy(td->renderer, td->font_texture, &char_rect, &cell_rect);
 	}
 }
@@ -3285,7 +3710,7 @@ static errr textTermHook_ALT(int x, int y, int n, byte attr, cptr s)
 	for (i = 0; i < n; i++) {
 		wipeTermCell_ALT(x + i, y);
 //		SDL_SetRenderDrawBlendMode(td->renderer, SDL_BLENDMODE_BLEND);
-		textTermCell_Char(x + i, y, attr, s[i]);
+		textTermCell_Char(x + i, y, attr, s[i], FALSE);
 	}
 
 	/* Restore old mode */
@@ -3307,16 +3732,21 @@ static errr textTermHook(int x, int y, int n, byte attr, cptr s)
 	bool probably_cave = FALSE;
 	TermData *td = (TermData*)(Term->data);
 	struct FontData *fd = td->font_data;
-	SDL_SetTextureColorMod(td->font_texture, TERM_RGB(attr));
+	bool batch = batchingCells(td);
 
-	SDL_SetRenderTarget(td->renderer, td->framebuffer);
-	SDL_SetRenderDrawColor(td->renderer, 255, 255, 255, 255);
-	SDL_SetRenderDrawBlendMode(td->renderer, SDL_BLENDMODE_NONE);
+	if (!batch)
+	{
+		SDL_SetTextureColorMod(td->font_texture, TERM_RGB(attr));
+
+		SDL_SetRenderTarget(td->renderer, td->framebuffer);
+		SDL_SetRenderDrawColor(td->renderer, 255, 255, 255, 255);
+		SDL_SetRenderDrawBlendMode(td->renderer, SDL_BLENDMODE_NONE);
+	}
 
 	for (i = 0; i < n; i++)
 	{
 		wipeTermCell_UI(x + i, y, 0);
-		textTermCell_Char(x + i, y, attr, s[i]);
+		textTermCell_Char(x + i, y, attr, s[i], batch);
 		if (!probably_cave) probably_cave = looksLikeCave(x + i, y);
 	}
 
@@ -3329,7 +3759,7 @@ static errr textTermHook(int x, int y, int n, byte attr, cptr s)
 }
 
 
-static void pictTermCell_Tile(int x, int y, byte a, byte c, byte ta, byte tc)
+static void pictTermCell_Tile(int x, int y, byte a, byte c, byte ta, byte tc, bool queue)
 {
 	SDL_Rect cell_rect, terrain_rect, sprite_rect;
 	int offsetx, offsety, w, h;
@@ -3355,8 +3785,11 @@ static void pictTermCell_Tile(int x, int y, byte a, byte c, byte ta, byte tc)
 	offsetx = (td->cell_w / 2) - (w/2);
 	offsety = (td->cell_h / 2) - (h/2);
 
-	SDL_SetRenderDrawColor(td->renderer, 255, 255, 255, 255);
-	SDL_SetRenderDrawBlendMode(td->renderer, SDL_BLENDMODE_BLEND);
+	if (!queue)
+	{
+		SDL_SetRenderDrawColor(td->renderer, 255, 255, 255, 255);
+		SDL_SetRenderDrawBlendMode(td->renderer, SDL_BLENDMODE_BLEND);
+	}
 
 	cell_rect.x = x * td->cell_w + offsetx;
 	cell_rect.y = y * td->cell_h + offsety;
@@ -3386,6 +3819,26 @@ static void pictTermCell_Tile(int x, int y, byte a, byte c, byte ta, byte tc)
 		sf_y = prog * halfH * oy;
 	}
 
+#ifdef USE_SDL2_BATCH
+	if (queue)
+	{
+		if (use_graphics > 1)
+		{
+			batchRect(&td->tiles, &cell_rect, &terrain_rect, 255, 255, 255);
+			if (ta != a || tc != c)
+			{
+				cell_rect.x += sf_x;
+				cell_rect.y += sf_y;
+				batchRect(&td->tiles, &cell_rect, &sprite_rect, 255, 255, 255);
+			}
+		} else {
+			batchRect(&td->tiles, &cell_rect, &sprite_rect, 255, 255, 255);
+		}
+		return;
+	}
+#endif
+	stat_calls += (use_graphics > 1 && (ta != a || tc != c)) ? 2 : 1;
+
 	if (use_graphics > 1)
 	{
 		SDL_RenderCopy(td->renderer, td->pict_texture, &terrain_rect, &cell_rect);
@@ -3436,7 +3889,7 @@ static errr pictTermHook_ALT(int x, int y, int n, const byte *ap, const char *cp
 		mymem[0][y][x + i].c = tcp[i];
 
 		wipeTermCell_ALT(x + i, y);
-		pictTermCell_Tile(x + i, y, a, c, ta, tc);
+		pictTermCell_Tile(x + i, y, a, c, ta, tc, FALSE);
 	}
 
 	/* Restore old mode */
@@ -3457,11 +3910,16 @@ static errr pictTermHook(int x, int y, int n, const byte *ap, const char *cp, co
 	Uint8 ta, tc;
 
 	TermData *td = (TermData*)(Term->data);
+	bool batch;
 	if (td->font_data == NULL || td->pict_data == NULL) return 1;
 
-	SDL_SetRenderTarget(td->renderer, td->framebuffer);
-	SDL_SetRenderDrawColor(td->renderer, 255, 255, 255, 255);
-	SDL_SetRenderDrawBlendMode(td->renderer, SDL_BLENDMODE_BLEND);
+	batch = batchingCells(td);
+	if (!batch)
+	{
+		SDL_SetRenderTarget(td->renderer, td->framebuffer);
+		SDL_SetRenderDrawColor(td->renderer, 255, 255, 255, 255);
+		SDL_SetRenderDrawBlendMode(td->renderer, SDL_BLENDMODE_BLEND);
+	}
 	//  SDL_SetTextureBlendMode(td->pict_texture, SDL_BLENDMODE_BLEND);
 
 	for (i = 0; i < n; i++)
@@ -3472,7 +3930,7 @@ static errr pictTermHook(int x, int y, int n, const byte *ap, const char *cp, co
 		tc = (tcp[i] & 0x7F);
 
 		wipeTermCell_UI(x + i, y, 0);
-		pictTermCell_Tile(x + i, y, a, c, ta, tc);
+		pictTermCell_Tile(x + i, y, a, c, ta, tc, batch);
 
 		if (!probably_cave) probably_cave = looksLikeCave(x + i, y);
 	}
@@ -5254,6 +5712,7 @@ static errr loadConfig()
 	sdl_combine_arrowkeys = (bool)conf_get_int("SDL2", "CombineArrows", 1);
 	sdl_combiner_delay = conf_get_int("SDL2", "CombineArrowsDelay", 50);
 	sdl_game_mouse = (bool)conf_get_int("SDL2", "GameMouse", 1);
+	sdl_batch_cells = (bool)conf_get_int("SDL2", "BatchCells", 0);
 
 	for (window_id = 0; window_id < TERM_MAX; window_id++)
 	{
@@ -5410,6 +5869,7 @@ static errr saveConfig()
 	conf_set_int("SDL2", "CombineArrows", sdl_combine_arrowkeys);
 	conf_set_int("SDL2", "CombineArrowsDelay", sdl_combiner_delay);
 	conf_set_int("SDL2", "GameMouse", sdl_game_mouse);
+	conf_set_int("SDL2", "BatchCells", sdl_batch_cells);
 
 	for (window_id = 0; window_id < TERM_MAX; window_id++)
 	{
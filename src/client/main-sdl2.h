@@ -37,6 +37,7 @@ static errr textTermHook(int x, int y, int n, byte attr, cptr s);
 static errr pictTermHook(int x, int y, int n, const byte *ap, const char *ch, const byte *tap, const char *tcp);
 static void initTermHook(term *t);
 static void nukeTermHook(term *t);
+static int waitHook(int fd, int timeout);
 /* declarations */
 struct FontData {
   cptr filename;       // The filename of this font
@@ -68,6 +69,15 @@ struct PictData {
 #define TERM_CHAR_SCALE 0     // Text rendering scales to fit the cell
 #define TERM_CHAR_STATIC 1    // Text rendering uses the static size
 #define TERM_CHAR_STRETCH 2   // Text rendering stretch to fit the cell
+// batched cell drawing needs SDL_RenderGeometry()
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+#define USE_SDL2_BATCH
+typedef struct CellBatch CellBatch;
+struct CellBatch {
+  SDL_Vertex *vertices;       // 4 vertices per queued quad
+  int num, max;               // number of quads queued / allocated
+};
+#endif
 struct TermData {
   SDL_Window *window;           // The term's actual window
   SDL_Renderer *renderer;       // The renderer for above window
@@ -120,6 +130,13 @@ struct TermData {
   PictData *pict_data;        // The term's pict data
   SDL_Texture *font_texture;  // The term's font texture, in memory
   SDL_Texture *pict_texture;  // The term's pict texture
+
+#ifdef USE_SDL2_BATCH
+  CellBatch wipes;            // Queued cell backgrounds
+  CellBatch tiles;            // Queued tiles, from pict_texture
+  CellBatch glyphs;           // Queued characters, from font_texture
+  Uint8 queued[256*256/8];    // Bitmap of cells queued since last flush
+#endif
 };
 /* functions */
 static errr initTermData(TermData *td, cptr name, int id, cptr font);
@@ -152,6 +169,15 @@ static errr sysText(TermData *td, int x, int y, int n, byte attr, cptr s);
 static void termStack(int i);
 static void termConstrain(int i);
 
+/* Batched drawing */
+static void flushTermCells(TermData *td);
+static void discardTermCells(TermData *td);
+#ifdef USE_SDL2_BATCH
+static void freeBatch(CellBatch *b);
+#endif
+static void benchmarkTerm(int frames);
+static void printFrameStats(cptr what, Uint32 frames, Uint64 ticks, Uint64 worst);
+
 /* ALT.DUNGEON */
 static void wipeTermCell_UI(int x, int y, int cutout);
 static errr textTermHook_ALT(int x, int y, int n, byte attr, cptr s);
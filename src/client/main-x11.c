@@ -142,6 +142,13 @@ byte angband_color_table[256][4] =
 #include "maid-x11.h"
 
 
+/*
+ * Include the networking code, for "Term_wait_x11()".
+ */
+#include "../common/net-basics.h"
+#include "../common/net-imps.h"
+
+
 /*
  * Hack -- avoid some compiler warnings
  */
@@ -1994,6 +2001,21 @@ static void handle_mouse_move(int i, int x, int y, int state) {
 }
 
 
+/*
+ * Prepare to sleep until an X event or the network (see "wait_aux")
+ */
+static int Term_wait_x11(int fd, int timeout)
+{
+	/* Xlib may have queued some events already (this also flushes) */
+	if (XPending(Metadpy->dpy)) return (0);
+
+	/* Let network_pause() watch the display connection, too */
+	network_watch(Metadpy->fd, NET_WANT_READ);
+
+	return (timeout);
+}
+
+
 /*
  * Process events
  */
@@ -3119,6 +3141,9 @@ errr init_x11(int argc, char **argv)
 	/* Activate hook */
 	quit_aux = hook_quit;
 
+	/* Wake up on X events, instead of polling for them */
+	wait_aux = Term_wait_x11;
+
 	/* Success */
 	return (0);
 }
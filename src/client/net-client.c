@@ -35,6 +35,9 @@ static int		(*handlers[256])(connection_type *ct);
 static cptr		(schemes[256]);
 
 byte last_pkt; /* last_pkt is used for debug purposes only */ 
+
+/* Called after every handled packet (optional) */
+void (*packet_aux)(byte pkt, int len) = NULL;
 byte next_pkt;
 cptr next_scheme;
 
@@ -71,15 +74,66 @@ void cleanup_network_client()
 	first_timer = NULL;
 }
 
+/*
+ * Frontend hook, which sleeps until a key is pressed, the server socket
+ * "fd" is readable, or "timeout" milliseconds pass. It returns how many
+ * milliseconds network_pause() should wait for the network afterwards:
+ * 0 if it has done the waiting itself, or a key is already pending.
+ */
+int (*wait_aux)(int fd, int timeout) = NULL;
+
+/*
+ * Sleep until the server, the user or a timer needs our attention.
+ *
+ * Frontends without a "wait_aux" hook can't tell us about keypresses,
+ * so we keep waking up every millisecond to let them check.
+ */
+static void network_wait()
+{
+	micro timeout = ONE_SECOND;
+	int fd = -1;
+	eptr iter;
+
+	/* Still connecting, or the frontend can't help */
+	if (first_caller || !wait_aux)
+	{
+		network_pause(1000); /* 0.001 ms "sleep" */
+		return;
+	}
+
+	for (iter = first_connection; iter; iter = iter->next)
+	{
+		connection_type *ct = (connection_type *)iter->data2;
+
+		/* Hurry, we have something to say */
+		if (cq_len(&ct->wbuf) && !ct->wblock) timeout = 0;
+
+		if (fd == -1) fd = ct->conn_fd;
+	}
+
+	/* Next timer */
+	if (first_timer) timeout = MIN(timeout, timers_delay(first_timer));
+
+	/* Next change of the air layer or slash effects */
+	if (air_updates && air_next) timeout = MIN(timeout, air_next * 1000);
+	if (refresh_char_aux && sfx_next) timeout = MIN(timeout, sfx_next * 1000);
+
+	/* Let the frontend sleep, see what's up */
+	if (timeout) timeout = (*wait_aux)(fd, (int)TV_MSEC(timeout + 999)) * 1000;
+
+	network_pause(timeout);
+}
+
 /* Iteration of the Loop */
 void network_loop()
 {
+	/* Sleep first, so the caller can redraw what we got before the next nap */
+	network_wait();
+
 	//first_listener = handle_listeners(first_listener);
 	first_connection = handle_connections(first_connection);
 	first_caller = handle_callers(first_caller);
 	first_timer = handle_timers(first_timer, static_timer(0));
-
-	network_pause(1000); /* 0.001 ms "sleep" */
 }
 
 int client_close(int data1, data data2) {
@@ -106,6 +160,9 @@ int client_read(int data1, data data2) { /* return -1 on error */
 
 		/* Unable to continue */
 		if (result != 1) break;
+
+		/* Notify */
+		if (packet_aux) (*packet_aux)(next_pkt, ct->rbuf.pos - start_pos);
 	}
 	
 	/* Enforce connection error if there's a *fatal* buffer error */
@@ -1234,6 +1291,9 @@ int recv_slash_fx(connection_type *ct)
 	sfx_info[y][x].c = fx;
 	sfx_delay[y][x] = SLASH_FX_THRESHOLD;
 
+	/* Wake "update_slashfx()" up */
+	wake_slashfx();
+
 	return 1;
 }
 
@@ -1263,6 +1323,9 @@ int recv_air(connection_type *ct)
 	air_delay[y][x] = delay * AIR_FADE_THRESHOLD;
 	air_fade[y][x]  = air_delay[y][x] + fade * AIR_FADE_THRESHOLD;
 
+	/* Wake "update_air()" up */
+	wake_air();
+
 	return 1;
 }
 
@@ -1312,9 +1375,11 @@ int read_stream_char(byte st, byte addr, bool trn, bool mem, s16b y, s16b x)
 	if (verify_stream_y(st, y)) return -1;
 	if (verify_stream_x(st, x)) return -1;
 
-	if (cq_scanf(&serv->rbuf, "%c%c", &a, &c) < 2) return 0;
-
-	if (trn && cq_scanf(&serv->rbuf, "%c%c", &ta, &tc) < 2) return 0;
+	if (trn)
+	{
+		if (cq_unpack_tile_trn(&serv->rbuf, &a, &c, &ta, &tc) < 4) return 0;
+	}
+	else if (cq_unpack_tile(&serv->rbuf, &a, &c) < 2) return 0;
 
 	dest[x].a = a;
 	dest[x].c = c;
@@ -1335,7 +1400,7 @@ int recv_stream(connection_type *ct) {
 
 	stream_type	*stream;
 
-	if (cq_scanf(&ct->rbuf, "%ud", &y) < 1) return 0;
+	if (cq_unpack_stream_line(&ct->rbuf, &y) < 1) return 0;
 
 	id = stream_ref[next_pkt];
 	stream = &streams[id];
@@ -1381,6 +1446,55 @@ int recv_stream(connection_type *ct) {
 	return 1;
 }
 
+/* Several consecutive grids of a stream row, each handled just like
+ * read_stream_char() would have */
+int recv_stream_span(connection_type *ct) {
+	byte	st_pkt = 0, y = 0, x = 0, len = 0;
+	byte	addr, id, trn, i;
+	bool	mem;
+	cave_view_type	*dest;
+	cave_view_type	buf[MAX_WID], tbuf[MAX_WID];
+
+	stream_type	*stream;
+
+	if (cq_unpack_stream_span(&ct->rbuf, &st_pkt, &y, &x, &len) < 4) return 0;
+
+	/* Paranoia -- must be a stream */
+	if (handlers[st_pkt] != recv_stream || !len) return -1;
+
+	id = stream_ref[st_pkt];
+	stream = &streams[id];
+	addr = stream->addr;
+	trn = (stream->flag & SF_TRANSPARENT);
+	mem = !(stream->flag & SF_OVERLAYED);
+
+	if (verify_stream_y(id, y)) return -1;
+	if (verify_stream_x(id, x)) return -1;
+	if (verify_stream_x(id, x + len - 1)) return -1;
+
+	/* Decode the secondary attr/char stream */
+	if (trn && cq_scanc(&ct->rbuf, stream->rle, tbuf, len) < len) return 0;
+
+	/* Decode the attr/char stream */
+	if (cq_scanc(&ct->rbuf, stream->rle, buf, len) < len) return 0;
+
+	dest = stream_cave(id, y);
+
+	for (i = 0; i < len; i++)
+	{
+		dest[x + i] = buf[i];
+
+		if (addr == NTERM_WIN_OVERHEAD)
+			show_char(y, x + i, buf[i].a, buf[i].c,
+				trn ? tbuf[i].a : 0, trn ? tbuf[i].c : 0, mem);
+	}
+
+	if (y > last_remote_line[addr])
+		last_remote_line[addr] = y;
+
+	return 1;
+}
+
 int recv_stream_size(connection_type *ct) {
 	byte
 		stg = 0,
@@ -1693,6 +1807,14 @@ int recv_cursor(connection_type *ct) {
 
 	if (cq_scanf(&ct->rbuf, "%c%c%c", &vis, &x, &y) < 3) return 0;
 
+	/* Remember player location (Hack -- it is sent as "y, x") */
+	if (vis == MCURSOR_PLAYER)
+	{
+		p_ptr->py = x;
+		p_ptr->px = y;
+		return 1;
+	}
+
 	/* Hack -- ignore weird states */
 	if ((byte)vis > 1)
 	{
@@ -1773,7 +1895,7 @@ int recv_message(connection_type *ct) {
 		mesg[MSG_LEN];
 	u16b
 		type = 0;
-	if (cq_scanf(&ct->rbuf, "%ud%S", &type, mesg) < 2) return 0;
+	if (cq_unpack_message(&ct->rbuf, &type, mesg) < 2) return 0;
 
 	do_handle_message(mesg, type);
 
@@ -62,6 +62,19 @@
  */
 #define MAX_TXT_INFO 300
 
+/*
+ * Rows added to a player's 'special info' buffer at a time
+ * (must cover the 24-line MotD, see "show_motd()")
+ */
+#define TEXT_INFO_CHUNK 32
+
+/*
+ * Size of the copy of a text sub-window kept by the server, so that
+ * only the lines which changed are resent (see "send_prepared_diff()")
+ */
+#define SENT_TEXT_HGT 24
+#define SENT_TEXT_WID 80
+
 /*
  * Number of grids used to display the dungeon (vertically).
  * Must be a multiple of 11, probably hard-coded to 22.
@@ -131,6 +144,15 @@
 
 #define MAX_FLVR_IDX	330 /* Max size for flv_x_char[]/attr[] */
 
+/*
+ * Per-player index sets (one bit per "m_list[]"/"o_list[]"/player index)
+ */
+#define IDX_SET_SIZE(N)	(((N) + 7) / 8)
+#define idx_has(S,I)	(((S)[(I) >> 3] >> ((I) & 7)) & 1)
+#define idx_on(S,I)	((S)[(I) >> 3] |= (byte)(1 << ((I) & 7)))
+#define idx_off(S,I)	((S)[(I) >> 3] &= (byte)~(1 << ((I) & 7)))
+#define idx_put(S,I,V)	((V) ? idx_on(S,I) : idx_off(S,I))
+
 /*
  * Number of tval/min-sval/max-sval slots per ego_item
  */
@@ -207,6 +229,11 @@
  */
 #define QUARK_MAX	5656
 
+/*
+ * OPTION: Size of the "quark" hash index (power of two, > 2 * QUARK_MAX)
+ */
+#define QUARK_HASH	16384
+
 /*
  * OPTION: Maximum number of messages to remember (see "io.c")
  * Default: assume maximal memorization of 2048 total messages
@@ -542,7 +569,7 @@
 /* xxx (many) */
 #define PU_VIEW 	0x00100000L	/* Update view */
 #define PU_LITE 	0x00200000L	/* Update lite */
-/* xxx */
+#define PU_VIEW_OCT	0x00400000L	/* Update some octants of view */
 #define PU_MONSTERS	0x01000000L	/* Update monsters */
 #define PU_DISTANCE	0x02000000L	/* Update distances */
 /* xxx */
@@ -871,6 +898,8 @@
 # define MACRO_MAX	128
 # undef QUARK_MAX
 # define QUARK_MAX	128
+# undef QUARK_HASH
+# define QUARK_HASH	512
 # undef MESSAGE_MAX
 # define MESSAGE_MAX	128
 # undef MESSAGE_BUF
@@ -880,9 +909,6 @@
 
 /** Pathfinder constants **/
 
-/* Maximum size around the player to consider in the pathfinder */
-#define MAX_PF_RADIUS 50
-
 /* Maximum distance to consider in the pathfinder */
 #define MAX_PF_LENGTH 250
 
@@ -56,22 +56,55 @@
 #include <sys/unistd.h>
 #include <sys/time.h>
 #include <sys/fcntl.h>
+#include <sys/uio.h>
 
 #define sockerr errno
 #define closesocket close
 #endif
 
+/*
+ * Readiness backend. Every socket we care about is "watched" for
+ * reading and/or writing via network_watch(), network_pause() sleeps
+ * until one of them is ready (or the timeout runs out), and the
+ * handle_*() functions then only service sockets network_ready()
+ * reports as ready.
+ *
+ * We use epoll on Linux, poll() where available, and fall back to
+ * select() (limited to FD_SETSIZE sockets) everywhere else.
+ */
+#if defined(HAVE_SYS_EPOLL_H) && defined(HAVE_EPOLL_CREATE1)
+#define USE_EPOLL
+#include <sys/epoll.h>
+#elif defined(HAVE_POLL_H) && defined(HAVE_POLL)
+#define USE_POLL
+#include <poll.h>
+#endif
+
+#if defined(USE_EPOLL) || defined(USE_POLL)
+static byte *fd_want = NULL;	/* Interest mask, by fd */
+static byte *fd_ready = NULL;	/* Readiness mask from last pause, by fd */
+static int fd_max = 0;	/* Size of above arrays */
+static int fd_watched = 0;	/* Number of watched fds */
+#endif
+#ifdef USE_EPOLL
+static int ep_fd = -1;
+static struct epoll_event *ep_events = NULL;
+static int ep_max = 0;
+static int *ep_last = NULL;	/* fds reported by last epoll_wait() */
+static int ep_last_num = 0;
+#endif
+#ifdef USE_POLL
+static struct pollfd *pfds = NULL;
+static int *pfd_idx = NULL;	/* Index into "pfds" + 1, by fd */
+static int pfd_num = 0;
+static int pfd_max = 0;
+#endif
 
 fd_set rd;
 fd_set wd;
+fd_set rd_watch;
+fd_set wd_watch;
 int nfds;
-int cnfds;
-int lnfds;
-int crfds;
-int refds;
-
-fd_set* get_fd_set() { return &rd; }
-int* get_fd_counter() { return &refds; }
 
 struct sender_type {
 	struct sockaddr_in addr;
@@ -159,7 +192,8 @@ eptr add_caller(eptr root, char *host, int port, callback conn_cb, callback fail
 	new_c->caller_fd = callerfd;
 	new_c->remove = 0; /* important */
 
-	crfds = MATH_MAX(crfds, callerfd);
+	/* Wake up when connection is established */
+	network_watch(callerfd, NET_WANT_WRITE);
 
 	/* Add to list */
 	return e_add(root, NULL, new_c);
@@ -212,6 +246,9 @@ eptr add_listener(eptr root, int port, callback cb) {
 	new_l->accept_cb = cb;
 	new_l->listen_fd = listenfd;
 
+	/* Wake up on incoming connections */
+	network_watch(listenfd, NET_WANT_READ);
+
 	/* Add to list */
 	return e_add(root, NULL, new_l);
 }
@@ -230,6 +267,11 @@ eptr add_connection(eptr root, int fd, callback read, callback close) {
 	new_c->close_cb = close;
 	new_c->close = 0;
 	new_c->uptr = NULL;
+	new_c->whdr_pos = new_c->whdr_len = 0;
+	new_c->wframe = 0;
+	new_c->wblock = 0;
+	new_c->wpeak = 0;
+	new_c->serial = 0;
 	cq_init(&new_c->wbuf, PD_LARGE_BUFFER);
 	cq_init(&new_c->rbuf, PD_LARGE_BUFFER);
 
@@ -242,7 +284,8 @@ eptr add_connection(eptr root, int fd, callback read, callback close) {
 #endif
 	}
 
-	cnfds = MAX(cnfds, new_c->conn_fd);
+	/* Wake up on incoming data */
+	network_watch(fd, NET_WANT_READ);
 
 	/* Add to list */
 	return e_add(root, NULL, new_c);
@@ -262,20 +305,130 @@ eptr add_timer(eptr root, int interval, callback timeout) {
 	return e_add(root, NULL, new_t);
 }
 
+/* Send two buffers with a single system call */
+static int send_pair(int fd, char *b1, int l1, char *b2, int l2)
+{
+#ifdef WINDOWS
+	WSABUF iov[2];
+	DWORD n = 0;
+	int i = 0;
+	if (l1) { iov[i].buf = b1; iov[i].len = l1; i++; }
+	if (l2) { iov[i].buf = b2; iov[i].len = l2; i++; }
+	if (WSASend(fd, iov, i, &n, 0, NULL, NULL) != 0) return -1;
+	return (int)n;
+#else
+	struct iovec iov[2];
+	int i = 0;
+	if (l1) { iov[i].iov_base = b1; iov[i].iov_len = l1; i++; }
+	if (l2) { iov[i].iov_base = b2; iov[i].iov_len = l2; i++; }
+	return writev(fd, iov, i);
+#endif
+}
+
+/*
+ * Push as much of "wbuf" to the kernel as it would take, straight from
+ * the queue. Only the bytes actually sent are consumed; if the kernel
+ * refuses the rest, "wblock" is set and handle_connections() will retry
+ * once the socket becomes writable.
+ *
+ * If the connection has a wrapper ("send_cb"), it is asked to fill
+ * "whdr" with a frame header for "wframe" bytes, and the header is
+ * sent together with the frame body. A frame is always finished
+ * before a new one is started, even if it takes several calls.
+ *
+ * Returns -1 on error, 0 if some data is still pending, 1 when done.
+ */
+int connection_flush(connection_type *ct)
+{
+	int n, hdr, body;
+
+	/* Track high-water mark */
+	if (cq_len(&ct->wbuf) > ct->wpeak) ct->wpeak = cq_len(&ct->wbuf);
+
+	/* Hack -- connection without a socket (replayed), drop the output */
+	if (ct->conn_fd < 0)
+	{
+		cq_clear(&ct->wbuf);
+		return 1;
+	}
+
+	for (;;)
+	{
+		/* Hack -- call connection wrapper (if any) to start a new frame */
+		if (ct->send_cb && !ct->wframe && ct->whdr_pos == ct->whdr_len)
+		{
+			ct->wframe = cq_len(&ct->wbuf);
+			if (!ct->wframe) return 1;
+			ct->whdr_pos = 0;
+			ct->whdr_len = ct->send_cb(0, ct);
+			if (ct->whdr_len < 0) return -1;
+		}
+
+		hdr = ct->whdr_len - ct->whdr_pos;
+		body = (ct->send_cb ? ct->wframe : cq_len(&ct->wbuf));
+		if (!hdr && !body) return 1;
+
+		if (hdr)
+			n = send_pair(ct->conn_fd, &ct->whdr[ct->whdr_pos], hdr, CQ_PEEK(&ct->wbuf), body);
+		else
+			n = send(ct->conn_fd, CQ_PEEK(&ct->wbuf), body, 0);
+
+		if (n < 0)
+		{
+			/* Kernel buffer is full, try again later */
+			if (sockerr == EWOULDBLOCK)
+			{
+				ct->wblock = 1;
+				return 0;
+			}
+			return -1;
+		}
+
+		/* Consume header part */
+		if (hdr)
+		{
+			int h = MIN(n, hdr);
+			ct->whdr_pos += h;
+			n -= h;
+		}
+
+		/* Consume body part */
+		ct->wbuf.pos += n;
+		if (ct->send_cb) ct->wframe -= n;
+
+		/* Short write */
+		if (n < body || ct->whdr_pos < ct->whdr_len)
+		{
+			/* Reclaim the space at the front */
+			cq_slide(&ct->wbuf);
+			ct->wblock = 1;
+			return 0;
+		}
+
+		/* Everything went through */
+		if (ct->wbuf.pos == ct->wbuf.len) CQ_CLEAR(&ct->wbuf);
+		ct->wblock = 0;
+
+		/* Wrapped connections might have more frames to send */
+		if (!ct->send_cb || !cq_len(&ct->wbuf)) break;
+	}
+	return (cq_len(&ct->wbuf) ? 0 : 1);
+}
+
 eptr handle_connections(eptr root) {
 	char mesg[PD_LARGE_BUFFER];
 	eptr iter;
-	int connfd, n, to_close = 0;
+	int connfd, n, ready, to_close = 0;
 	struct connection_type *ct;
 
 	for (iter=root; iter; iter=iter->next) {
 		ct = (connection_type*)iter->data2;
 		connfd = ct->conn_fd;
 
-		FD_SET(connfd, &rd);
+		ready = network_ready(connfd);
 
-		/* /Connection is not yet closed/ */
-		if (!ct->close)
+		/* /Connection is not yet closed/ and has something for us */
+		if (!ct->close && (ready & NET_WANT_READ))
 		{
 			/* Receive */
 			n = PD_LARGE_BUFFER;/* Paranoia */
@@ -283,13 +436,18 @@ eptr handle_connections(eptr root) {
 			n = recvfrom(connfd, mesg, n, 0, NULL, 0);
 			if (n > 0)
 			{
+				if (connection_input_hook) connection_input_hook(ct, mesg, n);
 				/* Got 'n' bytes */
 				n = cq_nwrite(&ct->rbuf, mesg, n);
 				/* Error while filling buffer */
 				if (n <= 0) ct->close = 1;
 			}
 			/* Error while receiving */
-			else if (n == 0 || sockerr != EWOULDBLOCK) ct->close = 1;
+			else if (n == 0 || sockerr != EWOULDBLOCK)
+			{
+				if (connection_input_hook) connection_input_hook(ct, NULL, 0);
+				ct->close = 1;
+			}
 		}
 		/* Handle input */
 		if (!ct->close && cq_len(&ct->rbuf))
@@ -298,27 +456,21 @@ eptr handle_connections(eptr root) {
 			/* Error while handling input */
 			if (n < 0) ct->close = 1;
 		}
-		/* Send */
-		if (cq_len(&ct->wbuf))
+		/* Send (unless the kernel buffer is still full) */
+		if (cq_len(&ct->wbuf) && (!ct->wblock || (ready & NET_WANT_WRITE)))
 		{
-			/* Hack -- call connection wrapper (if any) */
-			if (ct->send_cb)
-			{
-				/* It's job is to fill the "mesg" buffer, instead of
-				 * doing a simple "cq_read" below. */
-				void *old_ptr = ct->uptr;
-				ct->uptr = &mesg[0];
-				n = ct->send_cb(0, ct);
-				ct->uptr = old_ptr;
-			} else
-
-			n = cq_read(&ct->wbuf, &mesg[0], PD_LARGE_BUFFER);
-			n = sendto(connfd,mesg,n,0, NULL,0);
-
 			/* Error while sending */
-			if (n <= 0) ct->close = 1;
+			if (connection_flush(ct) < 0)
+			{
+				if (connection_input_hook) connection_input_hook(ct, NULL, -1);
+				ct->close = 1;
+			}
 		}
 
+		/* Ask to be woken up when we can write the rest */
+		if (!ct->close)
+			network_watch(connfd, NET_WANT_READ | (cq_len(&ct->wbuf) ? NET_WANT_WRITE : 0));
+
 		/* Done for? */
 		to_close += ct->close;
 	}
@@ -328,8 +480,8 @@ eptr handle_connections(eptr root) {
 				ct = (connection_type*)iter->data2;
 				if (ct->close)
 				{
+					network_watch(ct->conn_fd, 0);
 					closesocket(ct->conn_fd);
-					FD_CLR(ct->conn_fd, &rd);
 					ct->close_cb(0, ct);
 					cq_free(&ct->rbuf);
 					cq_free(&ct->wbuf);
@@ -340,16 +492,38 @@ eptr handle_connections(eptr root) {
 				}
 			}
 		}
-		cnfds = 0;
-		for (iter=root; iter; iter=iter->next) {
-			ct = (connection_type*)iter->data2;
-			cnfds = MATH_MAX(cnfds, ct->conn_fd);
-		}
 	}
-	/*nfds = MATH_MAX(lnfds, cnfds);*/
 	return root;
 }
 
+/*
+ * Push out whatever was queued since the last handle_connections(),
+ * so replies don't wait a whole pause for the next pass.  Connections
+ * still waiting for writability are left alone, and anything refused
+ * here is picked up once the socket can take it.
+ */
+void flush_connections(eptr root) {
+	eptr iter;
+	struct connection_type *ct;
+
+	for (iter=root; iter; iter=iter->next) {
+		ct = (connection_type*)iter->data2;
+
+		if (ct->close || ct->wblock || !cq_len(&ct->wbuf)) continue;
+
+		/* Error while sending, let handle_connections() close it */
+		if (connection_flush(ct) < 0)
+		{
+			if (connection_input_hook) connection_input_hook(ct, NULL, -1);
+			ct->close = 1;
+		}
+
+		/* Ask to be woken up to write the rest (or to close) */
+		if (ct->close || cq_len(&ct->wbuf))
+			network_watch(ct->conn_fd, NET_WANT_READ | NET_WANT_WRITE);
+	}
+}
+
 eptr handle_callers(eptr root) {
 	eptr iter;
 	int to_remove = 0;
@@ -360,11 +534,10 @@ eptr handle_callers(eptr root) {
 		int n = 0;
 		int err = 0;
 
-		/* if (FD_ISSET(callerfd, &wd)) {
+		/* if (network_ready(callerfd) & NET_WANT_WRITE) {
 			//this is a good place to check if socket is connected
 		} */
 
-		FD_SET(callerfd, &wd);
 		n = connect(callerfd, (struct sockaddr *)&ct->addr, sizeof(ct->addr));
 		err = sockerr;
 		#ifdef WINDOWS
@@ -387,6 +560,7 @@ eptr handle_callers(eptr root) {
 		else {
 			n = ct->failure_cb(callerfd, (data)ct);
 			if (n) continue;
+			network_watch(callerfd, 0);
 			closesocket(callerfd);
 		}
 
@@ -398,7 +572,8 @@ eptr handle_callers(eptr root) {
 				struct caller_type *ct = (struct caller_type *)iter->data2;
 				if (ct->remove)
 				{
-					FD_CLR(ct->caller_fd, &wd);
+					/* Note: on success, the socket lives on as a
+					 * connection and is watched by add_connection() */
 					FREE(ct);
 					e_del(&root, iter);
 					to_remove--;
@@ -406,11 +581,6 @@ eptr handle_callers(eptr root) {
 				}
 			}
 		}
-		crfds = 0;
-		for (iter=root; iter; iter=iter->next) {
-			struct caller_type *ct = (struct caller_type *)iter->data2;
-			crfds = MATH_MAX(crfds, ct->caller_fd);
-		}
 	}
 	
 	return root;
@@ -427,29 +597,29 @@ eptr handle_listeners(eptr root) {
 		struct listener_type *lt = (struct listener_type *)iter->data2;
 		int listenfd = lt->listen_fd;	
 
-		FD_SET (listenfd, &rd);
-		lnfds = MATH_MAX(listenfd, lnfds);
-
-		connfd = accept(listenfd,(struct sockaddr *)&cliaddr,&clilen);
-		if (connfd == -1) continue;
+		/* Nobody knocking */
+		if (!(network_ready(listenfd) & NET_WANT_READ)) continue;
 
-		unblockfd(connfd);
-
-		/* cnfds = MATH_MAX(connfd, cnfds); */
+		/* Accept everyone who's waiting */
+		while ((connfd = accept(listenfd,(struct sockaddr *)&cliaddr,&clilen)) != -1)
+		{
+			unblockfd(connfd);
 
-		err = lt->accept_cb(connfd, lt);
-		if (err) {
-			closesocket(connfd);
-			/* FD_CLR(connfd, &rd); */
+			err = lt->accept_cb(connfd, lt);
+			if (err) {
+				network_watch(connfd, 0);
+				closesocket(connfd);
+			}
 		}
-
 	}
 	return root;
 }
 
 /* Returns microseconds since last time this function was called */
+/* Each "id" is a separate stopwatch; the server uses id 6 from its
+ * savefile writer thread, so ids must not be shared across threads. */
 micro static_timer(int id) {
-	static micro times[5] = { 0, 0, 0, 0, 0 };
+	static micro times[7] = { 0, 0, 0, 0, 0, 0, 0 };
 
 	micro passed;
 #ifndef WINDOWS /* TODO: HAVE_GETTIMEOFDAY */
@@ -477,6 +647,33 @@ micro static_timer(int id) {
 	return passed;
 }
 
+/* Sees all incoming data (see "handle_connections()") */
+void (*connection_input_hook)(connection_type *ct, char *buf, int len) = NULL;
+
+/* Monotonic clock, in microseconds, for measuring short spans */
+micro clock_micro(void) {
+#ifndef WINDOWS
+	static time_t base = 0;
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	/* Hack -- count from the first call, so "micro" does not overflow */
+	if (!base) base = ts.tv_sec;
+	return (micro)(ts.tv_sec - base) * 1000000 + ts.tv_nsec / 1000;
+#else
+	static __int64 base = 0;
+	LARGE_INTEGER PerformanceCount, Frequency;
+	__int64 q, freq;
+	QueryPerformanceFrequency(&Frequency);
+	QueryPerformanceCounter(&PerformanceCount);
+	/* Hack -- count from the first call, as above */
+	if (!base) base = PerformanceCount.QuadPart;
+	q = PerformanceCount.QuadPart - base;
+	freq = Frequency.QuadPart;
+	/* Split, or "q * 1000000" overflows long before "q" does */
+	return (micro)((q / freq) * 1000000 + (q % freq) * 1000000 / freq);
+#endif
+}
+
 eptr handle_senders(eptr root, micro microsec) {
 	eptr iter;
 	int n, to_close = 0;
@@ -556,6 +753,28 @@ eptr handle_timers(eptr root, micro microsec) {
 	return root;
 }
 
+/* Returns microseconds until the first timer in "root" is due */
+micro timers_delay(eptr root) {
+	eptr iter;
+	micro delay = -1;
+	for (iter=root; iter; iter=iter->next) {
+		struct timer_type *timer = (struct timer_type *)iter->data2;
+		if (delay < 0 || timer->delay < delay) delay = timer->delay;
+	}
+	return MAX(delay, 0);
+}
+
+/* Returns microseconds until the first sender in "root" is due */
+micro senders_delay(eptr root) {
+	eptr iter;
+	micro delay = -1;
+	for (iter=root; iter; iter=iter->next) {
+		struct sender_type *sender = (struct sender_type *)iter->data2;
+		if (delay < 0 || sender->delay < delay) delay = sender->delay;
+	}
+	return MAX(delay, 0);
+}
+
 void network_reset() {
 #ifdef WINDOWS
 	WSADATA wsadata;
@@ -564,9 +783,131 @@ void network_reset() {
 	WSAStartup(MAKEWORD(1, 1), &wsadata);
 #endif
 
+#ifdef USE_EPOLL
+	if (ep_fd == -1) ep_fd = epoll_create1(0);
+	if (ep_fd == -1) plog("epoll_create1() failed, network will busy-loop!");
+#endif
+
 	FD_ZERO (&rd);
 	FD_ZERO (&wd);
-	nfds = cnfds = lnfds = crfds = refds = 0;
+	FD_ZERO (&rd_watch);
+	FD_ZERO (&wd_watch);
+	nfds = 0;
+}
+
+#if defined(USE_EPOLL) || defined(USE_POLL)
+/* Make sure the per-fd arrays can hold "fd" */
+static void grow_fd_arrays(int fd) {
+	int new_max = MAX(fd_max, 64);
+	byte *new_want, *new_ready;
+#ifdef USE_POLL
+	int *new_idx;
+#endif
+	if (fd < fd_max) return;
+	while (new_max <= fd) new_max *= 2;
+
+	C_MAKE(new_want, new_max, byte);
+	C_MAKE(new_ready, new_max, byte);
+	if (fd_max) {
+		C_COPY(new_want, fd_want, fd_max, byte);
+		C_COPY(new_ready, fd_ready, fd_max, byte);
+		FREE(fd_want);
+		FREE(fd_ready);
+	}
+	fd_want = new_want;
+	fd_ready = new_ready;
+#ifdef USE_POLL
+	C_MAKE(new_idx, new_max, int);
+	if (fd_max) {
+		C_COPY(new_idx, pfd_idx, fd_max, int);
+		FREE(pfd_idx);
+	}
+	pfd_idx = new_idx;
+#endif
+	fd_max = new_max;
+}
+#endif
+
+/* Start, change or stop (want = 0) watching a socket */
+void network_watch(int fd, int want) {
+#if defined(USE_EPOLL) || defined(USE_POLL)
+	int old;
+	if (fd < 0) return;
+	grow_fd_arrays(fd);
+	old = fd_want[fd];
+	if (old == want) return;
+#ifdef USE_EPOLL
+	if (ep_fd != -1) {
+		struct epoll_event ev;
+		WIPE(&ev, struct epoll_event);
+		ev.data.fd = fd;
+		if (want & NET_WANT_READ) ev.events |= EPOLLIN;
+		if (want & NET_WANT_WRITE) ev.events |= EPOLLOUT;
+		epoll_ctl(ep_fd, !old ? EPOLL_CTL_ADD : (!want ? EPOLL_CTL_DEL : EPOLL_CTL_MOD), fd, &ev);
+	}
+#else
+	if (!old) {
+		/* Append */
+		if (pfd_num >= pfd_max) {
+			struct pollfd *new_pfds;
+			int new_max = MAX(pfd_max * 2, 64);
+			C_MAKE(new_pfds, new_max, struct pollfd);
+			if (pfd_max) {
+				C_COPY(new_pfds, pfds, pfd_num, struct pollfd);
+				FREE(pfds);
+			}
+			pfds = new_pfds;
+			pfd_max = new_max;
+		}
+		pfds[pfd_num].fd = fd;
+		pfds[pfd_num].revents = 0;
+		pfd_idx[fd] = ++pfd_num;
+	}
+	if (!want) {
+		/* Remove, by moving last one into the hole */
+		int i = pfd_idx[fd] - 1;
+		pfds[i] = pfds[--pfd_num];
+		pfd_idx[pfds[i].fd] = i + 1;
+		pfd_idx[fd] = 0;
+	} else {
+		int i = pfd_idx[fd] - 1;
+		pfds[i].events = 0;
+		if (want & NET_WANT_READ) pfds[i].events |= POLLIN;
+		if (want & NET_WANT_WRITE) pfds[i].events |= POLLOUT;
+	}
+#endif
+	if (!old) fd_watched++;
+	if (!want) fd_watched--;
+	fd_want[fd] = want;
+	if (!want) fd_ready[fd] = 0;
+#else
+	if (fd < 0) return;
+	if (want & NET_WANT_READ) FD_SET(fd, &rd_watch); else FD_CLR(fd, &rd_watch);
+	if (want & NET_WANT_WRITE) FD_SET(fd, &wd_watch); else FD_CLR(fd, &wd_watch);
+	if (!want) { FD_CLR(fd, &rd); FD_CLR(fd, &wd); }
+	if (want) nfds = MATH_MAX(nfds, fd);
+#endif
+}
+
+/* Returns readiness of a watched socket, as of last network_pause() */
+int network_ready(int fd) {
+#if defined(USE_EPOLL) || defined(USE_POLL)
+	if (fd < 0 || fd >= fd_max) return 0;
+#ifdef USE_EPOLL
+	/* Hack -- no epoll, pretend everything is ready */
+	if (ep_fd == -1) return fd_want[fd];
+#endif
+	return fd_ready[fd];
+#else
+#ifdef HAVE_SELECT
+	if (fd < 0) return 0;
+	return (FD_ISSET(fd, &rd) ? NET_WANT_READ : 0)
+	     | (FD_ISSET(fd, &wd) ? NET_WANT_WRITE : 0);
+#else
+	/* No way to tell, pretend everything is ready */
+	return (NET_WANT_READ | NET_WANT_WRITE);
+#endif
+#endif
 }
 
 void network_done() {
@@ -575,19 +916,109 @@ void network_done() {
 #endif
 }
 
+/* Sleep until any watched socket is ready, or "timeout" microseconds pass */
 void network_pause(micro timeout) {
+#ifdef USE_EPOLL
+	int i, n;
+
+	/* Hack -- no epoll */
+	if (ep_fd == -1) {
+		usleep(timeout);
+		return;
+	}
+
+	/* Forget previous readiness */
+	for (i = 0; i < ep_last_num; i++) fd_ready[ep_last[i]] = 0;
+	ep_last_num = 0;
+
+	/* Make sure we can report every watched socket */
+	if (ep_max < fd_watched) {
+		if (ep_max) {
+			FREE(ep_events);
+			FREE(ep_last);
+		}
+		ep_max = MAX(fd_watched, 64);
+		C_MAKE(ep_events, ep_max, struct epoll_event);
+		C_MAKE(ep_last, ep_max, int);
+	}
+
+	/* Round up, so we never wake up before the deadline */
+	n = epoll_wait(ep_fd, ep_events, ep_max, (int)((timeout + 999) / 1000));
+
+	for (i = 0; i < n; i++) {
+		int fd = ep_events[i].data.fd;
+		u32b ev = ep_events[i].events;
+		if (fd < 0 || fd >= fd_max) continue;
+		/* Errors and hangups are reported as "readable", so the
+		 * following recv() notices them */
+		if (ev & (EPOLLIN | EPOLLERR | EPOLLHUP)) fd_ready[fd] |= NET_WANT_READ;
+		if (ev & (EPOLLOUT | EPOLLERR)) fd_ready[fd] |= NET_WANT_WRITE;
+		ep_last[ep_last_num++] = fd;
+	}
+#else
+#ifdef USE_POLL
+	int i, n;
+
+	n = poll(pfds, pfd_num, (int)((timeout + 999) / 1000));
+
+	for (i = 0; i < pfd_num; i++) {
+		short ev = (n > 0 ? pfds[i].revents : 0);
+		int ready = 0;
+		if (ev & (POLLIN | POLLERR | POLLHUP | POLLNVAL)) ready |= NET_WANT_READ;
+		if (ev & (POLLOUT | POLLERR)) ready |= NET_WANT_WRITE;
+		fd_ready[pfds[i].fd] = ready;
+	}
+#else
 #ifndef HAVE_SELECT
 	usleep(timeout);
 #else
 	struct timeval tv = { 0, 0 };
 
-	TV_SET(tv, timeout); /* 200000 = 0.2 seconds */
+	tv.tv_sec = TV_SEC(timeout);
+	tv.tv_usec = timeout % 1000000; /* 200000 = 0.2 seconds */
+
+	rd = rd_watch;
+	wd = wd_watch;
+
+	if (select(nfds + 1, &rd, &wd, NULL, &tv) < 0) {
+		FD_ZERO (&rd);
+		FD_ZERO (&wd);
+	}
+#endif
+#endif
+#endif
+}
+
+/*
+ * Sleep until "fd" is readable, or "timeout" microseconds pass.
+ * Unlike network_pause(), this leaves the watched sockets alone, so
+ * a helper thread may use it while the main thread is busy.
+ */
+int network_readable(int fd, micro timeout) {
+#ifdef USE_POLL
+	struct pollfd pfd;
+	pfd.fd = fd;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+	return (poll(&pfd, 1, (int)((timeout + 999) / 1000)) > 0);
+#else
+#ifdef HAVE_SELECT
+	fd_set rfd;
+	struct timeval tv = { 0, 0 };
+
+	if (fd < 0) return 0;
+
+	tv.tv_sec = TV_SEC(timeout);
+	tv.tv_usec = timeout % 1000000;
 
-	nfds = MATH_MAX(lnfds, cnfds);
-	nfds = MATH_MAX(nfds, crfds);
-	nfds = MATH_MAX(nfds, refds);
+	FD_ZERO (&rfd);
+	FD_SET (fd, &rfd);
 
-	select(nfds + 1, &rd, &wd, NULL, &tv);
+	return (select(fd + 1, &rfd, NULL, NULL, &tv) > 0);
+#else
+	usleep(timeout);
+	return 1;
+#endif
 #endif
 }
 
@@ -27,6 +27,13 @@ struct connection_type {
 	int user; /* User-defined data, unused by us */
 	data uptr;
 	cq wsrbuf; /* Unused, additional read buffer for connection wrapping */
+	char whdr[16]; /* Frame header, filled by "send_cb" (if any) */
+	int whdr_pos; /* Bytes of frame header already sent */
+	int whdr_len; /* Total bytes in frame header */
+	int wframe; /* Bytes of frame body not yet sent */
+	int wblock; /* Kernel refused our data, wait for writability */
+	int wpeak; /* High-water mark of "wbuf" */
+	int serial; /* User-defined number, for "connection_input_hook" */
 };
 struct timer_type {
 	micro interval;
@@ -43,12 +50,34 @@ extern eptr add_connection(eptr root, int fd, callback read, callback close);
 extern eptr handle_senders(eptr root, micro microsec);
 extern eptr handle_listeners(eptr root);
 extern eptr handle_connections(eptr root);
+extern  int connection_flush(connection_type *ct);
+extern void flush_connections(eptr root);
 extern eptr handle_callers(eptr root);
 extern eptr handle_timers(eptr root, long microsec);
 extern micro static_timer(int id);
+extern micro clock_micro(void);
+
+/* Sees all incoming data; "len" is 0 when the peer hangs up and -1 when a send fails */
+extern void (*connection_input_hook)(connection_type *ct, char *buf, int len);
+
+extern micro timers_delay(eptr root);
+extern micro senders_delay(eptr root);
+
+/* Readiness interest/report flags, see "network_watch()" */
+#define NET_WANT_READ 	0x01
+#define NET_WANT_WRITE	0x02
+
+/* Fill level of "wbuf" past which we should try flushing early */
+#define CONN_HIGH_WATER(CT) ((CT)->wbuf.max / 4 * 3)
+
+/* Connection is genuinely congested (peer isn't reading) */
+#define CONN_CONGESTED(CT) ((CT)->wblock && cq_len(&(CT)->wbuf) >= CONN_HIGH_WATER(CT))
 
 extern void network_reset(void);
-extern void network_pause(long timeout);
+extern void network_pause(micro timeout);
+extern void network_watch(int fd, int want);
+extern  int network_ready(int fd);
+extern  int network_readable(int fd, micro timeout);
 extern void denaglefd(int fd);
 extern  int islocalfd(int fd);
 extern  int fillhostname(char *str, int len);
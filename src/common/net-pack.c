@@ -14,47 +14,14 @@
  */
 #include "angband.h"
 
-#define PACK_PTR_8(PT, VAL) \
- * PT ++ = VAL
-#define PACK_PTR_16(PT, VAL) \
- * PT ++ = (char)(VAL >> 8), \
- * PT ++ = (char)VAL
-#define PACK_PTR_32(PT, VAL) \
- * PT ++ = (char)(VAL >> 24),\
- * PT ++ = (char)(VAL >> 16),\
- * PT ++ = (char)(VAL >> 8), \
- * PT ++ = (char)VAL
-#define PACK_PTR_64(PT, VAL) \
- * PT ++ = (char)(VAL >> 56),\
- * PT ++ = (char)(VAL >> 48),\
- * PT ++ = (char)(VAL >> 40),\
- * PT ++ = (char)(VAL >> 32),\
- * PT ++ = (char)(VAL >> 24),\
- * PT ++ = (char)(VAL >> 16),\
- * PT ++ = (char)(VAL >> 8), \
- * PT ++ = (char)VAL
-#define PACK_PTR_STR(PT, VAL) while ((* PT ++ = * VAL ++) != '\0')
-#define PACK_PTR_NSTR(PT, VAL, SIZE) while (SIZE--) { * PT ++ = * VAL ++ ; }
-
-#define UNPACK_PTR_8(PT, VAL) \
- * PT = * VAL ++
-#define UNPACK_PTR_16(PT, VAL)   \
- * PT  = (* VAL ++ & 0xFF) << 8, \
- * PT |= (* VAL ++ & 0xFF)
-#define UNPACK_PTR_32(PT, VAL)   \
- * PT  = (* VAL ++ & 0xFF) << 24,\
- * PT |= (* VAL ++ & 0xFF) << 16,\
- * PT |= (* VAL ++ & 0xFF) << 8, \
- * PT |= (* VAL ++ & 0xFF)
-#define UNPACK_PTR_64(PT, VAL)     \
- * PT  = (u64b)(* VAL ++ & 0xFFUL) << 56,\
- * PT |= (u64b)(* VAL ++ & 0xFFUL) << 48,\
- * PT |= (u64b)(* VAL ++ & 0xFFUL) << 40,\
- * PT |= (u64b)(* VAL ++ & 0xFFUL) << 32,\
- * PT |= (u64b)(* VAL ++ & 0xFFUL) << 24,\
- * PT |= (u64b)(* VAL ++ & 0xFFUL) << 16,\
- * PT |= (u64b)(* VAL ++ & 0xFFUL) << 8, \
- * PT |= (u64b)(* VAL ++ & 0xFFUL)
+/* Vectorized run detection for the cave encoders (see "cv_run()") */
+#if defined(__AVX2__)
+# include <immintrin.h>
+# define CV_RUN_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define CV_RUN_SSE2
+#endif
 
 #define SOFTER_ERRORS //undefine this for better debug
 
@@ -575,6 +542,109 @@ int cq_copyf(cq *src, const char *str, cq *dst) {
 #define PW_ERROR_SIZE(SIZE) if (WPTRN + SIZE > WENDN) { dst->err = 2; return 0; }
 #define PR_ERROR_SIZE(SIZE) if (RPTRN + SIZE > RENDN) { src->err = 2; return 0; }
 
+/*
+ * Encoders below never output more than 2 bytes per grid, so if there
+ * is that much room, we can skip checking for it on every run.
+ */
+#define PW_ROOMY(LEN) (WENDN - WPTRN >= (LEN) * 2)
+#define PW_ERROR_SIZE_UNLESS(ROOMY, SIZE) if (!(ROOMY)) { PW_ERROR_SIZE(SIZE) }
+
+/*
+ * Count how many grids, starting at "src[0]", look the same as
+ * "src[0]", looking at most "len" grids ahead. With "attr_only",
+ * only attributes are compared (for RLE_COLOR).
+ *
+ * This is the plain version, "cv_run()" below must always agree
+ * with it.
+ */
+int cv_run_scalar(cave_view_type *src, int len, bool attr_only)
+{
+	int n;
+	for (n = 1; n < len; n++)
+	{
+		if (src[n].a != src[0].a) break;
+		if (!attr_only && src[n].c != src[0].c) break;
+	}
+	return n;
+}
+
+/*
+ * Same as above, but compares several grids at once, treating each
+ * attr/char pair as a single 16-bit word: 16 at a time with AVX2,
+ * 8 with SSE2, or 2 at a time (32-bit words) everywhere else.
+ */
+int cv_run(cave_view_type *src, int len, bool attr_only)
+{
+	cave_view_type mask_cv;
+	u16b first, mask;
+	int n = 1;
+
+	/* Paranoia -- unusual padding */
+	if (sizeof(cave_view_type) != sizeof(u16b))
+		return cv_run_scalar(src, len, attr_only);
+
+	/* Build the pattern (endian-neutral) */
+	mask_cv.a = 0xFF;
+	mask_cv.c = (attr_only ? 0 : (char)0xFF);
+	memcpy(&mask, &mask_cv, sizeof(u16b));
+	memcpy(&first, &src[0], sizeof(u16b));
+	first &= mask;
+
+#if defined(CV_RUN_AVX2)
+	{
+		__m256i pat = _mm256_set1_epi16((short)first);
+		__m256i msk = _mm256_set1_epi16((short)mask);
+		for (; n + 16 <= len; n += 16)
+		{
+			__m256i v = _mm256_loadu_si256((const __m256i*)&src[n]);
+			u32b bits = (u32b)_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_and_si256(v, msk), pat));
+			if (bits != 0xFFFFFFFFUL)
+			{
+				/* Two mask bits per grid */
+				while (bits & 3) { bits >>= 2; n++; }
+				return n;
+			}
+		}
+	}
+#endif
+#if defined(CV_RUN_AVX2) || defined(CV_RUN_SSE2)
+	{
+		__m128i pat = _mm_set1_epi16((short)first);
+		__m128i msk = _mm_set1_epi16((short)mask);
+		for (; n + 8 <= len; n += 8)
+		{
+			__m128i v = _mm_loadu_si128((const __m128i*)&src[n]);
+			int bits = _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, msk), pat));
+			if (bits != 0xFFFF)
+			{
+				/* Two mask bits per grid */
+				while (bits & 3) { bits >>= 2; n++; }
+				return n;
+			}
+		}
+	}
+#else
+	{
+		u32b pat = ((u32b)first << 16) | first;
+		u32b msk = ((u32b)mask << 16) | mask;
+		u32b w;
+		for (; n + 2 <= len; n += 2)
+		{
+			memcpy(&w, &src[n], sizeof(u32b));
+			if ((w & msk) != pat) break;
+		}
+	}
+#endif
+
+	/* Leftovers (and the grid that broke the word loop) */
+	for (; n < len; n++)
+	{
+		if (src[n].a != src[0].a) break;
+		if (!attr_only && src[n].c != src[0].c) break;
+	}
+	return n;
+}
+
 int cv_encode_none(cave_view_type* src, cq* dst, int len) {
 	int i, bytes = 0;
 	PACK_DEF
@@ -622,8 +692,10 @@ int cv_decode_none(cave_view_type* dst, cq* src, int len) {
 
 int cv_encode_rle1(cave_view_type* src, cq* dst, int len) {
 	int i, bytes = 0;
+	bool roomy;
 	PACK_DEF
 	PACK_INIT(dst);
+	roomy = PW_ROOMY(len);
 	/* Each column */
 	for (i = 0; i < len; i++)
 	{
@@ -642,23 +714,15 @@ int cv_encode_rle1(cave_view_type* src, cq* dst, int len) {
 			return 0;
 		}
 
-		/* Start with count of 1 */
-		n = 1;
-
-		/* Start looking here */
-		for (x = i + 1; x < len; x++)
-		{
-			/* Count repetitions of this grid */
-			if (src[x].c != c || src[x].a != a) break;
-			/* Increment count */
-			n++;
-		}
+		/* Count repetitions of this grid */
+		n = cv_run(&src[i], len - i, FALSE);
+		x = i + n;
 
 		/* If there are at least 2 similar grids in a row */
 		if (n >= 2)
 		{
 			/* Output the info */
-			PW_ERROR_SIZE(3)
+			PW_ERROR_SIZE_UNLESS(roomy, 3)
 			PACK_PTR_8(wptr, c);
 			PACK_PTR_8(wptr, (a | 0x40)); /* Set bit 0x40 of a */
 			PACK_PTR_8(wptr, (byte)n);
@@ -669,7 +733,7 @@ int cv_encode_rle1(cave_view_type* src, cq* dst, int len) {
 		else
 		{
 			/* Normal, single grid */
-			PW_ERROR_SIZE(2)
+			PW_ERROR_SIZE_UNLESS(roomy, 2)
 			PACK_PTR_8(wptr, c);
 			PACK_PTR_8(wptr, a);
 		}
@@ -734,8 +798,10 @@ int cv_decode_rle1(cave_view_type* dst, cq* src, int len) {
 
 int cv_encode_rle2(cave_view_type* src, cq* dst, int len) {
 	int i, bytes = 0;
+	bool roomy;
 	PACK_DEF
 	PACK_INIT(dst);
+	roomy = PW_ROOMY(len);
 	/* Each column */
 	for (i = 0; i < len; i++)
 	{
@@ -753,23 +819,15 @@ int cv_encode_rle2(cave_view_type* src, cq* dst, int len) {
 			dst->err = 8;
 			return 0;
 		}
-		/* Start with count of 1 */
-		n = 1;
-
-		/* Start looking here */
-		for (x = i + 1; x < len; x++)
-		{
-			/* Count repetitions of this grid */
-			if (src[x].c != c || src[x].a != a) break;
-			/* Increment count */
-			n++;
-		}
+		/* Count repetitions of this grid */
+		n = cv_run(&src[i], len - i, FALSE);
+		x = i + n;
 
 		/* If there are at least 2 similar grids in a row */
 		if (n >= 2)
 		{
 			/* Output the info */
-			PW_ERROR_SIZE(4)
+			PW_ERROR_SIZE_UNLESS(roomy, 4)
 			PACK_PTR_8(wptr, (byte)n); /* Number of repetitons */
 			PACK_PTR_8(wptr, 0xFF); /* 0xFF marks the spot! */
 			PACK_PTR_8(wptr, c);
@@ -781,7 +839,7 @@ int cv_encode_rle2(cave_view_type* src, cq* dst, int len) {
 		else
 		{
 			/* Normal, single grid */
-			PW_ERROR_SIZE(2)
+			PW_ERROR_SIZE_UNLESS(roomy, 2)
 			PACK_PTR_8(wptr, c);
 			PACK_PTR_8(wptr, a);
 		}
@@ -846,12 +904,14 @@ int cv_decode_rle2(cave_view_type* dst, cq* src, int len) {
 
 int cv_encode_rle3(cave_view_type* src, cq* dst, int len) {
 	int i, bytes = 0;
+	bool roomy;
 	PACK_DEF
 	PACK_INIT(dst);
+	roomy = PW_ROOMY(len);
 	/* Each column */
 	for (i = 0; i < len; i++)
 	{
-		int x, n;
+		int n;
 		byte a;
 
 		/* Obtain the attr */
@@ -864,23 +924,14 @@ int cv_encode_rle3(cave_view_type* src, cq* dst, int len) {
 			return 0;
 		}
 
-		/* Start with count of 1 */
-		n = 1;
-
-		/* Start looking here */
-		for (x = i + 1; x < len; x++)
-		{
-			/* Count repetitions of this color */
-			if (src[x].a != a) break;
-			/* Increment count */
-			n++;
-		}
+		/* Count repetitions of this color */
+		n = cv_run(&src[i], len - i, TRUE);
 
 		/* If there are at least 3 similar grids in a row */
 		if (n >= 3)
 		{
 			/* Output the info */
-			PW_ERROR_SIZE(2 + n)
+			PW_ERROR_SIZE_UNLESS(roomy, 2 + n)
 			PACK_PTR_8(wptr, (a | 0x40)); /* Set bit 0x40 of a */
 			PACK_PTR_8(wptr, (byte)n);
 			/* Output the chars */
@@ -891,7 +942,7 @@ int cv_encode_rle3(cave_view_type* src, cq* dst, int len) {
 		else
 		{
 			/* Normal, single grid */
-			PW_ERROR_SIZE(2)
+			PW_ERROR_SIZE_UNLESS(roomy, 2)
 			PACK_PTR_8(wptr, a);
 			PACK_PTR_8(wptr, (src[i]).c);
 		}
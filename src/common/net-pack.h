@@ -6,9 +6,203 @@ extern int cq_copyf(cq *src, const char *str, cq *dst);
 extern int cq_scanf(cq *charq, char *str, ...);
 extern int cq_printc(cq *charq, unsigned int mode, cave_view_type *from, int len);
 extern int cq_scanc(cq *charq, unsigned int mode, cave_view_type *to, int len);
+extern int cv_run(cave_view_type *src, int len, bool attr_only);
+extern int cv_run_scalar(cave_view_type *src, int len, bool attr_only);
 extern int cq_printac(cq *charq, unsigned int mode, byte *a, char *c, int len);
 extern int cq_scanac(cq *charq, unsigned int mode, byte *a, char *c, int len);
 extern const char* cq_error(cq *charq);
 extern bool cq_fatal(cq *charq);
 
+#define PACK_PTR_8(PT, VAL) \
+ * PT ++ = VAL
+#define PACK_PTR_16(PT, VAL) \
+ * PT ++ = (char)(VAL >> 8), \
+ * PT ++ = (char)VAL
+#define PACK_PTR_32(PT, VAL) \
+ * PT ++ = (char)(VAL >> 24),\
+ * PT ++ = (char)(VAL >> 16),\
+ * PT ++ = (char)(VAL >> 8), \
+ * PT ++ = (char)VAL
+#define PACK_PTR_64(PT, VAL) \
+ * PT ++ = (char)(VAL >> 56),\
+ * PT ++ = (char)(VAL >> 48),\
+ * PT ++ = (char)(VAL >> 40),\
+ * PT ++ = (char)(VAL >> 32),\
+ * PT ++ = (char)(VAL >> 24),\
+ * PT ++ = (char)(VAL >> 16),\
+ * PT ++ = (char)(VAL >> 8), \
+ * PT ++ = (char)VAL
+#define PACK_PTR_STR(PT, VAL) while ((* PT ++ = * VAL ++) != '\0')
+#define PACK_PTR_NSTR(PT, VAL, SIZE) while (SIZE--) { * PT ++ = * VAL ++ ; }
+
+#define UNPACK_PTR_8(PT, VAL) \
+ * PT = * VAL ++
+#define UNPACK_PTR_16(PT, VAL)   \
+ * PT  = (* VAL ++ & 0xFF) << 8, \
+ * PT |= (* VAL ++ & 0xFF)
+#define UNPACK_PTR_32(PT, VAL)   \
+ * PT  = (* VAL ++ & 0xFF) << 24,\
+ * PT |= (* VAL ++ & 0xFF) << 16,\
+ * PT |= (* VAL ++ & 0xFF) << 8, \
+ * PT |= (* VAL ++ & 0xFF)
+#define UNPACK_PTR_64(PT, VAL)     \
+ * PT  = (u64b)(* VAL ++ & 0xFFUL) << 56,\
+ * PT |= (u64b)(* VAL ++ & 0xFFUL) << 48,\
+ * PT |= (u64b)(* VAL ++ & 0xFFUL) << 40,\
+ * PT |= (u64b)(* VAL ++ & 0xFFUL) << 32,\
+ * PT |= (u64b)(* VAL ++ & 0xFFUL) << 24,\
+ * PT |= (u64b)(* VAL ++ & 0xFFUL) << 16,\
+ * PT |= (u64b)(* VAL ++ & 0xFFUL) << 8, \
+ * PT |= (u64b)(* VAL ++ & 0xFFUL)
+
+/*
+ * Packet schemas.
+ *
+ * Hot packets with a fixed layout are described below, one F() entry
+ * per field, using the same letters cq_printf()/cq_scanf() use.
+ * For each of them, PSCHEME() generates
+ *
+ *	int cq_pack_NAME(cq *charq, byte pkt, <fields>);
+ *	int cq_unpack_NAME(cq *charq, <pointers to fields>);
+ *
+ * which check for buffer space once per packet and then store/load
+ * every field at a fixed offset. What ends up on the wire is exactly
+ * what cq_printf("%c<fields>", pkt, ...) would produce, so the other
+ * side does not care which one was used. Note that "unpack" reads the
+ * packet body only, as the type byte is consumed before handlers run.
+ *
+ * Return values follow cq_printf() (bytes written) and cq_scanf()
+ * (fields read), with 0 and "err" set on failure.
+ *
+ * Everything else (including all the DEPRECATED packets) still goes
+ * through cq_printf()/cq_scanf() and the "schemes" tables.
+ */
+#define PS_stream_line(F)	F(ud, y)
+#define PS_stream_char(F)	F(ud, y_x) F(b, a) F(c, c)
+#define PS_stream_char_trn(F)	F(ud, y_x) F(b, a) F(c, c) F(b, ta) F(c, tc)
+#define PS_tile(F)      	F(b, a) F(c, c)
+#define PS_tile_trn(F)  	F(b, a) F(c, c) F(b, ta) F(c, tc)
+#define PS_stream_span(F)	F(b, st) F(b, y) F(b, x) F(b, len)
+#define PS_message(F)   	F(ud, typ) F(S, msg)
+
+/* Field types */
+#define PS_TYPE_b	byte
+#define PS_TYPE_c	char
+#define PS_TYPE_d	s16b
+#define PS_TYPE_ud	u16b
+#define PS_TYPE_l	s32b
+#define PS_TYPE_ul	u32b
+#define PS_TYPE_S	cptr
+
+/* Function arguments */
+#define PS_PARAM(T, N)	, PS_TYPE_##T N
+#define PS_PTR(T, N)	, PS_PTR_##T(N)
+#define PS_PTR_b(N) 	byte *N
+#define PS_PTR_c(N) 	char *N
+#define PS_PTR_d(N) 	s16b *N
+#define PS_PTR_ud(N)	u16b *N
+#define PS_PTR_l(N) 	s32b *N
+#define PS_PTR_ul(N)	u32b *N
+#define PS_PTR_S(N) 	char *N
+#define PS_COUNT(T, N)	+ 1
+
+/* Packing */
+#define PS_DECL(T, N)	PS_DECL_##T(N)
+#define PS_DECL_b(N)
+#define PS_DECL_c(N)
+#define PS_DECL_d(N)
+#define PS_DECL_ud(N)
+#define PS_DECL_l(N)
+#define PS_DECL_ul(N)
+#define PS_DECL_S(N)	int N##_len = MIN((int)strlen(N), MSG_LEN - 1);
+#define PS_SIZE(T, N)	+ PS_WSIZE_##T(N)
+#define PS_WSIZE_b(N)	1
+#define PS_WSIZE_c(N)	1
+#define PS_WSIZE_d(N)	2
+#define PS_WSIZE_ud(N)	2
+#define PS_WSIZE_l(N)	4
+#define PS_WSIZE_ul(N)	4
+#define PS_WSIZE_S(N)	(N##_len + 1)
+#define PS_PACK(T, N)	PS_PACK_##T(N);
+#define PS_PACK_b(N)	PACK_PTR_8(wptr, N)
+#define PS_PACK_c(N)	PACK_PTR_8(wptr, N)
+#define PS_PACK_d(N)	PACK_PTR_16(wptr, N)
+#define PS_PACK_ud(N)	PACK_PTR_16(wptr, N)
+#define PS_PACK_l(N)	PACK_PTR_32(wptr, N)
+#define PS_PACK_ul(N)	PACK_PTR_32(wptr, N)
+#define PS_PACK_S(N)	memcpy(wptr, N, N##_len), wptr += N##_len, * wptr ++ = '\0'
+
+/* Unpacking */
+#define PS_RDECL(T, N)	PS_RDECL_##T(N)
+#define PS_RDECL_b(N)
+#define PS_RDECL_c(N)
+#define PS_RDECL_d(N)
+#define PS_RDECL_ud(N)
+#define PS_RDECL_l(N)
+#define PS_RDECL_ul(N)
+#define PS_RDECL_S(N)	int N##_len;
+#define PS_RSIZE(T, N)	PS_RSIZE_##T(N)
+#define PS_RSIZE_b(N)	size += 1;
+#define PS_RSIZE_c(N)	size += 1;
+#define PS_RSIZE_d(N)	size += 2;
+#define PS_RSIZE_ud(N)	size += 2;
+#define PS_RSIZE_l(N)	size += 4;
+#define PS_RSIZE_ul(N)	size += 4;
+#define PS_RSIZE_S(N) \
+	if (left <= size) { charq->err = 2; return 0; } \
+	N##_len = strnlen(rptr + size, MIN(left - size, MSG_LEN)); \
+	if (N##_len >= MSG_LEN) { charq->err = 5; return 0; } \
+	if (N##_len >= left - size) { charq->err = 2; return 0; } \
+	size += N##_len + 1;
+#define PS_UNPACK(T, N)	PS_UNPACK_##T(N);
+#define PS_UNPACK_b(N)	UNPACK_PTR_8(N, rptr)
+#define PS_UNPACK_c(N)	UNPACK_PTR_8(N, rptr)
+#define PS_UNPACK_d(N)	UNPACK_PTR_16(N, rptr)
+#define PS_UNPACK_ud(N)	UNPACK_PTR_16(N, rptr)
+#define PS_UNPACK_l(N)	UNPACK_PTR_32(N, rptr)
+#define PS_UNPACK_ul(N)	UNPACK_PTR_32(N, rptr)
+#define PS_UNPACK_S(N)	memcpy(N, rptr, N##_len + 1), rptr += N##_len + 1
+
+/* Generators */
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define PS_INLINE static __inline
+#else
+#define PS_INLINE static
+#endif
+#define PSCHEME(NAME) \
+PS_INLINE int cq_pack_##NAME(cq *charq, byte pkt PS_##NAME(PS_PARAM)) \
+{ \
+	char *wptr = &charq->buf[charq->len]; \
+	int size; \
+	PS_##NAME(PS_DECL) \
+	size = 1 PS_##NAME(PS_SIZE); \
+	if (charq->len + size > charq->max) { charq->err = 2; return 0; } \
+	PACK_PTR_8(wptr, pkt); \
+	PS_##NAME(PS_PACK) \
+	charq->len += size; \
+	charq->err = 0; \
+	return size; \
+} \
+PS_INLINE int cq_unpack_##NAME(cq *charq PS_##NAME(PS_PTR)) \
+{ \
+	char *rptr = &charq->buf[charq->pos]; \
+	int left = charq->len - charq->pos; \
+	int size = 0; \
+	PS_##NAME(PS_RDECL) \
+	PS_##NAME(PS_RSIZE) \
+	if (size > left) { charq->err = 2; return 0; } \
+	PS_##NAME(PS_UNPACK) \
+	charq->pos += size; \
+	charq->err = 0; \
+	return 0 PS_##NAME(PS_COUNT); \
+}
+
+PSCHEME(stream_line)
+PSCHEME(stream_char)
+PSCHEME(stream_char_trn)
+PSCHEME(tile)
+PSCHEME(tile_trn)
+PSCHEME(stream_span)
+PSCHEME(message)
+
 #endif
@@ -97,6 +97,7 @@
 #define PKT_CURSOR      	151
 
 /* Extra packets */
+#define PKT_STREAM_SPAN 	159
 #define PKT_OBSERVE     	160
 #define PKT_SLASH_FX    	161
 #define PKT_CHANGEPASS  	162
@@ -47,6 +47,7 @@
 /**** MAngband specific structs ****/
 
 typedef struct cave_type cave_type;
+typedef struct flow_type flow_type;
 typedef struct server_setup_t server_setup_t;
 typedef struct client_setup_t client_setup_t;
 typedef struct option_type option_type;
@@ -57,6 +58,7 @@ typedef struct house_type house_type;
 typedef struct hostile_type hostile_type;
 typedef struct history_event history_event;
 typedef struct channel_type channel_type;
+typedef struct sent_text_type sent_text_type;
 typedef struct custom_command_type custom_command_type;
 typedef struct stream_type stream_type;
 typedef struct indicator_type indicator_type;
@@ -93,14 +95,23 @@ struct cave_type
 
 	s16b m_idx;		/* Monster index (in m_list) or zero */
 				/* or negative if a player */
+};
 
-#ifdef MONSTER_FLOW
+/*
+ * Monster "flow" information of a level.
+ *
+ * Every grid holds the number of steps to the nearest player,
+ * so monsters can follow the gradient around walls.
+ */
+struct flow_type
+{
+	byte cost[MAX_HGT][MAX_WID];	/* Steps to a player, or FLOW_NONE */
 
-	byte cost;		/* Hack -- cost of flowing */
-	byte when;		/* Hack -- when cost was computed */
-
-#endif
+	bool dirty;			/* Level changed, recompute */
 
+	s16b num_seeds;		/* Players it was computed for */
+	byte seed_y[MAX_PLAYERS];
+	byte seed_x[MAX_PLAYERS];
 };
 
 
@@ -221,6 +232,16 @@ struct cave_view_type
 	char c;		/* ASCII character */
 };
 
+/*
+ * What the client's text sub-window holds, see "send_prepared_diff()"
+ */
+struct sent_text_type
+{
+	cave_view_type (*rows)[SENT_TEXT_WID]; /* Copy of the rows sent, zero if unknown */
+	s16b last_line; /* Last line shown by the client */
+	bool known; /* FALSE to send everything again */
+};
+
 /*
  * Information about "Arena" (special building for pvp)
  */
@@ -332,6 +353,7 @@ typedef struct ego_item_type ego_item_type;
 typedef struct monster_blow monster_blow;
 typedef struct monster_race monster_race;
 typedef struct monster_lore monster_lore;
+typedef struct mon_det_type mon_det_type;
 typedef struct vault_type vault_type;
 typedef struct object_type object_type;
 typedef struct monster_type monster_type;
@@ -739,6 +761,16 @@ struct monster_lore
 };
 
 
+/*
+ * Monster "detection" timer, see "mon_det_give()"
+ */
+struct mon_det_type
+{
+	s16b m_idx;			/* Detected monster */
+	byte turns;			/* Remaining detection turns */
+};
+
+
 /*
  * Information about "vault generation"
  */
@@ -866,6 +898,9 @@ struct monster_type
 
 	s16b closest_player;		/* The player closest to this monster */
 	s16b hold_o_idx;		/* Object being helf (if any) */
+
+	s16b next_on_depth;		/* Next monster on the same level (if any) */
+	s16b prev_on_depth;		/* Previous monster on the same level (if any) */
 #ifdef WDT_TRACK_OPTIONS
 
 	byte ty;			/* Y location of target */
@@ -1324,6 +1359,13 @@ struct player_type
 	s16b view_n;		/* Array of grids viewable to player */
 	byte view_y[VIEW_MAX];
 	byte view_x[VIEW_MAX];
+	byte view_o[VIEW_MAX];	/* Octant each grid belongs to */
+
+	s16b view_depth;	/* Where the view was calculated from */
+	byte view_py;
+	byte view_px;
+	byte view_full;		/* Radius it was calculated with */
+	byte view_dirty;	/* Octants changed since (see "update_view()") */
 
 	s16b lite_n;		/* Array of grids lit by player lite */
 	byte lite_y[LITE_MAX];
@@ -1348,16 +1390,20 @@ struct player_type
 
 	byte cave_flag[MAX_HGT][MAX_WID]; /* Can the player see this grid? */
 
-	bool mon_hrt[MAX_M_IDX]; /* Have this player hurt these monsters? */
+	/* The following are bitsets, see "idx_has()" */
+	byte mon_hrt[IDX_SET_SIZE(MAX_M_IDX)]; /* Have this player hurt these monsters? */
 
-	bool mon_vis[MAX_M_IDX];  /* Can this player see these monsters? */
-	bool mon_los[MAX_M_IDX];
-	byte mon_det[MAX_M_IDX]; /* Were these monsters detected by this player? */
+	byte mon_vis[IDX_SET_SIZE(MAX_M_IDX)];  /* Can this player see these monsters? */
+	byte mon_los[IDX_SET_SIZE(MAX_M_IDX)];
+	byte mon_det[IDX_SET_SIZE(MAX_M_IDX)]; /* Were these monsters detected by this player? */
+	mon_det_type *mon_det_list; /* Detection timers, one per set "mon_det" bit */
+	s16b mon_det_num;
+	s16b mon_det_max;
 
-	bool obj_vis[MAX_O_IDX];  /* Can this player see these objcets? */
+	byte obj_vis[IDX_SET_SIZE(MAX_O_IDX)];  /* Can this player see these objcets? */
 
-	bool play_vis[MAX_PLAYERS];	/* Can this player see these players? */
-	bool play_los[MAX_PLAYERS];
+	byte play_vis[IDX_SET_SIZE(MAX_PLAYERS)];	/* Can this player see these players? */
+	byte play_los[IDX_SET_SIZE(MAX_PLAYERS)];
 	byte play_det[MAX_PLAYERS]; /* Were these players detected by this player? */
 
 	bool *kind_aware; /* Is the player aware of this obj kind? */
@@ -1410,12 +1456,18 @@ struct player_type
 				/* What he should be seeing */
 	cave_view_type scr_info[MAX_HGT][MAX_WID];
 	cave_view_type trn_info[MAX_HGT][MAX_WID];
-	cave_view_type info[MAX_TXT_INFO][MAX_WID];
-	cave_view_type file[MAX_TXT_INFO][MAX_WID];
+	u32b tile_dirty[MAX_HGT][(MAX_WID + 31) / 32]; /* Grids waiting to be sent, see "stream_tile_later()" */
+	bool tile_dirty_any;
+	cave_view_type (*info)[MAX_WID]; /* Text buffer, grown by "text_info_row()" */
+	s16b info_rows; /* Number of allocated "info" rows */
+	cave_view_type (*file)[MAX_WID]; /* Copy of "info", see "text_out_save()" */
+	s16b file_rows; /* Number of allocated "file" rows */
 	s16b last_info_line; /* (number of lines - 1) */
 	s16b last_file_line; /* (number of lines - 1) */
 	byte remote_term;
 	u32b window_flag; /* What updates is he subscribed to? */
+	sent_text_type sent_monlist; /* Monster list sub-window */
+	sent_text_type sent_itemlist; /* Item list sub-window */
 
 
 	char died_from[80];     	/* What off-ed him */
@@ -1646,8 +1698,16 @@ struct player_type
 	quest q_list[MAX_Q_IDX]; /* Quests completed by player */
 	bool in_hack;		/* Temporary flag, not guaranteed to stay same between function calls */
 
+	player_type *next_on_depth;	/* Next player on the same level (if any) */
+	player_type *prev_on_depth;	/* Previous player on the same level (if any) */
+	bool on_depth_list;	/* Player is linked into "p_first_on_depth" */
+
 	bool bubble_checked;	/* Have we been included in a time bubble check? */
 	s32b bubble_speed;		/* What was our last time bubble scale factor */
+	s32b bubble_factor;		/* Cached base time factor (see base_time_factor()) */
+	s16b bubble_depth;		/* Level the cached factor belongs to */
+	u32b bubble_stamp;		/* ...its bubble generation at the time */
+	hturn bubble_turn;		/* ...and the game turn */
 	hturn bubble_change;		/* Server turn we last changed colour */
 	byte bubble_colour;		/* Current warning colour for slow time bubbles */
 
@@ -333,6 +333,26 @@ bool file_move(const char *fname, const char *newname)
 	return (rename(buf, aux) == 0);
 }
 
+/**
+ * Move file 'fname' over 'newname', atomically where the OS allows.
+ */
+bool file_replace(const char *fname, const char *newname)
+{
+	char buf[1024];
+	char aux[1024];
+
+	/* Get the system-specific paths */
+	path_parse(buf, sizeof(buf), fname);
+	path_parse(aux, sizeof(aux), newname);
+
+#if defined(WINDOWS) && !defined(CYGWIN)
+	return (MoveFileEx(buf, aux, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0);
+#else
+	/* POSIX rename() replaces the target atomically */
+	return (rename(buf, aux) == 0);
+#endif
+}
+
 
 /**
  * Decide whether a file exists or not.
@@ -515,6 +535,27 @@ bool file_error(ang_file *f)
 #endif
 }
 
+/**
+ * Flush file handle 'f' all the way to the disk.
+ */
+bool file_sync(ang_file *f)
+{
+#ifdef USE_SDL_RWOPS
+	/* No way to reach the descriptor */
+	return (f->error ? false : true);
+#else
+	if (fflush(f->fh) == EOF)
+		return false;
+# if defined(WINDOWS) && !defined(CYGWIN)
+	return (_commit(_fileno(f->fh)) == 0);
+# elif defined(HAVE_FSYNC)
+	return (fsync(fileno(f->fh)) == 0);
+# else
+	return true;
+# endif
+#endif
+}
+
 
 /** Locking functions **/
 
@@ -124,6 +124,13 @@ bool file_delete(const char *fname);
  */
 bool file_move(const char *fname, const char *newname);
 
+/**
+ * Move file `fname` over `newname`, replacing it in one step.
+ *
+ * Returns true if successful, false otherwise.
+ */
+bool file_replace(const char *fname, const char *newname);
+
 /**
  * Copies the file `fname` to `newname`.
  *
@@ -177,6 +184,13 @@ bool file_close(ang_file *f);
  */
 bool file_error(ang_file *f);
 
+/**
+ * Push everything written to `f` down to the disk.
+ *
+ * Returns true if successful, false otherwise.
+ */
+bool file_sync(ang_file *f);
+
 /** File locking **/
 
 /**
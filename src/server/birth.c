@@ -508,6 +508,10 @@ void player_wipe(player_type *p_ptr)
 	byte *f_attr, *k_attr, *d_attr, *r_attr, *pr_attr;
 	char *f_char, *k_char, *d_char, *r_char, *pr_char;
 	char *c_buf;
+	cave_view_type (*info)[MAX_WID];
+	s16b info_rows;
+	mon_det_type *mon_det_list;
+	s16b mon_det_max;
 	int i;
 
 
@@ -525,10 +529,18 @@ void player_wipe(player_type *p_ptr)
 	d_attr = p_ptr->d_attr; d_char = p_ptr->d_char;
 	pr_attr = p_ptr->pr_attr; pr_char = p_ptr->pr_char;
 	c_buf = p_ptr->cbuf.buf;
+	info = p_ptr->info; info_rows = p_ptr->info_rows;
+	mon_det_list = p_ptr->mon_det_list; mon_det_max = p_ptr->mon_det_max;
+	if (p_ptr->file) KILL(p_ptr->file);
+	if (p_ptr->sent_monlist.rows) KILL(p_ptr->sent_monlist.rows);
+	if (p_ptr->sent_itemlist.rows) KILL(p_ptr->sent_itemlist.rows);
 
 	/* Clear character history ! */
 	history_wipe(p_ptr->charhist);
 
+	/* Paranoia -- leave the level list */
+	player_unlink_depth(p_ptr);
+
 	/* Hack -- zero the struct */
 	WIPE(p_ptr, player_type);
 
@@ -546,6 +558,8 @@ void player_wipe(player_type *p_ptr)
 	p_ptr->d_attr = d_attr; p_ptr->d_char = d_char;
 	p_ptr->pr_attr = pr_attr; p_ptr->pr_char = pr_char;
 	p_ptr->cbuf.buf = c_buf;
+	p_ptr->info = info; p_ptr->info_rows = info_rows;
+	p_ptr->mon_det_list = mon_det_list; p_ptr->mon_det_max = mon_det_max;
 
 	/* Wipe grafmode offsets */
 	for (i = 0; i < LIGHTING_MAX; i++)
@@ -1060,7 +1074,8 @@ void player_setup(player_type *p_ptr)
 		if (Depth < 0)
 		{
 			players_on_depth[Depth]--;
-			Depth = p_ptr->dun_depth = 0;
+			player_change_depth(p_ptr, 0);
+			Depth = 0;
 			players_on_depth[Depth]++;
 			p_ptr->world_x = 0;
 			p_ptr->world_y = 0;
@@ -1230,6 +1245,9 @@ player_type* player_alloc()
 	C_MAKE(p_ptr->pr_attr, (z_info->c_max+1)*z_info->p_max, byte);
 	C_MAKE(p_ptr->pr_char, (z_info->c_max+1)*z_info->p_max, char);
 
+	/* Allocate the first chunk of his text buffer */
+	text_info_row(p_ptr, 0);
+
 	/* Hack -- initialize history */
 	p_ptr->charhist = NULL;
 
@@ -1267,6 +1285,12 @@ void player_free(player_type *p_ptr)
 	if (p_ptr->pr_attr)		KILL(p_ptr->pr_attr);
 	if (p_ptr->pr_char)		KILL(p_ptr->pr_char);
 
+	if (p_ptr->info)		KILL(p_ptr->info);
+	if (p_ptr->file)		KILL(p_ptr->file);
+	if (p_ptr->sent_monlist.rows)	KILL(p_ptr->sent_monlist.rows);
+	if (p_ptr->sent_itemlist.rows)	KILL(p_ptr->sent_itemlist.rows);
+	if (p_ptr->mon_det_list)	KILL(p_ptr->mon_det_list);
+
 	history_wipe(p_ptr->charhist);
 
 	KILL(p_ptr);
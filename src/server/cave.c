@@ -1204,7 +1204,7 @@ void map_info(player_type *p_ptr, int y, int x, byte *ap, char *cp, byte *tap, c
 
 		/* Memorized objects */
 		/* Hack -- the dungeon master knows where everything is */
-		if ((p_ptr->obj_vis[c_ptr->o_idx]) || (p_ptr->dm_flags & DM_SEE_LEVEL))
+		if ((idx_has(p_ptr->obj_vis, c_ptr->o_idx)) || (p_ptr->dm_flags & DM_SEE_LEVEL))
 		{
 			/* Normal char */
 			(*cp) = object_char_p(p_ptr, o_ptr);
@@ -1231,7 +1231,7 @@ void map_info(player_type *p_ptr, int y, int x, byte *ap, char *cp, byte *tap, c
 		monster_type *m_ptr = &m_list[c_ptr->m_idx];
 
 		/* Visible monster */
-		if (p_ptr->mon_vis[c_ptr->m_idx])
+		if (idx_has(p_ptr->mon_vis, c_ptr->m_idx))
 		{
 			monster_race *r_ptr = &r_info[m_ptr->r_idx];
 
@@ -1339,7 +1339,7 @@ void map_info(player_type *p_ptr, int y, int x, byte *ap, char *cp, byte *tap, c
 	if (c_ptr->m_idx < 0)
 	{
 		/* Is that player visible? */
-		if (p_ptr->play_vis[0 - c_ptr->m_idx])
+		if (idx_has(p_ptr->play_vis, 0 - c_ptr->m_idx))
 		{
 			int p = player_pict(p_ptr, Players[0 - c_ptr->m_idx]);
 			a = PICT_A(p);
@@ -1395,13 +1395,13 @@ void note_spot(player_type *p_ptr, int y, int x)
 	if (c_ptr->o_idx)
 	{
 		/* Only memorize once */
-		if (!(p_ptr->obj_vis[c_ptr->o_idx]))
+		if (!(idx_has(p_ptr->obj_vis, c_ptr->o_idx)))
 		{
 			/* Memorize visible objects */
 			if (player_can_see_bold(p_ptr, y, x))
 			{
 				/* Memorize */
-				p_ptr->obj_vis[c_ptr->o_idx] = TRUE;
+				idx_on(p_ptr->obj_vis, c_ptr->o_idx);
 
 				/* Schedule list redraw */
 				p_ptr->window |= (PW_ITEMLIST);
@@ -1443,30 +1443,23 @@ void note_spot(player_type *p_ptr, int y, int x)
 
 void note_spot_depth(int Depth, int y, int x)
 {
-	int i;
+	player_type *p_ptr;
 
-	for (i = 1; i <= NumPlayers; i++)
+	for (p_ptr = p_first_on_depth[Depth]; p_ptr; p_ptr = p_ptr->next_on_depth)
 	{
-		if (Players[i]->dun_depth == Depth)
-		{
-			note_spot(Players[i], y, x);
-		}
+		note_spot(p_ptr, y, x);
 	}
 }
 
 void everyone_lite_spot(int Depth, int y, int x)
 {
-	int i;
+	player_type *p_ptr;
 
-	/* Check everyone */
-	for (i = 1; i <= NumPlayers; i++)
+	/* Check everyone here */
+	for (p_ptr = p_first_on_depth[Depth]; p_ptr; p_ptr = p_ptr->next_on_depth)
 	{
-		/* If he's not here, skip him */
-		if (Players[i]->dun_depth != Depth)
-			continue;
-
 		/* Actually lite that spot for that player */
-		lite_spot(Players[i], y, x);
+		lite_spot(p_ptr, y, x);
 	}
 }
 
@@ -1475,17 +1468,13 @@ void everyone_lite_spot(int Depth, int y, int x)
  */
 void everyone_forget_spot(int Depth, int y, int x)
 {
-	int i;
+	player_type *p_ptr;
 
-	/* Check everyone */
-	for (i = 1; i <= NumPlayers; i++)
+	/* Check everyone here */
+	for (p_ptr = p_first_on_depth[Depth]; p_ptr; p_ptr = p_ptr->next_on_depth)
 	{
-		/* If he's not here, skip him */
-		if (Players[i]->dun_depth != Depth)
-			continue;
-
 		/* Forget the spot */
-		Players[i]->cave_flag[y][x] &= ~CAVE_MARK;
+		p_ptr->cave_flag[y][x] &= ~CAVE_MARK;
 	}
 }
 
@@ -1534,14 +1523,17 @@ void lite_spot(player_type *p_ptr, int y, int x)
 			p_ptr->trn_info[dispy][dispx].c = tc;
 			p_ptr->trn_info[dispy][dispx].a = ta;
 
-			/* Tell client to redraw this grid */
-			Stream_tile_p(p_ptr, dispy, dispx);
-
 			/* Mark player */
 			if (is_player)
 			{
+				/* Tell client to redraw this grid (right now) */
+				Stream_tile_p(p_ptr, dispy, dispx);
+
 				send_cursor(p_ptr, MCURSOR_PLAYER, (byte)y, (byte)x);
 			}
+
+			/* Tell client to redraw this grid (soon) */
+			else stream_tile_later(p_ptr, dispy, dispx);
 		}
 	}
 	/* Out of panel bounds */
@@ -1559,17 +1551,16 @@ void spot_updates(int Depth, int y, int x, u32b updates)
 {
 	int i;
 
+	/* Cached views may have changed */
+	if (updates & PU_VIEW) view_stamp_on_depth[Depth]++;
+
 	/* Check every player on this depth */
 	for (i = 1; i <= NumPlayers; i++)
 	{
 		player_type *p_ptr = Players[i];
 		if (p_ptr->dun_depth != Depth) continue;
 
-		/* Feature is in direct view */
-		if (player_has_los_bold(p_ptr, y, x))
-		{
-			p_ptr->update |= updates;
-		}
+		player_spot_updates(p_ptr, y, x, updates);
 	}
 }
 
@@ -1587,6 +1578,12 @@ void cave_set_feat(int Depth, int y, int x, int feat)
 	/* Change the feature */
 	c_ptr->feat = feat;
 
+	/* Paths may have changed */
+	if (flow_on_depth[Depth]) flow_on_depth[Depth]->dirty = TRUE;
+
+	/* Cached views may have changed */
+	view_stamp_on_depth[Depth]++;
+
 #if 0
 	/* Handle "wall/door" grids */
 	if (feat >= FEAT_DOOR_HEAD)
@@ -1639,6 +1636,10 @@ void prt_map(player_type *p_ptr)
 	/* Hack -- reseed hallucinaton */
 	image_rng_flush(p_ptr);
 
+	/* Everything is about to be resent anyway */
+	C_WIPE(p_ptr->tile_dirty, MAX_HGT * ((MAX_WID + 31) / 32), u32b);
+	p_ptr->tile_dirty_any = FALSE;
+
 	/* Dump the map */
 	for (y = p_ptr->panel_row_min; y <= p_ptr->panel_row_max; y++)
 	{
@@ -2754,6 +2755,53 @@ void forget_view(player_type *p_ptr)
 
 
 
+/*
+ * The "view" is built from the player grid, the major diagonals and
+ * axes (the "spine"), and the eight octants between them.  Each grid
+ * in the "view" array remembers where it came from (see "view_o[]"),
+ * so that a changed wall or door only costs the octants around it.
+ */
+#define VIEW_OCT_SE	0	/* South strips, east side */
+#define VIEW_OCT_SW	1	/* South strips, west side */
+#define VIEW_OCT_NE	2	/* North strips, east side */
+#define VIEW_OCT_NW	3	/* North strips, west side */
+#define VIEW_OCT_ES	4	/* East strips, south side */
+#define VIEW_OCT_EN	5	/* East strips, north side */
+#define VIEW_OCT_WS	6	/* West strips, south side */
+#define VIEW_OCT_WN	7	/* West strips, north side */
+#define VIEW_SPINE	8	/* Player grid, diagonals and axes */
+
+#define VIEW_BIT(O)	(1 << (O))
+#define VIEW_OCT_ALL	0xFF
+
+/*
+ * Recently calculated views, keyed by grid.  A party walking in single
+ * file steps onto the same grids one after another, so the followers
+ * can simply copy the leader's view.  An entry is only good while the
+ * "view_stamp_on_depth[]" of its level has not moved on.
+ */
+#define VIEW_CACHE_SIZE	16
+
+#define view_cache_slot(D,Y,X) \
+    ((((D) + MAX_WILD) * 7 + (Y) * 13 + (X)) & (VIEW_CACHE_SIZE - 1))
+
+typedef struct view_cache_type view_cache_type;
+
+struct view_cache_type
+{
+	u32b stamp;		/* Level stamp it was calculated at */
+	s16b depth;
+	byte y, x;		/* Grid it was calculated from */
+	byte full;		/* Radius it was calculated with */
+
+	s16b n;			/* Copy of the "view" array */
+	byte vy[VIEW_MAX];
+	byte vx[VIEW_MAX];
+	byte vo[VIEW_MAX];
+};
+
+static view_cache_type view_cache[VIEW_CACHE_SIZE];
+
 /*
  * This macro allows us to efficiently add a grid to the "view" array,
  * note that we are never called for illegal grids, or for grids which
@@ -2762,10 +2810,11 @@ void forget_view(player_type *p_ptr)
  *
  * I'm again assuming that using p_ptr is OK (see above) --KLJ--
  */
-#define cave_view_hack(W,Y,X) \
+#define cave_view_hack(W,Y,X,O) \
     (*(W)) |= CAVE_VIEW; \
     p_ptr->view_y[p_ptr->view_n] = (Y); \
     p_ptr->view_x[p_ptr->view_n] = (X); \
+    p_ptr->view_o[p_ptr->view_n] = (O); \
     p_ptr->view_n++
 
 
@@ -2789,7 +2838,7 @@ void forget_view(player_type *p_ptr)
  */
  
  
-static bool update_view_aux(player_type *p_ptr, int y, int x, int y1, int x1, int y2, int x2)
+static bool update_view_aux(player_type *p_ptr, int y, int x, int y1, int x1, int y2, int x2, byte oct)
 {
 	int Depth = p_ptr->dun_depth;
 	bool f1, f2, v1, v2, z1, z2, wall;
@@ -2803,6 +2852,9 @@ static bool update_view_aux(player_type *p_ptr, int y, int x, int y1, int x1, in
 	byte *g1_w_ptr;
 	byte *g2_w_ptr;
 
+	/* Count it */
+	view_grids++;
+
 	/* Access the grids */
 	g1_c_ptr = &cave[Depth][y1][x1];
 	g2_c_ptr = &cave[Depth][y2][x2];
@@ -2845,7 +2897,7 @@ static bool update_view_aux(player_type *p_ptr, int y, int x, int y1, int x1, in
 	{
 		c_ptr->info |= CAVE_XTRA;
 
-		cave_view_hack(w_ptr, y, x);
+		cave_view_hack(w_ptr, y, x, oct);
 
 		return (wall);
 	}
@@ -2853,7 +2905,7 @@ static bool update_view_aux(player_type *p_ptr, int y, int x, int y1, int x1, in
 	/* Hack -- primary "easy" yields "viewed" */
 	if (z1)
 	{
-		cave_view_hack(w_ptr, y, x);
+		cave_view_hack(w_ptr, y, x, oct);
 
 		return (wall);
 	}
@@ -2864,7 +2916,7 @@ static bool update_view_aux(player_type *p_ptr, int y, int x, int y1, int x1, in
 	{
 		/* c_ptr->info |= CAVE_XTRA; */
 
-		cave_view_hack(w_ptr, y, x);
+		cave_view_hack(w_ptr, y, x, oct);
 
 		return (wall);
 	}
@@ -2873,7 +2925,7 @@ static bool update_view_aux(player_type *p_ptr, int y, int x, int y1, int x1, in
 	/* Mega-Hack -- the "los()" function works poorly on walls */
 	if (wall)
 	{
-		cave_view_hack(w_ptr, y, x);
+		cave_view_hack(w_ptr, y, x, oct);
 
 		return (wall);
 	}
@@ -2882,7 +2934,7 @@ static bool update_view_aux(player_type *p_ptr, int y, int x, int y1, int x1, in
 	/* Hack -- check line of sight */
 	if (los(Depth, p_ptr->py, p_ptr->px, y, x))
 	{
-		cave_view_hack(w_ptr, y, x);
+		cave_view_hack(w_ptr, y, x, oct);
 
 		return (wall);
 	}
@@ -2996,7 +3048,13 @@ static bool update_view_aux(player_type *p_ptr, int y, int x, int y1, int x1, in
     With my new "invisible wall" code this shouldn't be neccecary. 
     
  */
-void update_view(player_type *p_ptr)
+
+/*
+ * Steps 1 to 4 are done here, the rest is in "update_view()" below.
+ * The player grid, diagonals and axes are always scanned, but only the
+ * octants in "mask" are.
+ */
+static void update_view_grids(player_type *p_ptr, int full, int over, byte mask)
 {
 	int Depth = p_ptr->dun_depth;
 
@@ -3004,66 +3062,15 @@ void update_view(player_type *p_ptr)
 
 	int se, sw, ne, nw, es, en, ws, wn;
 
-	int full, over;
-
 	int y_max = p_ptr->cur_hgt - 1;
 	int x_max = p_ptr->cur_wid - 1;
 
+	int start = p_ptr->view_n;
+
 	cave_type *c_ptr;
 	byte *w_ptr;
 
 
-	/*** Initialize ***/
-
-	/* Optimize */
-	if (option_p(p_ptr,VIEW_REDUCE_VIEW) && !Depth)
-	{
-		/* Full radius (10) */
-		full = MAX_SIGHT / 2;
-
-		/* Octagon factor (15) */
-		over = MAX_SIGHT * 3 / 4;
-	}
-
-	/* Normal */
-	else
-	{
-		/* Full radius (20) */
-		full = MAX_SIGHT;
-
-		/* Octagon factor (30) */
-		over = MAX_SIGHT * 3 / 2;
-	}
-
-
-	/*** Step 0 -- Begin ***/
-
-	/* Save the old "view" grids for later */
-	for (n = 0; n < p_ptr->view_n; n++)
-	{
-		y = p_ptr->view_y[n];
-		x = p_ptr->view_x[n];
-
-		/* Access the grid */
-		c_ptr = &cave[Depth][y][x];
-		w_ptr = &p_ptr->cave_flag[y][x];
-
-		/* Mark the grid as not in "view" */
-		*w_ptr &= ~(CAVE_VIEW);
-
-		/* Mark the grid as "seen" */
-		c_ptr->info |= CAVE_TEMP;
-
-		/* Add it to the "seen" set */
-		p_ptr->temp_y[p_ptr->temp_n] = y;
-		p_ptr->temp_x[p_ptr->temp_n] = x;
-		p_ptr->temp_n++;
-	}
-
-	/* Start over with the "view" array */
-	p_ptr->view_n = 0;
-
-
 	/*** Step 1 -- adjacent grids ***/
 
 	/* Now start on the player */
@@ -3078,7 +3085,7 @@ void update_view(player_type *p_ptr)
 	c_ptr->info |= CAVE_XTRA;
 
 	/* Assume the player grid is viewable */
-	cave_view_hack(w_ptr, y, x);
+	cave_view_hack(w_ptr, y, x, VIEW_SPINE);
 
 
 	/*** Step 2 -- Major Diagonals ***/
@@ -3093,7 +3100,7 @@ void update_view(player_type *p_ptr)
 		c_ptr = &cave[Depth][y+d][x+d];
 		w_ptr = &p_ptr->cave_flag[y+d][x+d];
 		c_ptr->info |= CAVE_XTRA;
-		cave_view_hack(w_ptr, y+d, x+d);
+		cave_view_hack(w_ptr, y+d, x+d, VIEW_SPINE);
 		if (!cave_floor_grid(c_ptr)) break;		
 	}
 
@@ -3104,7 +3111,7 @@ void update_view(player_type *p_ptr)
 		c_ptr = &cave[Depth][y+d][x-d];
 		w_ptr = &p_ptr->cave_flag[y+d][x-d];
 		c_ptr->info |= CAVE_XTRA;
-		cave_view_hack(w_ptr, y+d, x-d);
+		cave_view_hack(w_ptr, y+d, x-d, VIEW_SPINE);
 		if (!cave_floor_grid(c_ptr)) break;
 	}
 
@@ -3115,7 +3122,7 @@ void update_view(player_type *p_ptr)
 		c_ptr = &cave[Depth][y-d][x+d];
 		w_ptr = &p_ptr->cave_flag[y-d][x+d];
 		c_ptr->info |= CAVE_XTRA;
-		cave_view_hack(w_ptr, y-d, x+d);
+		cave_view_hack(w_ptr, y-d, x+d, VIEW_SPINE);
 		if (!cave_floor_grid(c_ptr)) break;
 	}
 
@@ -3126,7 +3133,7 @@ void update_view(player_type *p_ptr)
 		c_ptr = &cave[Depth][y-d][x-d];
 		w_ptr = &p_ptr->cave_flag[y-d][x-d];
 		c_ptr->info |= CAVE_XTRA;
-		cave_view_hack(w_ptr, y-d, x-d);
+		cave_view_hack(w_ptr, y-d, x-d, VIEW_SPINE);
 		if (!cave_floor_grid(c_ptr)) break;
 	}
 
@@ -3140,7 +3147,7 @@ void update_view(player_type *p_ptr)
 		c_ptr = &cave[Depth][y+d][x];
 		w_ptr = &p_ptr->cave_flag[y+d][x];
 		c_ptr->info |= CAVE_XTRA;
-		cave_view_hack(w_ptr, y+d, x);
+		cave_view_hack(w_ptr, y+d, x, VIEW_SPINE);
 		if (!cave_floor_grid(c_ptr)) break;
 	}
 
@@ -3154,7 +3161,7 @@ void update_view(player_type *p_ptr)
 		c_ptr = &cave[Depth][y-d][x];
 		w_ptr = &p_ptr->cave_flag[y-d][x];
 		c_ptr->info |= CAVE_XTRA;
-		cave_view_hack(w_ptr, y-d, x);
+		cave_view_hack(w_ptr, y-d, x, VIEW_SPINE);
 		if (!cave_floor_grid(c_ptr)) break;
 	}
 
@@ -3167,7 +3174,7 @@ void update_view(player_type *p_ptr)
 		c_ptr = &cave[Depth][y][x+d];
 		w_ptr = &p_ptr->cave_flag[y][x+d];
 		c_ptr->info |= CAVE_XTRA;
-		cave_view_hack(w_ptr, y, x+d);
+		cave_view_hack(w_ptr, y, x+d, VIEW_SPINE);
 		if (!cave_floor_grid(c_ptr)) break;
 	}
 
@@ -3180,7 +3187,7 @@ void update_view(player_type *p_ptr)
 		c_ptr = &cave[Depth][y][x-d];
 		w_ptr = &p_ptr->cave_flag[y][x-d];
 		c_ptr->info |= CAVE_XTRA;
-		cave_view_hack(w_ptr, y, x-d);
+		cave_view_hack(w_ptr, y, x-d, VIEW_SPINE);
 		if (!cave_floor_grid(c_ptr)) break;
 	}
 
@@ -3188,6 +3195,10 @@ void update_view(player_type *p_ptr)
 	ws = wn = d;
 
 
+	/* Count them */
+	view_grids += p_ptr->view_n - start;
+
+
 	/*** Step 4 -- Divide each "octant" into "strips" ***/
 
 	/* Now check each "diagonal" (in parallel) */
@@ -3216,7 +3227,7 @@ void update_view(player_type *p_ptr)
 			m = MIN(z, y_max - ypn);
 
 			/* East side */
-			if ((xpn <= x_max) && (n < se))
+			if ((mask & VIEW_BIT(VIEW_OCT_SE)) && (xpn <= x_max) && (n < se))
 			{
 				/* Scan */
 				for (k = n, d = 1; d <= m; d++)
@@ -3224,7 +3235,7 @@ void update_view(player_type *p_ptr)
 					/*if (ypn + d > 65) break; */
 				
 					/* Check grid "d" in strip "n", notice "blockage" */
-					if (update_view_aux(p_ptr, ypn+d, xpn, ypn+d-1, xpn-1, ypn+d-1, xpn))
+					if (update_view_aux(p_ptr, ypn+d, xpn, ypn+d-1, xpn-1, ypn+d-1, xpn, VIEW_OCT_SE))
 					{
 						if (n + d >= se) break;
 					}								
@@ -3242,7 +3253,7 @@ void update_view(player_type *p_ptr)
 			}
 
 			/* West side */
-			if ((xmn >= 0) && (n < sw))
+			if ((mask & VIEW_BIT(VIEW_OCT_SW)) && (xmn >= 0) && (n < sw))
 			{
 				/* Scan */
 				for (k = n, d = 1; d <= m; d++)
@@ -3250,7 +3261,7 @@ void update_view(player_type *p_ptr)
 					/*if (ypn + d > 65) break;*/
 				
 					/* Check grid "d" in strip "n", notice "blockage" */
-					if (update_view_aux(p_ptr, ypn+d, xmn, ypn+d-1, xmn+1, ypn+d-1, xmn))
+					if (update_view_aux(p_ptr, ypn+d, xmn, ypn+d-1, xmn+1, ypn+d-1, xmn, VIEW_OCT_SW))
 					{
 						if (n + d >= sw) break;
 					}
@@ -3276,7 +3287,7 @@ void update_view(player_type *p_ptr)
 			m = MIN(z, ymn);
 
 			/* East side */
-			if ((xpn <= x_max) && (n < ne))
+			if ((mask & VIEW_BIT(VIEW_OCT_NE)) && (xpn <= x_max) && (n < ne))
 			{
 				/* Scan */
 				for (k = n, d = 1; d <= m; d++)
@@ -3284,7 +3295,7 @@ void update_view(player_type *p_ptr)
 					/*if (d > ymn) break;*/
 				
 					/* Check grid "d" in strip "n", notice "blockage" */
-					if (update_view_aux(p_ptr, ymn-d, xpn, ymn-d+1, xpn-1, ymn-d+1, xpn))
+					if (update_view_aux(p_ptr, ymn-d, xpn, ymn-d+1, xpn-1, ymn-d+1, xpn, VIEW_OCT_NE))
 					{
 						if (n + d >= ne) break;
 					}
@@ -3301,7 +3312,7 @@ void update_view(player_type *p_ptr)
 			}
 
 			/* West side */
-			if ((xmn >= 0) && (n < nw))
+			if ((mask & VIEW_BIT(VIEW_OCT_NW)) && (xmn >= 0) && (n < nw))
 			{
 				/* Scan */
 				for (k = n, d = 1; d <= m; d++)
@@ -3309,7 +3320,7 @@ void update_view(player_type *p_ptr)
 					/*if (d > ymn) break;*/
 					
 					/* Check grid "d" in strip "n", notice "blockage" */
-					if (update_view_aux(p_ptr, ymn-d, xmn, ymn-d+1, xmn+1, ymn-d+1, xmn))
+					if (update_view_aux(p_ptr, ymn-d, xmn, ymn-d+1, xmn+1, ymn-d+1, xmn, VIEW_OCT_NW))
 					{
 						if (n + d >= nw) break;
 					}
@@ -3334,7 +3345,7 @@ void update_view(player_type *p_ptr)
 			m = MIN(z, x_max - xpn);
 
 			/* South side */
-			if ((ypn <= x_max) && (n < es))
+			if ((mask & VIEW_BIT(VIEW_OCT_ES)) && (ypn <= x_max) && (n < es))
 			{
 				/* Scan */
 				for (k = n, d = 1; d <= m; d++)
@@ -3342,7 +3353,7 @@ void update_view(player_type *p_ptr)
 					/*if (ypn > 65) break;*/
 				
 					/* Check grid "d" in strip "n", notice "blockage" */
-					if (update_view_aux(p_ptr, ypn, xpn+d, ypn-1, xpn+d-1, ypn, xpn+d-1))
+					if (update_view_aux(p_ptr, ypn, xpn+d, ypn-1, xpn+d-1, ypn, xpn+d-1, VIEW_OCT_ES))
 					{
 						if (n + d >= es) break;
 					}
@@ -3359,7 +3370,7 @@ void update_view(player_type *p_ptr)
 			}
 
 			/* North side */
-			if ((ymn >= 0) && (n < en))
+			if ((mask & VIEW_BIT(VIEW_OCT_EN)) && (ymn >= 0) && (n < en))
 			{
 				/* Scan */
 				for (k = n, d = 1; d <= m; d++)
@@ -3367,7 +3378,7 @@ void update_view(player_type *p_ptr)
 					/*if (ymn > 65) break;*/
 				
 					/* Check grid "d" in strip "n", notice "blockage" */
-					if (update_view_aux(p_ptr, ymn, xpn+d, ymn+1, xpn+d-1, ymn, xpn+d-1))
+					if (update_view_aux(p_ptr, ymn, xpn+d, ymn+1, xpn+d-1, ymn, xpn+d-1, VIEW_OCT_EN))
 					{
 						if (n + d >= en) break;
 					}
@@ -3392,7 +3403,7 @@ void update_view(player_type *p_ptr)
 			m = MIN(z, xmn);
 
 			/* South side */
-			if ((ypn <= y_max) && (n < ws))
+			if ((mask & VIEW_BIT(VIEW_OCT_WS)) && (ypn <= y_max) && (n < ws))
 			{
 				/* Scan */
 				for (k = n, d = 1; d <= m; d++)
@@ -3400,7 +3411,7 @@ void update_view(player_type *p_ptr)
 					/*if (ypn > 65) break;*/
 				
 					/* Check grid "d" in strip "n", notice "blockage" */
-					if (update_view_aux(p_ptr, ypn, xmn-d, ypn-1, xmn-d+1, ypn, xmn-d+1))
+					if (update_view_aux(p_ptr, ypn, xmn-d, ypn-1, xmn-d+1, ypn, xmn-d+1, VIEW_OCT_WS))
 					{
 						if (n + d >= ws) break;
 					}
@@ -3417,7 +3428,7 @@ void update_view(player_type *p_ptr)
 			}
 
 			/* North side */
-			if ((ymn >= 0) && (n < wn))
+			if ((mask & VIEW_BIT(VIEW_OCT_WN)) && (ymn >= 0) && (n < wn))
 			{
 				/* Scan */
 				for (k = n, d = 1; d <= m; d++)
@@ -3425,7 +3436,7 @@ void update_view(player_type *p_ptr)
 					/*if (ymn > 65) break;*/
 				
 					/* Check grid "d" in strip "n", notice "blockage" */
-					if (update_view_aux(p_ptr, ymn, xmn-d, ymn+1, xmn-d+1, ymn, xmn-d+1))
+					if (update_view_aux(p_ptr, ymn, xmn-d, ymn+1, xmn-d+1, ymn, xmn-d+1, VIEW_OCT_WN))
 					{
 						if (n + d >= wn) break;
 					}
@@ -3442,12 +3453,180 @@ void update_view(player_type *p_ptr)
 			}
 		}
 	}
+}
+
+
+/*
+ * Update the viewable space (see "update_view_grids()" above)
+ *
+ *  0: Put the old "view" grids aside, except for untouched octants
+ *  1-4: Recalculate the rest, or borrow a cached copy of the view
+ *  5: Notice and redraw every grid that entered or left the view
+ *
+ * When the player has not moved, and the only changes are walls or
+ * doors noticed by "player_spot_updates()", just the octants around
+ * them (and the cheap "spine") are recalculated.
+ */
+void update_view(player_type *p_ptr)
+{
+	int Depth = p_ptr->dun_depth;
+
+	int n, y, x, o, start;
+
+	int full, over;
+
+	bool same;
+	byte mask;
+
+	view_cache_type *v_ptr;
+
+	cave_type *c_ptr;
+	byte *w_ptr;
+
+
+	/*** Initialize ***/
+
+	/* Optimize */
+	if (option_p(p_ptr,VIEW_REDUCE_VIEW) && !Depth)
+	{
+		/* Full radius (10) */
+		full = MAX_SIGHT / 2;
+
+		/* Octagon factor (15) */
+		over = MAX_SIGHT * 3 / 4;
+	}
+
+	/* Normal */
+	else
+	{
+		/* Full radius (20) */
+		full = MAX_SIGHT;
+
+		/* Octagon factor (30) */
+		over = MAX_SIGHT * 3 / 2;
+	}
+
+	/* Same grid and radius as last time */
+	same = (p_ptr->view_n && (p_ptr->view_depth == Depth) &&
+	        (p_ptr->view_py == p_ptr->py) && (p_ptr->view_px == p_ptr->px) &&
+	        (p_ptr->view_full == full));
+
+	/* Only some walls or doors have changed */
+	if (same && p_ptr->view_dirty && (p_ptr->view_dirty != VIEW_OCT_ALL))
+	{
+		mask = p_ptr->view_dirty;
+	}
+
+	/* Start from scratch */
+	else
+	{
+		/* Hack -- something changed under our feet, forget cached views */
+		if (same && !p_ptr->view_dirty) view_stamp_on_depth[Depth]++;
+
+		mask = VIEW_OCT_ALL;
+	}
+
+	/* Forget the changes */
+	p_ptr->view_dirty = 0;
+
+
+	/*** Step 0 -- Begin ***/
+
+	/* Save the old "view" grids for later */
+	for (n = start = 0; n < p_ptr->view_n; n++)
+	{
+		y = p_ptr->view_y[n];
+		x = p_ptr->view_x[n];
+		o = p_ptr->view_o[n];
+
+		/* Keep the grids of untouched octants */
+		if ((o != VIEW_SPINE) && !(mask & VIEW_BIT(o)))
+		{
+			p_ptr->view_y[start] = y;
+			p_ptr->view_x[start] = x;
+			p_ptr->view_o[start] = o;
+			start++;
+			continue;
+		}
+
+		/* Access the grid */
+		c_ptr = &cave[Depth][y][x];
+		w_ptr = &p_ptr->cave_flag[y][x];
+
+		/* Mark the grid as not in "view" */
+		*w_ptr &= ~(CAVE_VIEW);
+
+		/* Mark the grid as "seen" */
+		c_ptr->info |= CAVE_TEMP;
+
+		/* Add it to the "seen" set */
+		p_ptr->temp_y[p_ptr->temp_n] = y;
+		p_ptr->temp_x[p_ptr->temp_n] = x;
+		p_ptr->temp_n++;
+	}
+
+	/* Start over with the "view" array */
+	p_ptr->view_n = start;
+
+
+	/*** Steps 1 to 4 -- Calculate ***/
+
+	y = p_ptr->py;
+	x = p_ptr->px;
+
+	/* Look for a copy */
+	v_ptr = &view_cache[view_cache_slot(Depth, y, x)];
+
+	/* Somebody has just seen this view */
+	if ((mask == VIEW_OCT_ALL) && v_ptr->n && (v_ptr->depth == Depth) &&
+	    (v_ptr->y == y) && (v_ptr->x == x) && (v_ptr->full == full) &&
+	    (v_ptr->stamp == view_stamp_on_depth[Depth]))
+	{
+		/* Borrow it */
+		for (n = 0; n < v_ptr->n; n++)
+		{
+			p_ptr->cave_flag[v_ptr->vy[n]][v_ptr->vx[n]] |= CAVE_VIEW;
+		}
+		C_COPY(p_ptr->view_y, v_ptr->vy, v_ptr->n, byte);
+		C_COPY(p_ptr->view_x, v_ptr->vx, v_ptr->n, byte);
+		C_COPY(p_ptr->view_o, v_ptr->vo, v_ptr->n, byte);
+		p_ptr->view_n = v_ptr->n;
+
+		view_shared++;
+	}
+
+	/* Calculate it */
+	else
+	{
+		update_view_grids(p_ptr, full, over, mask);
+
+		/* Share it */
+		v_ptr->stamp = view_stamp_on_depth[Depth];
+		v_ptr->depth = Depth;
+		v_ptr->y = y;
+		v_ptr->x = x;
+		v_ptr->full = full;
+		v_ptr->n = p_ptr->view_n;
+		C_COPY(v_ptr->vy, p_ptr->view_y, p_ptr->view_n, byte);
+		C_COPY(v_ptr->vx, p_ptr->view_x, p_ptr->view_n, byte);
+		C_COPY(v_ptr->vo, p_ptr->view_o, p_ptr->view_n, byte);
+
+		if (mask != VIEW_OCT_ALL) view_partial++;
+	}
+
+	/* Remember where we looked from */
+	p_ptr->view_depth = Depth;
+	p_ptr->view_py = y;
+	p_ptr->view_px = x;
+	p_ptr->view_full = full;
+
+	view_updates++;
 
 
 	/*** Step 5 -- Complete the algorithm ***/
 
 	/* Update all the new grids */
-	for (n = 0; n < p_ptr->view_n; n++)
+	for (n = start; n < p_ptr->view_n; n++)
 	{
 		y = p_ptr->view_y[n];
 		x = p_ptr->view_x[n];
@@ -3493,186 +3672,250 @@ void update_view(player_type *p_ptr)
 }
 
 
+/*
+ * Which octants of the player's view does grid (y,x) shape?
+ *
+ * Grids on the diagonals and axes are shared by the octants on
+ * either side of them, and the player grid shapes everything.
+ */
+static byte view_octants(player_type *p_ptr, int y, int x)
+{
+	int dy = y - p_ptr->py;
+	int dx = x - p_ptr->px;
+	int ay = ABS(dy);
+	int ax = ABS(dx);
+	byte mask = 0;
 
+	/* The player grid */
+	if (!dy && !dx) return (VIEW_OCT_ALL);
 
+	/* South and north strips */
+	if (ay >= ax)
+	{
+		if (dy > 0)
+		{
+			if (dx >= 0) mask |= VIEW_BIT(VIEW_OCT_SE);
+			if (dx <= 0) mask |= VIEW_BIT(VIEW_OCT_SW);
+		}
+		else
+		{
+			if (dx >= 0) mask |= VIEW_BIT(VIEW_OCT_NE);
+			if (dx <= 0) mask |= VIEW_BIT(VIEW_OCT_NW);
+		}
+	}
 
+	/* East and west strips */
+	if (ax >= ay)
+	{
+		if (dx > 0)
+		{
+			if (dy >= 0) mask |= VIEW_BIT(VIEW_OCT_ES);
+			if (dy <= 0) mask |= VIEW_BIT(VIEW_OCT_EN);
+		}
+		else
+		{
+			if (dy >= 0) mask |= VIEW_BIT(VIEW_OCT_WS);
+			if (dy <= 0) mask |= VIEW_BIT(VIEW_OCT_WN);
+		}
+	}
 
-/*
- * Hack -- provide some "speed" for the "flow" code
- * This entry is the "current index" for the "when" field
- * Note that a "when" value of "zero" means "not used".
- *
- * Note that the "cost" indexes from 1 to 127 are for
- * "old" data, and from 128 to 255 are for "new" data.
- *
- * This means that as long as the player does not "teleport",
- * then any monster up to 128 + MONSTER_FLOW_DEPTH will be
- * able to track down the player, and in general, will be
- * able to track down either the player or a position recently
- * occupied by the player.
- */
-/*static int flow_n = 0;*/
+	return (mask);
+}
 
 
 /*
- * Hack -- forget the "flow" information
+ * A grid has changed, update one player as needed (see "spot_updates()")
+ *
+ * A changed wall or door only matters to the octants of the view around
+ * it, so instead of "PU_VIEW" the player gets "PU_VIEW_OCT" and a note
+ * of which octants to recalculate.
  */
-void forget_flow(void)
+void player_spot_updates(player_type *p_ptr, int y, int x, u32b updates)
 {
+	/* Feature is not in direct view */
+	if (!player_has_los_bold(p_ptr, y, x)) return;
 
-#ifdef MONSTER_FLOW
+	/* Only some octants */
+	if (updates & PU_VIEW)
+	{
+		p_ptr->view_dirty |= view_octants(p_ptr, y, x);
 
-	int x, y;
+		updates &= ~(PU_VIEW);
+		updates |= PU_VIEW_OCT;
+	}
 
-	/* Nothing to forget */
-	if (!flow_n) return;
+	p_ptr->update |= updates;
+}
 
-	/* Check the entire dungeon */
-	for (y = 0; y < cur_hgt; y++)
-	{
-		for (x = 0; x < cur_wid; x++)
-		{
-			/* Forget the old data */
-			cave[y][x].cost = 0;
-			cave[y][x].when = 0;
-		}
-	}
 
-	/* Start over */
-	flow_n = 0;
 
-#endif
 
-}
 
 
-#ifdef MONSTER_FLOW
+/*
+ * Monster "flow" -- every level with players and monsters keeps a
+ * field of distances (in steps) to the nearest player, computed by
+ * a single breadth-first search seeded from all the players there.
+ *
+ * The field is only recomputed when it is needed (some monster wants
+ * to move) and something changed since: a player moved, entered or
+ * left the level, or a feature was changed through "cave_set_feat()".
+ *
+ * The search stops at MONSTER_FLOW_DEPTH steps, farther grids are
+ * left at FLOW_NONE.
+ */
 
 /*
- * Hack -- Allow us to treat the "seen" array as a queue
+ * Hack -- queue for the breadth-first search
  */
-static int flow_head = 0;
-static int flow_tail = 0;
+static byte flow_y[MAX_HGT * MAX_WID];
+static byte flow_x[MAX_HGT * MAX_WID];
 
 
 /*
- * Take note of a reachable grid.  Assume grid is legal.
+ * Forget the "flow" information of a level
  */
-static void update_flow_aux(int y, int x, int n)
+void forget_flow(int Depth)
 {
-	cave_type *c_ptr;
+	KILL(flow_on_depth[Depth]);
+}
+
 
-	int old_head = flow_head;
+/*
+ * Note that the flow of the player's level must be recomputed
+ */
+void update_flow(player_type *p_ptr)
+{
+	flow_type *flow = flow_on_depth[p_ptr->dun_depth];
 
+	if (flow) flow->dirty = TRUE;
+}
 
-	/* Get the grid */
-	c_ptr = &cave[y][x];
 
-	/* Ignore "pre-stamped" entries */
-	if (c_ptr->when == flow_n) return;
+/*
+ * Determine if a monster can flow through a grid
+ */
+static bool flow_passable(int Depth, int y, int x)
+{
+	byte feat = cave[Depth][y][x].feat;
 
-	/* Ignore "walls" and "rubble" */
-	if (c_ptr->feat >= FEAT_RUBBLE) return;
+	/* Floors, and doors which monsters may open or bash */
+	return (cave_floor_bold(Depth, y, x) ||
+	        (feat >= FEAT_DOOR_HEAD && feat <= FEAT_SECRET));
+}
 
-	/* Save the time-stamp */
-	c_ptr->when = flow_n;
 
-	/* Save the flow cost */
-	c_ptr->cost = n;
+/*
+ * Determine if the players of a level are where the flow was computed for.
+ * Players chased by monsters are the ones "process_monsters()" considers.
+ */
+static bool flow_seeds(flow_type *flow, int Depth, bool store)
+{
+	player_type *p_ptr;
+	int n = 0;
 
-	/* Hack -- limit flow depth */
-	if (n == MONSTER_FLOW_DEPTH) return;
+	for (p_ptr = p_first_on_depth[Depth]; p_ptr; p_ptr = p_ptr->next_on_depth)
+	{
+		if (!p_ptr->alive || p_ptr->death || p_ptr->new_level_flag) continue;
+		if (p_ptr->store_num != -1) continue;
+		if (p_ptr->dm_flags & DM_MONSTER_FRIEND) continue;
 
-	/* Enqueue that entry */
-	temp_y[flow_head] = y;
-	temp_x[flow_head] = x;
+		if (store)
+		{
+			flow->seed_y[n] = p_ptr->py;
+			flow->seed_x[n] = p_ptr->px;
+		}
+		else if (n >= flow->num_seeds || flow->seed_y[n] != p_ptr->py ||
+		         flow->seed_x[n] != p_ptr->px)
+		{
+			return (FALSE);
+		}
+		n++;
+	}
 
-	/* Advance the queue */
-	if (++flow_head == TEMP_MAX) flow_head = 0;
+	if (store) flow->num_seeds = n;
 
-	/* Hack -- notice overflow by forgetting new entry */
-	if (flow_head == flow_tail) flow_head = old_head;
+	return (n == flow->num_seeds);
 }
 
-#endif
-
 
 /*
- * Hack -- fill in the "cost" field of every grid that the player
- * can "reach" with the number of steps needed to reach that grid.
- * This also yields the "distance" of the player from every grid.
+ * Get the "flow" information of a level, recomputing it if needed.
  *
- * In addition, mark the "when" of the grids that can reach
- * the player with the incremented value of "flow_n".
- *
- * Hack -- use the "seen" array as a "circular queue".
+ * Fill in the "cost" of every grid within MONSTER_FLOW_DEPTH steps of
+ * some player with the number of steps needed to reach that grid.
  *
  * We do not need a priority queue because the cost from grid
  * to grid is always "one" and we process them in order.
  */
-void update_flow(void)
+flow_type *get_flow(int Depth)
 {
+	flow_type *flow = flow_on_depth[Depth];
+	int head, tail, i, d, y, x;
+	byte cost;
 
-#ifdef MONSTER_FLOW
-
-	int x, y, d;
-
-	/* Hack -- disabled */
-	if (!flow_by_sound) return;
-
-	/* Paranoia -- make sure the array is empty */
-	if (temp_n) return;
-
-	/* Cycle the old entries (once per 128 updates) */
-	if (flow_n == 255)
+	/* First time on this level */
+	if (!flow)
 	{
-		/* Rotate the time-stamps */
-		for (y = 0; y < cur_hgt; y++)
-		{
-			for (x = 0; x < cur_wid; x++)
-			{
-				int w = cave[y][x].when;
-				cave[y][x].when = (w > 128) ? (w - 128) : 0;
-			}
-		}
-
-		/* Restart */
-		flow_n = 127;
+		MAKE(flow, flow_type);
+		flow_on_depth[Depth] = flow;
+		flow->dirty = TRUE;
 	}
 
-	/* Start a new flow (never use "zero") */
-	flow_n++;
-
+	/* Nothing changed */
+	if (!flow->dirty && flow_seeds(flow, Depth, FALSE)) return (flow);
 
-	/* Reset the "queue" */
-	flow_head = flow_tail = 0;
+	/* Forget the old data */
+	memset(flow->cost, FLOW_NONE, sizeof(flow->cost));
+	flow->dirty = FALSE;
 
-	/* Add the player's grid to the queue */
-	update_flow_aux(py, px, 0);
+	/* Add every player's grid to the queue */
+	(void)flow_seeds(flow, Depth, TRUE);
+	for (i = head = tail = 0; i < flow->num_seeds; i++)
+	{
+		y = flow->seed_y[i];
+		x = flow->seed_x[i];
+		if (flow->cost[y][x] == 0) continue;
+		flow->cost[y][x] = 0;
+		flow_y[head] = y;
+		flow_x[head] = x;
+		head++;
+	}
 
 	/* Now process the queue */
-	while (flow_head != flow_tail)
+	while (tail != head)
 	{
 		/* Extract the next entry */
-		y = temp_y[flow_tail];
-		x = temp_x[flow_tail];
+		y = flow_y[tail];
+		x = flow_x[tail];
+		tail++;
 
-		/* Forget that entry */
-		if (++flow_tail == TEMP_MAX) flow_tail = 0;
+		/* Hack -- limit flow depth */
+		cost = flow->cost[y][x] + 1;
+		if (cost > MONSTER_FLOW_DEPTH) continue;
 
 		/* Add the "children" */
 		for (d = 0; d < 8; d++)
 		{
-			/* Add that child if "legal" */
-			update_flow_aux(y+ddy_ddd[d], x+ddx_ddd[d], cave[y][x].cost+1);
-		}
-	}
+			int ny = y + ddy_ddd[d];
+			int nx = x + ddx_ddd[d];
 
-	/* Forget the flow info */
-	flow_head = flow_tail = 0;
+			/* Ignore illegal, "pre-stamped" and impassable grids */
+			if (!in_bounds(Depth, ny, nx)) continue;
+			if (flow->cost[ny][nx] != FLOW_NONE) continue;
+			if (!flow_passable(Depth, ny, nx)) continue;
 
-#endif
+			/* Save the flow cost */
+			flow->cost[ny][nx] = cost;
+
+			/* Enqueue that entry */
+			flow_y[head] = ny;
+			flow_x[head] = nx;
+			head++;
+		}
+	}
 
+	return (flow);
 }
 
 
@@ -3719,10 +3962,10 @@ void wiz_lite(player_type *p_ptr)
 			if (c_ptr->o_idx)
 			{
 				/* Wasn't seen, schedule list redraw */
-				if (!p_ptr->obj_vis[c_ptr->o_idx]) p_ptr->window |= (PW_ITEMLIST);
+				if (!idx_has(p_ptr->obj_vis, c_ptr->o_idx)) p_ptr->window |= (PW_ITEMLIST);
 
 				/* Memorize */
-				p_ptr->obj_vis[c_ptr->o_idx]= TRUE;
+				idx_on(p_ptr->obj_vis, c_ptr->o_idx);
 			}
 
 			/* Process all non-walls */
@@ -3795,10 +4038,10 @@ void wiz_dark(player_type *p_ptr)
 			if (c_ptr->o_idx)
 			{
 				/* Was known, schedule list redraw */
-				if (p_ptr->obj_vis[c_ptr->o_idx]) p_ptr->window |= (PW_ITEMLIST);
+				if (idx_has(p_ptr->obj_vis, c_ptr->o_idx)) p_ptr->window |= (PW_ITEMLIST);
 
 				/* Forget the object */
-				p_ptr->obj_vis[c_ptr->o_idx] = FALSE;
+				idx_off(p_ptr->obj_vis, c_ptr->o_idx);
 			}
 		}
 	}
@@ -4160,6 +4403,9 @@ void disturb(player_type *p_ptr, int stop_search, int unused_flag)
 		/* Cancel */
 		p_ptr->resting = FALSE;
 
+		/* Time bubble may change */
+		invalidate_time_factors(p_ptr->dun_depth);
+
 		/* Redraw the state (later) */
 		p_ptr->redraw |= (PR_STATE);
 	}
@@ -4170,6 +4416,9 @@ void disturb(player_type *p_ptr, int stop_search, int unused_flag)
 		/* Cancel */
 		p_ptr->running = FALSE;
 
+		/* Time bubble may change */
+		invalidate_time_factors(p_ptr->dun_depth);
+
 		/* Calculate torch radius */
 		p_ptr->update |= (PU_TORCH);
 	}
@@ -769,7 +769,7 @@ void carry(player_type *p_ptr, int pickup, int confirm)
 							q_ptr = Players[i];
 							if (obj_own_p(q_ptr,o_ptr))
 							{
-								okay = p_ptr->play_los[i];
+								okay = idx_has(p_ptr->play_los, i);
 								break;
 							}
 						}
@@ -949,7 +949,7 @@ static void hit_trap(player_type *p_ptr)
 			/* Reduce the number of players on this depth */
 			players_on_depth[p_ptr->dun_depth]--;
 
-			p_ptr->dun_depth++;
+			player_change_depth(p_ptr, p_ptr->dun_depth + 1);
 
 			/* Increase the number of players on this next depth */
 			players_on_depth[p_ptr->dun_depth]++;
@@ -1048,7 +1048,7 @@ static void hit_trap(player_type *p_ptr)
 		{
 			msg_print(p_ptr, "You are enveloped in a cloud of smoke!");
 			sound(p_ptr, MSG_SUM_MONSTER);
-			c_ptr->feat = FEAT_FLOOR;
+			cave_set_feat(Depth, p_ptr->py, p_ptr->px, FEAT_FLOOR);
 			*w_ptr &= ~CAVE_MARK;
 			note_spot_depth(Depth, p_ptr->py, p_ptr->px);
 			everyone_lite_spot(Depth, p_ptr->py, p_ptr->px);
@@ -1224,7 +1224,7 @@ void py_attack_player(player_type *p_ptr, int y, int x)
 	my_strcpy(pvp_name, q_ptr->name, 80);
 
 	/* Track player health */
-	if (p_ptr->play_vis[0 - c_ptr->m_idx]) health_track(p_ptr, c_ptr->m_idx);
+	if (idx_has(p_ptr->play_vis, 0 - c_ptr->m_idx)) health_track(p_ptr, c_ptr->m_idx);
 
 	/* Handle attacker fear */
 	if (p_ptr->afraid)
@@ -1389,10 +1389,10 @@ void py_attack_mon(player_type *p_ptr, int y, int x)
 
 
 	/* Auto-Recall if possible and visible */
-	if (p_ptr->mon_vis[c_ptr->m_idx]) monster_race_track(p_ptr, m_ptr->r_idx);
+	if (idx_has(p_ptr->mon_vis, c_ptr->m_idx)) monster_race_track(p_ptr, m_ptr->r_idx);
 
 	/* Track a new monster */
-	if (p_ptr->mon_vis[c_ptr->m_idx]) health_track(p_ptr, c_ptr->m_idx);
+	if (idx_has(p_ptr->mon_vis, c_ptr->m_idx)) health_track(p_ptr, c_ptr->m_idx);
 
 
 	/* Handle player fear */
@@ -1407,7 +1407,7 @@ void py_attack_mon(player_type *p_ptr, int y, int x)
 
 	if (p_ptr->cp_ptr->flags & CF_BACK_STAB)
 	{
-		if (p_ptr->mon_vis[c_ptr->m_idx])
+		if (idx_has(p_ptr->mon_vis, c_ptr->m_idx))
 		{
 			if (m_ptr->csleep) backstab = TRUE;
 			else if (m_ptr->monfear) stab_fleeing = TRUE;
@@ -1416,7 +1416,7 @@ void py_attack_mon(player_type *p_ptr, int y, int x)
 		
 	
 	/* Disturb the monster */
-	m_ptr->csleep = 0;
+	set_monster_sleep(m_ptr, 0);
 
 
 	/* Access the weapon */
@@ -1438,7 +1438,7 @@ void py_attack_mon(player_type *p_ptr, int y, int x)
 		p_ptr->dealt_blows++;
 
 		/* Test for hit */
-		if (test_hit_norm(chance, r_ptr->ac, p_ptr->mon_vis[c_ptr->m_idx]))
+		if (test_hit_norm(chance, r_ptr->ac, idx_has(p_ptr->mon_vis, c_ptr->m_idx)))
 		{
 			/* Message */
 			if ((!backstab) && (!stab_fleeing))
@@ -1462,7 +1462,7 @@ void py_attack_mon(player_type *p_ptr, int y, int x)
 			if (o_ptr->k_idx)
 			{
 				k = damroll(o_ptr->dd, o_ptr->ds);
-				k = tot_dam_aux(p_ptr, o_ptr, k, m_ptr, p_ptr->mon_vis[c_ptr->m_idx]);
+				k = tot_dam_aux(p_ptr, o_ptr, k, m_ptr, idx_has(p_ptr->mon_vis, c_ptr->m_idx));
 				if (backstab)
 				{
 					backstab = FALSE;
@@ -1504,7 +1504,7 @@ void py_attack_mon(player_type *p_ptr, int y, int x)
 				/* Confuse the monster */
 				if (r_ptr->flags3 & RF3_NO_CONF)
 				{
-					if (p_ptr->mon_vis[c_ptr->m_idx]) l_ptr->flags3 |= RF3_NO_CONF;
+					if (idx_has(p_ptr->mon_vis, c_ptr->m_idx)) l_ptr->flags3 |= RF3_NO_CONF;
 					msg_format(p_ptr, "%^s is unaffected.", m_name);
 				}
 				else if (randint0(100) < r_ptr->level)
@@ -1547,7 +1547,7 @@ void py_attack_mon(player_type *p_ptr, int y, int x)
 
 
 	/* Hack -- delay fear messages */
-	if (fear && p_ptr->mon_vis[c_ptr->m_idx] && !(r_ptr->flags2 & RF2_WANDERER))
+	if (fear && idx_has(p_ptr->mon_vis, c_ptr->m_idx) && !(r_ptr->flags2 & RF2_WANDERER))
 	{
 		/* Sound */
 		sound(p_ptr, MSG_FLEE);
@@ -1723,7 +1723,7 @@ void move_player(player_type *p_ptr, int dir, int do_pickup)
 				players_on_depth[p_ptr->dun_depth] = 0;
 			
 			/* Calculate the new level index */
-			p_ptr->dun_depth = world_index(p_ptr->world_x, p_ptr->world_y);
+			player_change_depth(p_ptr, world_index(p_ptr->world_x, p_ptr->world_y));
 
 			/* update the wilderness map */
 			p_ptr->wild_map[(-p_ptr->dun_depth)/8] |= (1<<((-p_ptr->dun_depth)%8));
@@ -1779,6 +1779,9 @@ void move_player(player_type *p_ptr, int dir, int do_pickup)
 				p_ptr->py = y;
 				p_ptr->px = x;
 
+				/* Time bubble may change */
+				invalidate_time_factors(Depth);
+
 				/* Tell both of them */
 				/* Don't tell people they bumped into the Dungeon Master */
 				if (!is_dm_p(q_ptr))
@@ -1848,6 +1851,9 @@ void move_player(player_type *p_ptr, int dir, int do_pickup)
 			cave[Depth][oldy][oldx].m_idx = c_ptr->m_idx;
 			c_ptr->m_idx = (0 - p_ptr->Ind);
 
+			/* Time bubble may change */
+			invalidate_time_factors(Depth);
+
 			/* Re-show both grids */
 			everyone_lite_spot(Depth, p_ptr->py, p_ptr->px);
 			everyone_lite_spot(Depth, oldy, oldx);
@@ -1985,6 +1991,9 @@ void move_player(player_type *p_ptr, int dir, int do_pickup)
 		cave[Depth][oy][ox].m_idx = 0;
 		cave[Depth][y][x].m_idx = 0 - p_ptr->Ind;
 
+		/* Time bubble may change */
+		invalidate_time_factors(Depth);
+
 
 
 		/* Redraw new spot */
@@ -2494,14 +2503,14 @@ static bool run_test(player_type *p_ptr)
 		if (c_ptr->m_idx > 0)
 		{
 			/* Visible monster */
-			if (p_ptr->mon_vis[c_ptr->m_idx]) return (TRUE);
+			if (idx_has(p_ptr->mon_vis, c_ptr->m_idx)) return (TRUE);
 		}
 
 		/* Visible objects abort running */
 		if (c_ptr->o_idx)
 		{
 			/* Visible object */
-			if (p_ptr->obj_vis[c_ptr->o_idx]) return (TRUE);
+			if (idx_has(p_ptr->obj_vis, c_ptr->o_idx)) return (TRUE);
 		}
 
 		/* Hack -- always stop in water */
@@ -2897,6 +2906,9 @@ void run_step(player_type *p_ptr, int dir)
 		}
 		/* On */
 		p_ptr->running = TRUE;
+
+		/* Time bubble may change */
+		invalidate_time_factors(p_ptr->dun_depth);
 	} else
 #endif
 
@@ -2912,6 +2924,9 @@ void run_step(player_type *p_ptr, int dir)
 		/* We are running */
 		p_ptr->run_request = 0;
 		p_ptr->running = TRUE;
+
+		/* Time bubble may change */
+		invalidate_time_factors(p_ptr->dun_depth);
 	}
 
 	/* Keep running */
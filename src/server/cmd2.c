@@ -93,7 +93,7 @@ void do_cmd_go_up(player_type *p_ptr)
 	players_on_depth[p_ptr->dun_depth]--;
 
 	/* Go up the stairs */
-	p_ptr->dun_depth--;
+	player_change_depth(p_ptr, p_ptr->dun_depth - 1);
 
 	/* And another player has entered this depth */
 	players_on_depth[p_ptr->dun_depth]++;
@@ -197,7 +197,7 @@ void do_cmd_go_down(player_type *p_ptr)
 	players_on_depth[p_ptr->dun_depth]--;
 
 	/* Go down */
-	p_ptr->dun_depth++;
+	player_change_depth(p_ptr, p_ptr->dun_depth + 1);
 
 	/* Another player has entered this depth */
 	players_on_depth[p_ptr->dun_depth]++;
@@ -618,7 +618,6 @@ bool is_valid_foundation(player_type *p_ptr, int x, int y)
 bool create_house_door(player_type *p_ptr, int x, int y)
 {
 	int house, i, lastmatch;
-	cave_type		*c_ptr;
 
 	/* Which house is the given location part of? */
 	lastmatch = 0;
@@ -640,8 +639,7 @@ bool create_house_door(player_type *p_ptr, int x, int y)
 			/* No door, so create one! */
 			houses[house].door_y = y;
 			houses[house].door_x = x;
-			c_ptr = &cave[p_ptr->dun_depth][y][x];
-			c_ptr->feat = FEAT_HOME_HEAD;
+			cave_set_feat(p_ptr->dun_depth, y, x, FEAT_HOME_HEAD);
 			everyone_lite_spot(p_ptr->dun_depth, y, x);
 			msg_print(p_ptr, "You create a door for your house!");
 			return TRUE;
@@ -878,6 +876,10 @@ bool create_house(player_type *p_ptr)
 			everyone_lite_spot(p_ptr->dun_depth, y, x);
 		}
 	}
+
+	/* New walls, forget cached views */
+	view_stamp_on_depth[p_ptr->dun_depth]++;
+
 	return TRUE;
 }
 
@@ -900,7 +902,6 @@ bool set_house_owner(player_type *p_ptr, int house)
  */
 void disown_house(int house)
 {
-	cave_type *c_ptr;
 	int i,j, Depth;
 
 	if (house >= 0 && house < num_houses)
@@ -929,11 +930,8 @@ void disown_house(int house)
 		/* Paranoia! */
 		if (!cave[Depth]) return;
 
-		/* Get requested grid */
-		c_ptr = &cave[Depth][houses[house].door_y][houses[house].door_x];
-
 		/* Close the door */
-		c_ptr->feat = FEAT_HOME_HEAD + houses[house].strength;
+		cave_set_feat(Depth, houses[house].door_y, houses[house].door_x, FEAT_HOME_HEAD + houses[house].strength);
 
 		/* Reshow */
 		everyone_lite_spot(Depth, houses[house].door_y, houses[house].door_x);
@@ -1237,7 +1235,7 @@ static bool do_cmd_open_aux(player_type *p_ptr, int y, int x)
 			}
 
 			/* Open the door */
-			c_ptr->feat = FEAT_HOME_OPEN;
+			cave_set_feat(Depth, y, x, FEAT_HOME_OPEN);
 
 			/* Notice */
 			note_spot_depth(Depth, y, x);
@@ -1344,8 +1342,7 @@ static bool do_cmd_open_aux(player_type *p_ptr, int y, int x)
 	else
 	{
 		/* Open the door */
-		/*cave_set_feat(y, x, FEAT_OPEN);*/
-		c_ptr->feat = FEAT_OPEN;
+		cave_set_feat(Depth, y, x, FEAT_OPEN);
 
 		/* Notice */
 		note_spot_depth(Depth, y, x);
@@ -1587,7 +1584,7 @@ static bool do_cmd_close_aux(player_type *p_ptr, int y, int x)
 		i = pick_house(Depth, y, x);
 
 		/* Close the door */
-		c_ptr->feat = FEAT_HOME_HEAD + houses[i].strength;
+		cave_set_feat(Depth, y, x, FEAT_HOME_HEAD + houses[i].strength);
 
 		/* Notice */
 		note_spot_depth(Depth, y, x);
@@ -1603,7 +1600,7 @@ static bool do_cmd_close_aux(player_type *p_ptr, int y, int x)
 	else
 	{
 		/* Close the door */
-		c_ptr->feat = FEAT_DOOR_HEAD + 0x00;
+		cave_set_feat(Depth, y, x, FEAT_DOOR_HEAD + 0x00);
 
 		/* Notice */
 		note_spot_depth(Depth, y, x);
@@ -2225,8 +2222,7 @@ static bool do_cmd_disarm_aux(player_type *p_ptr, int y, int x, int dir)
 		everyone_forget_spot(Depth, y, x);
 
 		/* Remove the trap */
-		/* cave_set_feat(Depth, y, x, FEAT_FLOOR); */
-		c_ptr->feat = FEAT_FLOOR;
+		cave_set_feat(Depth, y, x, FEAT_FLOOR);
 
 		/* Notice */
 		note_spot_depth(Depth, y, x);
@@ -2498,13 +2494,13 @@ static bool do_cmd_bash_aux(player_type *p_ptr, int y, int x)
 		/* Break down the door */
 		if (randint0(100) < 50)
 		{
-			c_ptr->feat = FEAT_BROKEN;
+			cave_set_feat(Depth, y, x, FEAT_BROKEN);
 		}
 
 		/* Open the door */
 		else
 		{
-			c_ptr->feat = FEAT_OPEN;
+			cave_set_feat(Depth, y, x, FEAT_OPEN);
 		}
 
 		/* Notice */
@@ -3146,6 +3142,9 @@ int do_cmd_run(player_type *p_ptr, int dir)
 		p_ptr->run_request = dir;
 		p_ptr->running = FALSE;
 		p_ptr->ran_tiles = 0;
+
+		/* Time bubble may change */
+		invalidate_time_factors(p_ptr->dun_depth);
 	}
 	return 1;
 }
@@ -3269,6 +3268,9 @@ void do_cmd_toggle_rest(player_type *p_ptr)
 	/* Make sure we aren't running */
 	p_ptr->running = FALSE;
 
+	/* Time bubble may change */
+	invalidate_time_factors(p_ptr->dun_depth);
+
 	/* Take a lot of energy to enter "rest mode" */
 	p_ptr->energy -= (level_speed(p_ptr->dun_depth));
 
@@ -3752,7 +3754,7 @@ void do_cmd_fire(player_type *p_ptr, int item, int dir)
 			}
 
 			/* Check the visibility */
-			visible = p_ptr->play_vis[0 - c_ptr->m_idx];
+			visible = idx_has(p_ptr->play_vis, 0 - c_ptr->m_idx);
 
 			/* Note the collision */
 			hit_body = TRUE;
@@ -3813,7 +3815,7 @@ void do_cmd_fire(player_type *p_ptr, int item, int dir)
 			monster_race *r_ptr = &r_info[m_ptr->r_idx];
 
 			/* Check the visibility */
-			visible = p_ptr->mon_vis[c_ptr->m_idx];
+			visible = idx_has(p_ptr->mon_vis, c_ptr->m_idx);
 
 			/* Note the collision */
 			hit_body = TRUE;
@@ -3863,7 +3865,7 @@ void do_cmd_fire(player_type *p_ptr, int item, int dir)
 				}
 
 				/* Apply special damage XXX XXX XXX */
-				tdam = tot_dam_aux(p_ptr, o_ptr, tdam, m_ptr, p_ptr->mon_vis[c_ptr->m_idx]);
+				tdam = tot_dam_aux(p_ptr, o_ptr, tdam, m_ptr, idx_has(p_ptr->mon_vis, c_ptr->m_idx));
 				tdam = critical_shot(p_ptr, o_ptr->weight, o_ptr->to_h, tdam);
 
 				/* No negative damage */
@@ -4188,7 +4190,7 @@ void do_cmd_throw(player_type *p_ptr, int item, int dir)
 			q_ptr = Players[0 - c_ptr->m_idx];
 
 			/* Check the visibility */
-			visible = p_ptr->play_vis[0 - c_ptr->m_idx];
+			visible = idx_has(p_ptr->play_vis, 0 - c_ptr->m_idx);
 
 			/* Note the collision */
 			hit_body = TRUE;
@@ -4259,7 +4261,7 @@ void do_cmd_throw(player_type *p_ptr, int item, int dir)
 			monster_race *r_ptr = &r_info[m_ptr->r_idx];
 
 			/* Check the visibility */
-			visible = p_ptr->mon_vis[c_ptr->m_idx];
+			visible = idx_has(p_ptr->mon_vis, c_ptr->m_idx);
 
 			/* Note the collision */
 			hit_body = TRUE;
@@ -4309,7 +4311,7 @@ void do_cmd_throw(player_type *p_ptr, int item, int dir)
 				}
 
 				/* Apply special damage XXX XXX XXX */
-				tdam = tot_dam_aux(p_ptr, o_ptr, tdam, m_ptr, p_ptr->mon_vis[c_ptr->m_idx]);
+				tdam = tot_dam_aux(p_ptr, o_ptr, tdam, m_ptr, idx_has(p_ptr->mon_vis, c_ptr->m_idx));
 				tdam = critical_shot(p_ptr, o_ptr->weight, o_ptr->to_h, tdam);
 
 				/* No negative damage */
@@ -4380,7 +4382,6 @@ void do_cmd_purchase_house(player_type *p_ptr, int dir)
 	int Depth = p_ptr->dun_depth;
 
 	int y, x, i, factor, price;
-	cave_type *c_ptr;
 
 	/* Check preventive inscription '^h' */
 	__trap(p_ptr, CPI(p_ptr, 'h'));
@@ -4409,9 +4410,6 @@ void do_cmd_purchase_house(player_type *p_ptr, int dir)
 				return;
 			}
 
-			/* Get requested grid */
-			c_ptr = &cave[Depth][houses[i].door_y][houses[i].door_x];
-
 			/* Take player's CHR into account */
 			factor = adj_chr_gold[p_ptr->stat_ind[A_CHR]];
 			price = (unsigned long) houses[i].price * factor / 100;
@@ -4449,9 +4447,6 @@ void do_cmd_purchase_house(player_type *p_ptr, int dir)
 		y = p_ptr->py + ddy[dir];
 		x = p_ptr->px + ddx[dir];
 
-		/* Get requested grid */
-		c_ptr = &cave[Depth][y][x];
-
 		/* Check for a house */
 		if ((i = pick_house(Depth, y, x)) == -1)
 		{
@@ -4527,7 +4522,7 @@ void do_cmd_purchase_house(player_type *p_ptr, int dir)
 		}
 
 		/* Open the door */
-		c_ptr->feat = FEAT_HOME_OPEN;
+		cave_set_feat(Depth, y, x, FEAT_HOME_OPEN);
 
 		/* Reshow */
 		everyone_lite_spot(Depth, y, x);
@@ -238,14 +238,117 @@ static void console_conn(connection_type* ct, char *useless)
 
 	for (iter = first_connection; iter; iter = iter->next)
 	{
-		char buf[80];
+		char buf[160];
 		connection_type* c_ptr = iter->data2; 
 		j++;
-		sprintf(buf, "Connection %d - %s\n", j, c_ptr->host_addr);
+		sprintf(buf, "Connection %d - %s (out: %d, peak: %d/%d%s)\n", j, c_ptr->host_addr,
+			cq_len(&c_ptr->wbuf), c_ptr->wpeak, c_ptr->wbuf.max,
+			CONN_CONGESTED(c_ptr) ? ", congested" : "");
 		cq_printf(&ct->wbuf, "%T", buf);
 	}
 }
 
+/*
+ * Show autosave timings, or autosave right away
+ */
+static void console_autosave(connection_type* ct, char *when)
+{
+	if (when && !my_stricmp(when, "NOW"))
+	{
+		autosave_game();
+		autosave_wait();
+	}
+	cq_printf(&ct->wbuf, "%T", autosave_status());
+}
+
+/*
+ * Show random artifact cache statistics
+ */
+static void console_randarts(connection_type* ct, char *useless)
+{
+	cq_printf(&ct->wbuf, "%T", randart_cache_status());
+}
+
+/*
+ * Show per-player memory use
+ */
+static void console_memory(connection_type* ct, char *useless)
+{
+	int k;
+	long total = 0;
+
+	cq_printf(&ct->wbuf, "%T", format("player_type is %ld bytes\n", (long)sizeof(player_type)));
+
+	for (k = 1; k <= NumPlayers; k++)
+	{
+		player_type *p_ptr = Players[k];
+		long text = (long)(p_ptr->info_rows + p_ptr->file_rows)
+			* MAX_WID * sizeof(cave_view_type)
+			+ (long)((p_ptr->sent_monlist.rows ? 1 : 0) + (p_ptr->sent_itemlist.rows ? 1 : 0))
+			* SENT_TEXT_HGT * SENT_TEXT_WID * sizeof(cave_view_type);
+		long det = (long)p_ptr->mon_det_max * sizeof(mon_det_type);
+
+		total += sizeof(player_type) + text + det;
+		cq_printf(&ct->wbuf, "%T", format("%s: %d text rows (%ld bytes), %d/%d detections (%ld bytes)\n",
+			p_ptr->name, p_ptr->info_rows, text, p_ptr->mon_det_num, p_ptr->mon_det_max, det));
+	}
+
+	cq_printf(&ct->wbuf, "%T", format("%d players, %ld bytes\n", NumPlayers, total));
+	cq_printf(&ct->wbuf, "%T", level_pool_status());
+}
+
+/*
+ * Show how long the phases of a game turn take, or reset the numbers,
+ * or start/stop writing them to a CSV file
+ */
+static void console_stats(connection_type* ct, char *params)
+{
+	micro p50, p99, max, peak;
+	int i, n = 0;
+	char *arg = NULL;
+
+	/* Split the argument */
+	if (params && (arg = strchr(params, ' ')))
+	{
+		*arg++ = '\0';
+		while (*arg == ' ') arg++;
+	}
+
+	if (params && !my_stricmp(params, "RESET"))
+	{
+		tick_stats_reset();
+		cq_printf(&ct->wbuf, "%T", "Tick statistics reset\n");
+		return;
+	}
+	if (params && !my_stricmp(params, "TRACE"))
+	{
+		if (!tick_trace_open(arg))
+			cq_printf(&ct->wbuf, "%T", format("Cannot write %s\n", arg));
+		else if (arg && arg[0])
+			cq_printf(&ct->wbuf, "%T", format("Tracing turns to %s\n", arg));
+		else
+			cq_printf(&ct->wbuf, "%T", "Tracing stopped\n");
+		return;
+	}
+
+	cq_printf(&ct->wbuf, "%T", format("%-9s %8s %8s %8s %8s  (usec)\n", "phase", "p50", "p99", "max", "peak"));
+	for (i = 0; i < TICK_MAX; i++)
+	{
+		n = tick_stats(i, &p50, &p99, &max, &peak);
+		cq_printf(&ct->wbuf, "%T", format("%-9s %8ld %8ld %8ld %8ld\n", tick_phase_names[i],
+			(long)p50, (long)p99, (long)max, (long)peak));
+	}
+
+	cq_printf(&ct->wbuf, "%T", format("Last %d of %lu turns, %lu over %ld usec, %lu catching up\n",
+		n, (unsigned long)tick_count, (unsigned long)tick_overruns, 1000000L / cfg_fps,
+		(unsigned long)tick_catchups));
+	cq_printf(&ct->wbuf, "%T", format("%lu view updates (%lu partial, %lu shared), %lu grids\n",
+		(unsigned long)view_updates, (unsigned long)view_partial,
+		(unsigned long)view_shared, (unsigned long)view_grids));
+	if (tick_trace_file())
+		cq_printf(&ct->wbuf, "%T", format("Tracing turns to %s\n", tick_trace_file()));
+}
+
 /*
  * Utility function, change locally as required when testing
  */
@@ -441,7 +544,219 @@ static void console_rng_test(connection_type* ct, char *useless)
 }
 
 /*
- * Allocate each dungeon level N times.
+ * Time hot packets packed via format strings against the
+ * compiled packet schemas (see "net-pack.h").
+ *
+ * Note: this function uses up the static_timer(4).
+ */
+static void console_pack_test(connection_type* ct, char *useless)
+{
+	const int reps = 1000000;
+	cave_view_type line[80];
+	cptr msg = "You have no more Scrolls of Word of Recall.";
+	micro t_old, t_new;
+	char old_bytes[128];
+	int old_len, old_peek;
+	cq tmp;
+	int i, k;
+
+	cq_init(&tmp, PD_LARGE_BUFFER);
+
+	/* Something for the RLE to chew on */
+	for (i = 0; i < 80; i++)
+	{
+		line[i].a = (i < 40 ? TERM_WHITE : i % 16);
+		line[i].c = (i < 40 ? '#' : 'a' + i % 26);
+	}
+
+	cq_printf(&ct->wbuf, "%T", format("Packing each packet %d times...\n", reps));
+
+	for (k = 0; k < 3; k++)
+	{
+		cptr name = "";
+
+		/* Format strings */
+		cq_clear(&tmp);
+		static_timer(4);
+		for (i = 0; i < reps; i++)
+		{
+			if (cq_space(&tmp) < 256) cq_clear(&tmp);
+			switch (k)
+			{
+				case 0: cq_printf(&tmp, "%c%ud%c%c", PKT_CHAR, (i & 0x7FFF) | 0x8000, TERM_WHITE, '@'); break;
+				case 1: cq_printf(&tmp, "%c%ud", PKT_CHAR, i & 0x7FFF);
+				        cq_printc(&tmp, RLE_CLASSIC, line, 80); break;
+				case 2: cq_printf(&tmp, "%c%ud%S", PKT_MESSAGE, MSG_GENERIC, msg); break;
+			}
+		}
+		t_old = static_timer(4);
+
+		/* Remember what we produced */
+		old_len = cq_len(&tmp);
+		old_peek = MIN(old_len, (int)sizeof(old_bytes));
+		memcpy(old_bytes, CQ_PEEK(&tmp), old_peek);
+
+		/* Schemas */
+		cq_clear(&tmp);
+		static_timer(4);
+		for (i = 0; i < reps; i++)
+		{
+			if (cq_space(&tmp) < 256) cq_clear(&tmp);
+			switch (k)
+			{
+				case 0: cq_pack_stream_char(&tmp, PKT_CHAR, (i & 0x7FFF) | 0x8000, TERM_WHITE, '@');
+				        name = "tile"; break;
+				case 1: cq_pack_stream_line(&tmp, PKT_CHAR, i & 0x7FFF);
+				        cq_printc(&tmp, RLE_CLASSIC, line, 80);
+				        name = "stream line"; break;
+				case 2: cq_pack_message(&tmp, PKT_MESSAGE, MSG_GENERIC, msg);
+				        name = "message"; break;
+			}
+		}
+		t_new = static_timer(4);
+
+		cq_printf(&ct->wbuf, "%T", format("%-12s cq_printf: %6ld ms, schema: %6ld ms%s\n",
+			name, t_old / 1000, t_new / 1000,
+			(old_len == cq_len(&tmp) && !memcmp(old_bytes, CQ_PEEK(&tmp), old_peek)) ? "" : " (OUTPUT MISMATCH!)"));
+	}
+
+	cq_free(&tmp);
+}
+
+/*
+ * Check and time the cave RLE encoders.
+ *
+ * First, random rows are encoded and decoded with every method and
+ * compared to the original, and "cv_run()" is compared to the plain
+ * "cv_run_scalar()" everywhere. Then, rows of every level currently
+ * in memory are used to time run detection and full encoding.
+ *
+ * Note: this function uses up the static_timer(4).
+ */
+static void console_rle_test(connection_type* ct, char *useless)
+{
+	const int fuzz_reps = 20000;
+	const int bench_reps = 200;
+	u32b seed = 0xDEADDEAD;
+	cave_view_type row[MAX_WID], out[MAX_WID];
+	cave_view_type *rows;
+	int num_rows = 0, max_rows = 4096;
+	int errors = 0;
+	int i, j, k, mode, len, Depth, y, x;
+	micro t_scalar, t_vector, t_encode;
+	long runs = 0;
+	cq tmp;
+
+#define RLE_TEST_RAND(M) ((seed = seed * 1103515245UL + 12345UL), (int)((seed >> 16) % (M)))
+
+	cq_init(&tmp, PD_LARGE_BUFFER);
+
+	/* Round-trip random rows */
+	for (i = 0; i < fuzz_reps; i++)
+	{
+		len = 1 + RLE_TEST_RAND(MAX_WID);
+
+		/* Runs of random length, from a small palette, to get repeats */
+		for (x = 0; x < len; )
+		{
+			byte a = RLE_TEST_RAND(16);
+			char c = " .#@ag"[RLE_TEST_RAND(6)];
+			int n = 1 + (RLE_TEST_RAND(4) ? RLE_TEST_RAND(3) : RLE_TEST_RAND(40));
+			for (; n-- && x < len; x++)
+			{
+				row[x].a = a;
+				/* Same color, but maybe a different char (for RLE_COLOR) */
+				row[x].c = (RLE_TEST_RAND(4) ? c : 'x');
+			}
+		}
+
+		for (x = 0; x < len; x++)
+		{
+			if (cv_run(&row[x], len - x, FALSE) != cv_run_scalar(&row[x], len - x, FALSE)) errors++;
+			if (cv_run(&row[x], len - x, TRUE) != cv_run_scalar(&row[x], len - x, TRUE)) errors++;
+		}
+
+		for (mode = RLE_NONE; mode <= RLE_COLOR; mode++)
+		{
+			cq_clear(&tmp);
+			WIPE(out, out);
+			if (cq_printc(&tmp, mode, row, len) <= 0
+			 || cq_scanc(&tmp, mode, out, len) != len
+			 || cq_len(&tmp) != 0
+			 || memcmp(row, out, len * sizeof(cave_view_type)))
+			{
+				errors++;
+			}
+		}
+	}
+	cq_printf(&ct->wbuf, "%T", format("Round-tripped %d random rows, %d errors\n", fuzz_reps, errors));
+
+	/* Collect rows from real levels */
+	C_MAKE(rows, max_rows * MAX_WID, cave_view_type);
+	for (Depth = -MAX_WILD + 1; Depth < MAX_DEPTH && num_rows < max_rows; Depth++)
+	{
+		if (!cave[Depth]) continue;
+		for (y = 0; y < MAX_HGT && num_rows < max_rows; y++)
+		{
+			cave_view_type *dst = &rows[num_rows++ * MAX_WID];
+			for (x = 0; x < MAX_WID; x++)
+			{
+				cave_type *c_ptr = &cave[Depth][y][x];
+				dst[x].a = f_info[c_ptr->feat].d_attr;
+				dst[x].c = f_info[c_ptr->feat].d_char;
+				if (c_ptr->m_idx > 0)
+				{
+					monster_race *r_ptr = &r_info[m_list[c_ptr->m_idx].r_idx];
+					dst[x].a = r_ptr->d_attr;
+					dst[x].c = r_ptr->d_char;
+				}
+				/* Keep RLE_CLASSIC happy */
+				dst[x].a &= 0x3F;
+			}
+		}
+	}
+	if (!num_rows)
+	{
+		cq_printf(&ct->wbuf, "%T", "No levels in memory to benchmark on\n");
+		KILL(rows);
+		cq_free(&tmp);
+		return;
+	}
+
+	/* Time run detection */
+	static_timer(4);
+	for (k = 0; k < bench_reps; k++)
+		for (j = 0; j < num_rows; j++)
+			for (x = 0; x < MAX_WID; x += cv_run_scalar(&rows[j * MAX_WID + x], MAX_WID - x, FALSE)) runs++;
+	t_scalar = static_timer(4);
+	for (k = 0; k < bench_reps; k++)
+		for (j = 0; j < num_rows; j++)
+			for (x = 0; x < MAX_WID; x += cv_run(&rows[j * MAX_WID + x], MAX_WID - x, FALSE)) runs--;
+	t_vector = static_timer(4);
+
+	/* Time full encoding */
+	for (k = 0; k < bench_reps; k++)
+	{
+		for (j = 0; j < num_rows; j++)
+		{
+			if (cq_space(&tmp) < MAX_WID * 2) cq_clear(&tmp);
+			cq_printc(&tmp, RLE_CLASSIC, &rows[j * MAX_WID], MAX_WID);
+		}
+	}
+	t_encode = static_timer(4);
+
+	cq_printf(&ct->wbuf, "%T", format("%d rows x %d: runs scalar %ld ms, vector %ld ms%s; RLE_CLASSIC encode %ld ms\n",
+		num_rows, bench_reps, t_scalar / 1000, t_vector / 1000, (runs ? " (MISMATCH!)" : ""), t_encode / 1000));
+
+#undef RLE_TEST_RAND
+	KILL(rows);
+	cq_free(&tmp);
+}
+
+/*
+ * Allocate each dungeon level N times, and report how long it took.
+ *
+ * Note: this function uses up the static_timer(4).
  */
 static void console_dng_test(connection_type* ct, char *params)
 {
@@ -450,6 +765,7 @@ static void console_dng_test(connection_type* ct, char *params)
 	int max_depth = 127;
 	int Depth, i;
 	u32b old_mode;
+	micro t_total = 0, t_depth;
 
 	char *param1 = strtok(params, " ");
 	char *param2 = strtok(NULL, " ");
@@ -473,6 +789,7 @@ static void console_dng_test(connection_type* ct, char *params)
 	for (Depth = min_depth; Depth < max_depth+1; Depth++)
 	{
 		cheat(format("DLevel %d (%d feet), %d iterations:", Depth, Depth*50, rep));
+		static_timer(4);
 		for (i = 0; i < rep; i++)
 		{
 			/* Allocate space for it */
@@ -481,6 +798,9 @@ static void console_dng_test(connection_type* ct, char *params)
 			/* Generate a dungeon level there */
 			generate_cave(0, Depth, TRUE);
 		}
+		t_depth = static_timer(4);
+		t_total += t_depth;
+		if (rep) cheat(format("DLevel %d: %ld usec per level", Depth, (long)(t_depth / rep)));
 		/* XXX -- should we call compact from time to time? */
 	}
 
@@ -488,7 +808,251 @@ static void console_dng_test(connection_type* ct, char *params)
 	channels[chan_cheat].mode = old_mode;
 
 	/* Notify */
-	cq_printf(&ct->wbuf, "%T", "Done\n");
+	i = rep * (max_depth - min_depth + 1);
+	cq_printf(&ct->wbuf, "%T", format("Done, %d levels in %ld msec (%ld usec per level)\n",
+		i, (long)(t_total / 1000), (long)(i ? t_total / i : 0)));
+}
+
+#define VIEW_TEST_PARTY 16
+
+/*
+ * Replay one recorded walk for "console_view_test()", with a party of
+ * "num" players following the leader in single file.  The party moves
+ * on the steps marked in "moved[]", and waits on the others.  With
+ * "full", every view is recalculated from scratch, like it used to be.
+ *
+ * The views each player ends up with are summed into "sum[]", so the
+ * two replays can be compared step by step.
+ */
+static void view_test_replay(int Depth, int steps, int num, bool full, byte *moved,
+	byte *trace_y, byte *trace_x, byte *event_y, byte *event_x, byte *event_feat, u32b *sum)
+{
+	player_type *party[VIEW_TEST_PARTY];
+	int i, j, n, k, m = 0;
+
+	/* Line up behind the leader */
+	for (j = 0; j < num; j++)
+	{
+		player_type *p_ptr = party[j] = player_alloc();
+
+		p_ptr->conn = -1;
+		p_ptr->dun_depth = Depth;
+		p_ptr->cur_hgt = MAX_HGT;
+		p_ptr->cur_wid = MAX_WID;
+
+		/* Hack -- nothing is ever on screen */
+		p_ptr->panel_row_min = MAX_HGT;
+		p_ptr->panel_col_min = MAX_WID;
+	}
+
+	for (i = 0; i < steps; i++)
+	{
+		if (moved[i]) m++;
+
+		/* Toggle a wall */
+		if (event_feat[i])
+		{
+			cave_type *c_ptr = &cave[Depth][event_y[i]][event_x[i]];
+			cave_set_feat(Depth, event_y[i], event_x[i],
+				(c_ptr->feat == FEAT_FLOOR) ? FEAT_RUBBLE : FEAT_FLOOR);
+
+			for (j = 0; j < num; j++)
+				player_spot_updates(party[j], event_y[i], event_x[i], PU_VIEW);
+		}
+
+		sum[i] = 0;
+		for (j = 0; j < num; j++)
+		{
+			player_type *p_ptr = party[j];
+			k = MAX(m - j, 0);
+
+			/* Step */
+			if (p_ptr->py != trace_y[k] || p_ptr->px != trace_x[k] || !p_ptr->view_n)
+			{
+				p_ptr->py = trace_y[k];
+				p_ptr->px = trace_x[k];
+				p_ptr->update |= PU_VIEW;
+			}
+
+			/* Old way */
+			if (full && (p_ptr->update & (PU_VIEW | PU_VIEW_OCT)))
+			{
+				p_ptr->update |= PU_VIEW;
+				view_stamp_on_depth[Depth]++;
+			}
+
+			/* As in "update_stuff()" */
+			if (p_ptr->update & PU_VIEW)
+			{
+				p_ptr->update &= ~(PU_VIEW | PU_VIEW_OCT);
+				p_ptr->view_dirty = 0;
+				update_view(p_ptr);
+			}
+			if (p_ptr->update & PU_VIEW_OCT)
+			{
+				p_ptr->update &= ~(PU_VIEW_OCT);
+				update_view(p_ptr);
+			}
+
+			/* Sum up the view, in any order */
+			for (n = 0; n < p_ptr->view_n; n++)
+			{
+				sum[i] += (p_ptr->view_y[n] * MAX_WID + p_ptr->view_x[n] + 1) * 2654435761UL;
+			}
+		}
+	}
+
+	/* Leave */
+	for (j = 0; j < num; j++)
+	{
+		forget_view(party[j]);
+		player_free(party[j]);
+	}
+
+	/* Put the walls back */
+	for (i = steps - 1; i >= 0; i--)
+	{
+		if (event_feat[i]) cave[Depth][event_y[i]][event_x[i]].feat = event_feat[i];
+	}
+	view_stamp_on_depth[Depth]++;
+}
+
+/*
+ * Record a walk through a fresh level, and replay it with the old and
+ * the incremental field of view code.  Every few steps, a grid near the
+ * leader turns into rubble or back.  Reports grids evaluated per view
+ * update, and checks that both replays saw exactly the same.
+ *
+ * Note: this function uses up the static_timer(4).
+ */
+static void console_view_test(connection_type* ct, char *params)
+{
+	int steps = 2000;
+	int num = 4;
+	int Depth = 10;
+	int i, k, m, d, y, x, tries;
+	int events = 0;
+	byte *moved, *trace_y, *trace_x, *event_y, *event_x, *event_feat;
+	u32b *sum_full, *sum_incr;
+	u32b updates, grids, partial, shared;
+	micro t_full, t_incr;
+
+	char *param1 = params ? strtok(params, " ") : NULL;
+	char *param2 = param1 ? strtok(NULL, " ") : NULL;
+	char *param3 = param2 ? strtok(NULL, " ") : NULL;
+	if (param1) steps = MAX(atoi(param1), 1);
+	if (param2) num = MAX(MIN(atoi(param2), VIEW_TEST_PARTY), 1);
+	if (param3) Depth = MAX(MIN(atoi(param3), MAX_DEPTH - 1), 1);
+
+	/* Notify */
+	if (NumPlayers > 0)
+	{
+		cq_printf(&ct->wbuf, "%T", "Can't perform viewtest with players online!\n");
+		return;
+	}
+
+	/* Make a level */
+	if (!cave[Depth]) alloc_dungeon_level(Depth);
+	generate_cave(0, Depth, TRUE);
+
+	C_MAKE(moved, steps, byte);
+	C_MAKE(trace_y, steps + 1, byte);
+	C_MAKE(trace_x, steps + 1, byte);
+	C_MAKE(event_y, steps, byte);
+	C_MAKE(event_x, steps, byte);
+	C_MAKE(event_feat, steps, byte);
+	C_MAKE(sum_full, steps, u32b);
+	C_MAKE(sum_incr, steps, u32b);
+
+	/* Start somewhere open */
+	for (tries = 0; tries < 10000; tries++)
+	{
+		y = rand_range(1, MAX_HGT - 2);
+		x = rand_range(1, MAX_WID - 2);
+		if (cave[Depth][y][x].feat == FEAT_FLOOR) break;
+	}
+
+	trace_y[0] = y;
+	trace_x[0] = x;
+
+	/* Record a walk, mostly straight ahead, with a few breaks */
+	d = 1 + rand_int(9);
+	for (k = m = 0; k < steps; k++)
+	{
+		for (tries = 0; tries < 20 && !one_in_(3); tries++)
+		{
+			if (d == 5 || tries || one_in_(8)) d = 1 + rand_int(9);
+			if (d == 5) continue;
+			if (!cave_floor_bold(Depth, y + ddy[d], x + ddx[d])) continue;
+
+			y += ddy[d];
+			x += ddx[d];
+			m++;
+			trace_y[m] = y;
+			trace_x[m] = x;
+			moved[k] = TRUE;
+			break;
+		}
+
+		/* Sometimes, pick a floor grid nearby (but off the path) to toggle */
+		if (one_in_(6))
+		{
+			int ty = y + rand_range(-8, 8);
+			int tx = x + rand_range(-8, 8);
+
+			if (!in_bounds(Depth, ty, tx) || distance(y, x, ty, tx) < 2) continue;
+			if (cave[Depth][ty][tx].feat != FEAT_FLOOR) continue;
+			for (i = MAX(m - num, 0); i <= m; i++)
+			{
+				if (trace_y[i] == ty && trace_x[i] == tx) break;
+			}
+			if (i <= m) continue;
+
+			event_y[k] = ty;
+			event_x[k] = tx;
+			event_feat[k] = FEAT_FLOOR;
+			events++;
+		}
+	}
+
+	/* Old way */
+	updates = view_updates; grids = view_grids;
+	static_timer(4);
+	view_test_replay(Depth, steps, num, TRUE, moved, trace_y, trace_x, event_y, event_x, event_feat, sum_full);
+	t_full = static_timer(4);
+	updates = view_updates - updates; grids = view_grids - grids;
+
+	cq_printf(&ct->wbuf, "%T", format("%d steps, %d players, %d wall changes on level %d\n", steps, num, events, Depth));
+	cq_printf(&ct->wbuf, "%T", format("Full:        %ld updates, %ld grids per update, %ld usec per update\n",
+		(long)updates, (long)(grids / MAX(updates, 1)), (long)(t_full / MAX(updates, 1))));
+
+	/* New way */
+	updates = view_updates; grids = view_grids; partial = view_partial; shared = view_shared;
+	static_timer(4);
+	view_test_replay(Depth, steps, num, FALSE, moved, trace_y, trace_x, event_y, event_x, event_feat, sum_incr);
+	t_incr = static_timer(4);
+	updates = view_updates - updates; grids = view_grids - grids;
+	partial = view_partial - partial; shared = view_shared - shared;
+
+	cq_printf(&ct->wbuf, "%T", format("Incremental: %ld updates (%ld partial, %ld shared), %ld grids per update, %ld usec per update\n",
+		(long)updates, (long)partial, (long)shared, (long)(grids / MAX(updates, 1)), (long)(t_incr / MAX(updates, 1))));
+
+	/* Compare */
+	for (k = 0; k < steps; k++)
+	{
+		if (sum_full[k] != sum_incr[k]) break;
+	}
+	if (k < steps) cq_printf(&ct->wbuf, "%T", format("Views DIFFER from step %d!\n", k));
+	else cq_printf(&ct->wbuf, "%T", "Views match\n");
+
+	KILL(moved);
+	KILL(trace_y);
+	KILL(trace_x);
+	KILL(event_y);
+	KILL(event_x);
+	KILL(event_feat);
+	KILL(sum_full);
+	KILL(sum_incr);
 }
 
 static void console_reload(connection_type* ct, char *mod)
@@ -502,6 +1066,13 @@ static void console_reload(connection_type* ct, char *mod)
 
 		done = TRUE;
 	}
+	else if (streq(mod, "randarts"))
+	{
+		/* Forget generated random artifacts */
+		randart_cache_wipe();
+
+		done = TRUE;
+	}
 	else if (streq(mod, "news"))
 	{
 		/* Reload the news file */
@@ -603,12 +1174,19 @@ console_command_ops console_commands[] = {
 	{ "listen",    console_listen,      0, "[CHANNEL]\nAttach self to #public or specified"   },
 	{ "who",       console_who,         0, "\nList players"                                   },
 	{ "conn",      console_conn,        0, "\nList connections"                               },
+	{ "autosave",  console_autosave,    0, "[NOW]\nShow autosave timings, or autosave now"     },
+	{ "randarts",  console_randarts,    0, "\nShow random artifact cache statistics"         },
+	{ "memory",    console_memory,      0, "\nShow per-player and level memory use"          },
+	{ "stats",     console_stats,       0, "[RESET|TRACE [FILE]]\nShow turn timings, reset them, or trace them to FILE" },
 	{ "shutdown",  console_shutdown,    0, "[TIME|NOW]\nKill server in TIME minutes or 'NOW'" },
 	{ "msg",       console_message,     1, "MESSAGE\nBroadcast a message"                     },
 	{ "kick",      console_kick_player, 1, "PLAYERNAME\nKick player from the game"            },
-	{ "reload",    console_reload,      1, "config|news\nReload mangband.cfg or news.txt"     },
+	{ "reload",    console_reload,      1, "config|news|randarts\nReload mangband.cfg, news.txt or randarts" },
 	{ "whois",     console_whois,       1, "PLAYERNAME\nDetailed player information"          },
 	{ "rngtest",   console_rng_test,    0, "\nPerform RNG test"                               },
+	{ "packtest",  console_pack_test,   0, "\nBenchmark packet packing"                       },
+	{ "rletest",   console_rle_test,    0, "\nCheck and benchmark cave RLE encoders"          },
+	{ "viewtest",  console_view_test,   0, "[STEPS] [PLAYERS] [DEPTH]\nReplay a party walk, compare and time view updates" },
 #ifdef DEBUG
 	{ "dngtest",   console_dng_test,    2, "[N] [DEPTH]\nGenerate dungeon N times"            },
 #endif
@@ -51,18 +51,100 @@ int find_player_name(char *name)
 
 int count_players(int Depth)
 {
-	int i, count = 0;
+	player_type *p_ptr;
+	int count = 0;
 
 	/* Count players on this depth */
-	for (i = 1; i <= NumPlayers; i++)
+	for (p_ptr = p_first_on_depth[Depth]; p_ptr; p_ptr = p_ptr->next_on_depth)
 	{
 		/* Count */
-		if (Players[i]->dun_depth == Depth) count++;
+		count++;
 	}
 
 	return count;
 }
 
+/*
+ * Add a player to the list of players on his level.
+ *
+ * Each active player is kept on a doubly-linked list of players sharing
+ * his "dun_depth", starting at "p_first_on_depth[Depth]", similar to
+ * monsters (see "monster_link_depth()"). Players are linked by pointer,
+ * not by index, as player indexes change when someone leaves the game.
+ */
+void player_link_depth(player_type *p_ptr)
+{
+	int Depth = p_ptr->dun_depth;
+
+	/* Already there */
+	if (p_ptr->on_depth_list) return;
+
+	/* Insert at the head */
+	p_ptr->prev_on_depth = NULL;
+	p_ptr->next_on_depth = p_first_on_depth[Depth];
+	if (p_ptr->next_on_depth) p_ptr->next_on_depth->prev_on_depth = p_ptr;
+	p_first_on_depth[Depth] = p_ptr;
+
+	p_ptr->on_depth_list = TRUE;
+
+	/* Time bubble may change */
+	invalidate_time_factors(Depth);
+}
+
+/*
+ * Remove a player from the list of players on his level.
+ */
+void player_unlink_depth(player_type *p_ptr)
+{
+	int Depth = p_ptr->dun_depth;
+
+	/* Not there */
+	if (!p_ptr->on_depth_list) return;
+
+	/* Fix neighbours */
+	if (p_ptr->prev_on_depth) p_ptr->prev_on_depth->next_on_depth = p_ptr->next_on_depth;
+	else p_first_on_depth[Depth] = p_ptr->next_on_depth;
+	if (p_ptr->next_on_depth) p_ptr->next_on_depth->prev_on_depth = p_ptr->prev_on_depth;
+
+	p_ptr->next_on_depth = p_ptr->prev_on_depth = NULL;
+	p_ptr->on_depth_list = FALSE;
+
+	/* Time bubble may change */
+	invalidate_time_factors(Depth);
+}
+
+/*
+ * Move a player to another level, keeping the per-depth lists current.
+ *
+ * Note that "update_mon()" only looks at players on the monster's level,
+ * so we forget every monster on the old level here.
+ */
+void player_change_depth(player_type *p_ptr, int Depth)
+{
+	bool linked = p_ptr->on_depth_list;
+	int m_idx;
+
+	/* Nothing to do */
+	if (p_ptr->dun_depth == Depth) return;
+
+	/* Time bubbles may change on both levels */
+	invalidate_time_factors(p_ptr->dun_depth);
+	invalidate_time_factors(Depth);
+
+	/* Leave old level */
+	player_unlink_depth(p_ptr);
+
+	/* Forget it's monsters */
+	for (m_idx = m_first_on_depth[p_ptr->dun_depth]; m_idx; m_idx = m_list[m_idx].next_on_depth)
+	{
+		forget_monster(p_ptr, m_idx, FALSE);
+	}
+
+	/* Enter new level */
+	p_ptr->dun_depth = Depth;
+	if (linked) player_link_depth(p_ptr);
+}
+
 /*
  * Return a "feeling" (or NULL) about an item.  Method 1 (Heavy).
  */
@@ -434,7 +516,7 @@ static void regen_monsters(void)
 		else
 		{
 			for (frac = 1; frac <= NumPlayers; frac++)
-				Players[frac]->mon_hrt[i] = FALSE;
+				idx_off(Players[frac]->mon_hrt, i);
 		}
 	}
 }
@@ -806,7 +888,7 @@ static int auto_retaliate(player_type *p_ptr)
 			if (c_ptr->m_idx < 0)
 			{
 				/* Skip players we cannot see */
-				if (!p_ptr->play_vis[0 - c_ptr->m_idx]) continue;
+				if (!idx_has(p_ptr->play_vis, 0 - c_ptr->m_idx)) continue;
 
 				/* If they are hostile, they are a fair target */
 				if (pvp_okay(p_ptr, Players[0 - c_ptr->m_idx], 1))
@@ -825,7 +907,7 @@ static int auto_retaliate(player_type *p_ptr)
 			else if(c_ptr->m_idx)
 			{
 				/* Make sure that the player can see this monster */
-				if (!p_ptr->mon_vis[c_ptr->m_idx]) continue;
+				if (!idx_has(p_ptr->mon_vis, c_ptr->m_idx)) continue;
 				
 				targetlist[targets++] = i;
 				if(p_ptr->health_who == c_ptr->m_idx)
@@ -1183,14 +1265,14 @@ static void process_player_end(player_type *p_ptr)
 	if ( !(turn.turn % time) )
 	{
 		/* Hack -- Fade monster Detect over time */
-		for (i = 0; i < m_max; i++)
+		for (i = p_ptr->mon_det_num - 1; i >= 0; i--)
 		{
-			if (p_ptr->mon_det[i])
+			if (--p_ptr->mon_det_list[i].turns == 0)
 			{
-				if (--p_ptr->mon_det[i] == 0) 
-				{
-					update_mon(i, FALSE);
-				}
+				int m_idx = p_ptr->mon_det_list[i].m_idx;
+
+				mon_det_set(p_ptr, m_idx, 0);
+				update_mon(m_idx, FALSE);
 			}
 		}
 		/* Hack -- Fade player Detect over time */
@@ -1710,7 +1792,7 @@ static void process_player_end(player_type *p_ptr)
 				forget_lite(p_ptr);
 				forget_view(p_ptr);
 
-				p_ptr->dun_depth = new_depth;
+				player_change_depth(p_ptr, new_depth);
 				p_ptr->world_x = new_world_x;
 				p_ptr->world_y = new_world_y;
 				/* XXX Hack -- arena paranoia */
@@ -1752,19 +1834,16 @@ static void process_various(void)
 
 	//char buf[1024];
 
-	/* Save the server state occasionally */
+	/* Save the server state and each player occasionally */
 	if (!(turn.turn % (cfg_fps * 60 * SERVER_SAVE)))
 	{
-		save_server_info();
-
-		/* Save each player */
-		for (i = 1; i <= NumPlayers; i++)
-		{
-			/* Save this player */
-			save_player(Players[i]);
-		}
+		/* Snapshot now, write in the background */
+		autosave_game();
 	}
 
+	/* Forget unused inscriptions if running out of them */
+	quark_collect();
+
 	/* Handle certain things once a minute */
 	if (!(turn.turn % (cfg_fps * 60)))
 	{
@@ -1894,7 +1973,7 @@ static void process_various(void)
 			if (c_ptr->o_idx) continue;
 
 			/* Grow a tree here */
-			c_ptr->feat = FEAT_TREE;
+			cave_set_feat(0, y, x, FEAT_TREE);
 			trees_in_town++;
 
 			/* Show it */
@@ -2000,6 +2079,175 @@ static void process_various(void)
 
 
 
+/*
+ * Tick profiler
+ *
+ * Every game turn is split into phases, and the time spent in each one
+ * (by the monotonic clock) is kept for the last TICK_HISTORY turns.
+ * Network I/O and player commands happen in between turns, see
+ * "network_loop()", and are counted towards the turn that follows.
+ */
+cptr tick_phase_names[TICK_MAX] =
+{
+	"levels", "players", "monsters", "objects", "world",
+	"various", "stuff", "network", "commands", "total"
+};
+
+static micro tick_history[TICK_MAX][TICK_HISTORY];
+static micro tick_peak[TICK_MAX];	/* Worst turn since reset */
+static micro tick_span[TICK_MAX];	/* The turn being measured */
+static micro tick_mark;	/* End of the last span */
+static int tick_next;	/* Next slot in the history */
+static int tick_filled;	/* Slots in use */
+
+u32b tick_count;	/* Turns measured */
+u32b tick_overruns;	/* Turns longer than 1/FPS seconds */
+u32b tick_catchups;	/* Turns run late, back to back with another */
+
+static ang_file *tick_trace = NULL;
+static char tick_trace_name[1024];
+
+/*
+ * Start measuring (time since the last span is not counted)
+ */
+void tick_start(void)
+{
+	tick_mark = clock_micro();
+}
+
+/*
+ * Close the current span, and count it towards a phase
+ */
+void tick_phase(int phase)
+{
+	micro now = clock_micro();
+
+	tick_span[phase] += now - tick_mark;
+	tick_mark = now;
+}
+
+/*
+ * The turn is over, remember how long it took
+ */
+void tick_finish(bool late)
+{
+	micro total = 0;
+	int i;
+
+	for (i = 0; i < TICK_TOTAL; i++) total += tick_span[i];
+	tick_span[TICK_TOTAL] = total;
+
+	tick_count++;
+	if (total > 1000000L / cfg_fps) tick_overruns++;
+	if (late) tick_catchups++;
+
+	/* Dump a line of the trace */
+	if (tick_trace)
+	{
+		char buf[256];
+		int len;
+
+		len = strnfmt(buf, sizeof(buf), "%lu,%lu,%d", (unsigned long)tick_count,
+			(unsigned long)turn.turn, late ? 1 : 0);
+		for (i = 0; i < TICK_MAX; i++)
+			len += strnfmt(buf + len, sizeof(buf) - len, ",%ld", (long)tick_span[i]);
+		my_strcat(buf, "\n", sizeof(buf));
+
+		file_put(tick_trace, buf);
+	}
+
+	/* Keep it */
+	for (i = 0; i < TICK_MAX; i++)
+	{
+		tick_history[i][tick_next] = tick_span[i];
+		if (tick_span[i] > tick_peak[i]) tick_peak[i] = tick_span[i];
+		tick_span[i] = 0;
+	}
+	tick_next = (tick_next + 1) % TICK_HISTORY;
+	if (tick_filled < TICK_HISTORY) tick_filled++;
+}
+
+/*
+ * Forget everything measured so far
+ */
+void tick_stats_reset(void)
+{
+	WIPE(tick_peak, tick_peak);
+	tick_next = tick_filled = 0;
+	tick_count = tick_overruns = tick_catchups = 0;
+}
+
+static int tick_cmp(const void *a, const void *b)
+{
+	micro x = *(const micro *)a, y = *(const micro *)b;
+	return (x < y ? -1 : (x > y ? 1 : 0));
+}
+
+/*
+ * Return the median, 99th percentile and maximum of a phase over the
+ * last few turns, and the worst since reset.  Returns the number of
+ * turns looked at.
+ */
+int tick_stats(int phase, micro *p50, micro *p99, micro *max, micro *peak)
+{
+	static micro sorted[TICK_HISTORY];
+	int n = tick_filled;
+
+	*p50 = *p99 = *max = 0;
+	*peak = tick_peak[phase];
+	if (!n) return (0);
+
+	C_COPY(sorted, tick_history[phase], n, micro);
+	qsort(sorted, n, sizeof(micro), tick_cmp);
+
+	*p50 = sorted[n / 2];
+	*p99 = sorted[(n * 99) / 100];
+	*max = sorted[n - 1];
+
+	return (n);
+}
+
+/*
+ * Start (or with an empty name, stop) writing the per-turn CSV trace
+ */
+bool tick_trace_open(cptr name)
+{
+	if (tick_trace)
+	{
+		file_close(tick_trace);
+		tick_trace = NULL;
+	}
+	tick_trace_name[0] = '\0';
+
+	if (!name || !name[0]) return (TRUE);
+
+	tick_trace = file_open(name, MODE_WRITE, FTYPE_TEXT);
+	if (!tick_trace)
+	{
+		plog(format("ERROR! %s (writing %s)", strerror(errno), name));
+		return (FALSE);
+	}
+	my_strcpy(tick_trace_name, name, sizeof(tick_trace_name));
+
+	/* Header */
+	file_putf(tick_trace, "tick,turn,late,%s,%s,%s,%s,%s,%s,%s,%s,%s,%s\n",
+		tick_phase_names[0], tick_phase_names[1], tick_phase_names[2],
+		tick_phase_names[3], tick_phase_names[4], tick_phase_names[5],
+		tick_phase_names[6], tick_phase_names[7], tick_phase_names[8],
+		tick_phase_names[9]);
+
+	return (TRUE);
+}
+
+/*
+ * Name of the trace file being written, or NULL
+ */
+cptr tick_trace_file(void)
+{
+	return (tick_trace ? tick_trace_name : NULL);
+}
+
+
 /*
  * Main loop --KLJ--
  *
@@ -2012,7 +2260,7 @@ static void process_various(void)
 
 void dungeon(void)
 {
-	int i, d, j;
+	int i, d, j, next_m_idx;
 	byte *w_ptr;
 	cave_type *c_ptr;
 	int dy, dx;
@@ -2207,6 +2455,9 @@ void dungeon(void)
 
 		/* Update the player location */
 		cave[Depth][y][x].m_idx = 0 - i;
+
+		/* Time bubble may change */
+		invalidate_time_factors(Depth);
     
 		/* Prevent hound insta-death */
 		switch (p_ptr->new_level_method)
@@ -2217,13 +2468,13 @@ void dungeon(void)
 			case LEVEL_RAND:
 
 				/* Remove nearby hounds */
-				for (j = 1; j < m_max; j++)
+				for (j = m_first_on_depth[Depth]; j; j = next_m_idx)
 				{
 					monster_type	*m_ptr = &m_list[j];
 					monster_race	*r_ptr = &r_info[m_ptr->r_idx];
-		
-					/* Paranoia -- Skip dead monsters */
-					if (!m_ptr->r_idx) continue;
+
+					/* Get next monster (before we delete this one) */
+					next_m_idx = m_ptr->next_on_depth;
 
 					/* Hack -- Skip Unique Monsters */
 					if (r_ptr->flags1 & RF1_UNIQUE) continue;
@@ -2231,9 +2482,6 @@ void dungeon(void)
 					/* Skip monsters other than hounds */
 					if (r_ptr->d_char != 'Z') continue;
 
-					/* Skip monsters not on this depth */
-					if (p_ptr->dun_depth != m_ptr->dun_depth) continue;
-
 					/* Approximate distance */
 					dy = (p_ptr->py > m_ptr->fy) ? (p_ptr->py - m_ptr->fy) : (m_ptr->fy - p_ptr->py);
 					dx = (p_ptr->px > m_ptr->fx) ? (p_ptr->px - m_ptr->fx) : (m_ptr->fx - p_ptr->px);
@@ -2281,6 +2529,7 @@ void dungeon(void)
 	/* Hack -- Compact the monster list occasionally */
 	if (m_top + 32 > MAX_M_IDX) compact_monsters(64);
 
+	tick_phase(TICK_LEVELS);
 
 	// Note -- this is the END of the last turn
 
@@ -2314,12 +2563,18 @@ void dungeon(void)
 		process_player_begin(Players[i]);
 	}
 
+	tick_phase(TICK_PLAYERS);
+
 	/* Process all of the monsters */
 	process_monsters();
 
+	tick_phase(TICK_MONSTERS);
+
 	/* Process all of the objects */
 	process_objects();
 
+	tick_phase(TICK_OBJECTS);
+
 	/* Probess the world */
 	for (i = 1; i <= NumPlayers; i++)
 	{
@@ -2327,12 +2582,16 @@ void dungeon(void)
 		process_world(Players[i]);
 	}
 
+	tick_phase(TICK_WORLD);
+
 	/* Process everything else */
 	process_various();
 
 	/* Hack -- Regenerate the monsters every hundred game turns */
 	regen_monsters();
 
+	tick_phase(TICK_VARIOUS);
+
 	/* Refresh everybody's displays */
 	for (i = 1; i <= NumPlayers; i++)
 	{
@@ -2340,7 +2599,12 @@ void dungeon(void)
 
 		/* Flush pending updates */
 		handle_stuff(p_ptr);
+
+		/* Sub-windows, once per turn */
+		window_stuff_tick(p_ptr);
 	}
+
+	tick_phase(TICK_STUFF);
 }
 
 		
@@ -2394,6 +2658,9 @@ void play_game(bool new_game)
 		quit("broken server savefile(s)");
 	}
 
+	/* Load the account index, for quick logins */
+	load_accounts();
+
 	/* UltraHack -- clear each wilderness levels inhabited flag, so
 	   monsters will respawn.
 	   hack -- clear the wild_f_in_memory flag, so house objects are added
@@ -2440,6 +2707,9 @@ void play_game(bool new_game)
 
 		/* Seed the "complex" RNG */
 		Rand_state_init(seed);
+
+		/* Record it (or use the recorded state) */
+		replay_rng();
 	}
 
 	/* Roll new town */
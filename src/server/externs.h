@@ -83,6 +83,9 @@ extern u16b sf_saves;
 extern cptr arg_config_file;
 extern bool arg_wizard;
 extern bool arg_fiddle;
+extern cptr arg_record_file;
+extern cptr arg_replay_file;
+extern bool arg_replay_fast;
 extern bool arg_force_original;
 extern bool arg_force_roguelike;
 extern bool server_generated;
@@ -114,6 +117,16 @@ extern s16b resting;
 extern s16b cur_wid;*/
 /*extern s16b dun_level;*/
 extern s16b *players_on_depth;
+extern player_type **p_first_on_depth;
+extern s16b *m_first_on_depth;
+extern s16b *m_num_on_depth;
+extern flow_type **flow_on_depth;
+extern u32b *view_stamp_on_depth;
+extern u32b *bubble_stamp_on_depth;
+extern u32b view_updates;
+extern u32b view_partial;
+extern u32b view_shared;
+extern u32b view_grids;
 extern s16b special_levels[MAX_SPECIAL_LEVELS];
 extern s16b num_repro;
 extern s16b object_level;
@@ -149,8 +162,8 @@ extern bool scan_objects;
 extern s16b inven_nxt;
 /*extern s16b inven_cnt;
 extern s16b equip_cnt;*/
-extern s32b o_nxt;
-extern s32b m_nxt;
+extern s32b o_free_num;
+extern s32b m_free_num;
 extern s32b o_max;
 extern s32b m_max;
 extern s32b o_top;
@@ -180,6 +193,8 @@ extern s16b cfg_preserve_artifacts;
 extern bool cfg_ironman;
 extern bool cfg_more_towns;
 extern bool cfg_town_wall;
+extern bool cfg_monster_flow;
+extern s16b cfg_level_pool;
 extern s32b cfg_unique_respawn_time;
 extern s32b cfg_unique_max_respawn_time;
 extern s16b cfg_max_townies;
@@ -198,6 +213,8 @@ extern bool cfg_party_share_kill;
 extern bool cfg_party_share_win;
 extern s16b cfg_party_sharelevel;
 extern bool cfg_instance_closed;
+extern bool cfg_save_binary;
+extern char * cfg_tick_trace;
 
 extern s16b hitpoint_warn;
 extern s16b delay_factor;
@@ -256,6 +273,7 @@ extern bool *macro__cmd;
 extern char *macro__buf;
 extern s16b quark__num;
 extern cptr *quark__str;
+extern s16b *quark__hash;
 extern u16b message__next;
 extern u16b message__last;
 extern u16b message__head;
@@ -269,6 +287,8 @@ extern u32b window_mask[8];*/
 /*extern term *ang_term[8];*/
 extern s16b o_fast[MAX_O_IDX];
 extern s16b m_fast[MAX_M_IDX];
+extern s16b o_free[MAX_O_IDX];
+extern s16b m_free[MAX_M_IDX];
 extern cave_type ***cave;
 extern wilderness_type *wild_info;
 extern hturn *turn_cavegen;
@@ -326,6 +346,7 @@ extern char *r_name;
 extern char *r_text;
 extern char *r_char_s;
 extern byte *r_attr_s;
+extern u16b *r_count_s;
 extern player_race *p_info;
 extern char *p_name;
 extern char *p_text;
@@ -395,6 +416,7 @@ extern void move_cursor_relative(int row, int col);
 extern void print_rel(char c, byte a, int y, int x);
 extern void cave_set_feat(int Depth, int y, int x, int feat);
 extern void spot_updates(int Depth, int y, int x, u32b updates);
+extern void player_spot_updates(player_type *p_ptr, int y, int x, u32b updates);
 extern void note_spot(player_type *p_ptr, int y, int x);
 extern void note_spot_depth(int Depth, int y, int x);
 extern void everyone_lite_spot(int Depth, int y, int x);
@@ -407,8 +429,9 @@ extern void forget_lite(player_type *p_ptr);
 extern void update_lite(player_type *p_ptr);
 extern void forget_view(player_type *p_ptr);
 extern void update_view(player_type *p_ptr);
-extern void forget_flow(void);
-extern void update_flow(void);
+extern void forget_flow(int Depth);
+extern void update_flow(player_type *p_ptr);
+extern flow_type *get_flow(int Depth);
 extern void wiz_lite(player_type *p_ptr);
 extern void wiz_dark(player_type *p_ptr);
 extern void mmove2(int *y, int *x, int y1, int x1, int y2, int x2);
@@ -569,10 +592,24 @@ extern bool is_boring(byte feat);
 extern void play_game(bool new_game);
 extern void shutdown_server(void);
 extern void dungeon(void);
+extern cptr tick_phase_names[TICK_MAX];
+extern u32b tick_count;
+extern u32b tick_overruns;
+extern u32b tick_catchups;
+extern void tick_start(void);
+extern void tick_phase(int phase);
+extern void tick_finish(bool late);
+extern void tick_stats_reset(void);
+extern int tick_stats(int phase, micro *p50, micro *p99, micro *max, micro *peak);
+extern bool tick_trace_open(cptr name);
+extern cptr tick_trace_file(void);
 extern bool check_special_level(s16b special_depth);
 extern int find_player_name(char *name);
 extern int find_player(s32b id);
 extern int count_players(int Depth);
+extern void player_link_depth(player_type *p_ptr);
+extern void player_unlink_depth(player_type *p_ptr);
+extern void player_change_depth(player_type *p_ptr, int Depth);
 
 /* files.c */
 extern void safe_setuid_drop(void);
@@ -615,6 +652,8 @@ extern errr file_character_server(player_type *p_ptr, cptr name);
 /* generate.c */
 extern void alloc_dungeon_level(int Depth);
 extern void dealloc_dungeon_level(int Depth);
+extern void level_pool_flush(void);
+extern cptr level_pool_status(void);
 extern void generate_cave(player_type *p_ptr, int Depth, int auto_scum);
 extern void build_vault(int Depth, int yval, int xval, int ymax, int xmax, cptr data);
 extern void place_closed_door(int Depth, int y, int x);
@@ -654,8 +693,12 @@ extern void cleanup_angband(void);
 /* load2.c */
 extern errr rd_savefile_new(player_type *p_ptr);
 extern errr rd_server_savefile(void);
-extern errr rd_savefile_new_scoop_aux(char *sfile, char *pass_word);
+extern errr rd_savefile_new_scoop_aux(char *sfile, char *pass);
+extern errr rd_accounts(cptr name);
 extern bool rd_dungeon_special_ext(int Depth, cptr levelname);
+extern bool rd_record_open(cptr name, bool *binary);
+extern byte rd_record(char *name, char *value);
+extern void rd_record_close(void);
 
 /* melee1.c */
 /* melee2.c */
@@ -670,6 +713,8 @@ extern void display_roff(int r_idx);
 /* monster.c */
 extern void describe_monster(player_type *p_ptr, int m_ind, bool spoilers);
 extern void delete_monster_idx(int i);
+extern void monster_link_depth(int m_idx);
+extern void monster_unlink_depth(int m_idx);
 extern void delete_monster(int Depth, int y, int x);
 extern void compact_monsters(int size);
 extern void wipe_m_list(int Depth);
@@ -680,6 +725,9 @@ extern void monster_desc(player_type *p_ptr, char *desc, int m_idx, int mode);
 extern void lore_do_probe(player_type *p_ptr, int m_idx);
 extern void lore_treasure(player_type *p_ptr, int m_idx, int num_item, int num_gold);
 extern void update_mon(int m_idx, bool dist);
+extern byte mon_det_turns(player_type *p_ptr, int m_idx);
+extern void mon_det_set(player_type *p_ptr, int m_idx, int turns);
+extern void mon_det_move(player_type *p_ptr, int i1, int i2);
 extern void update_monsters(bool dist);
 extern void update_player(player_type *p_ptr);
 extern void update_players(void);
@@ -700,6 +748,7 @@ extern u16b rand_mimic_kind(int r_idx);
 /* monster2.c */
 extern bool is_detected(u32b flag, u32b esp);
 extern void reveal_mimic(int m_idx);
+extern void set_monster_sleep(monster_type *m_ptr, int v);
 extern void forget_monster(player_type *p_ptr, int m_idx, bool deleted);
 extern s16b monster_carry(player_type *p_ptr, int m_idx, object_type *j_ptr);
 extern bool monster_can_carry(int m_idx);
@@ -719,6 +768,9 @@ extern void setup_network_server();
 extern void network_loop();
 extern void close_network_server();
 extern void report_to_meta_die(void);
+extern void replay_init(void);
+extern void replay_savefile(cptr path);
+extern void replay_rng(void);
 extern int player_leave(int p_idx);
 extern int player_disconnect(player_type *p_ptr, cptr reason);
 
@@ -727,6 +779,9 @@ extern int process_player_commands(player_type *p_ptr);
 extern int stream_char_raw(player_type *p_ptr, int st, int y, int x, byte a, char c, byte ta, char tc);
 extern int stream_char(player_type *p_ptr, int st, int y, int x);
 extern int stream_line_as(player_type *p_ptr, int st, int y, int x);
+extern int stream_tile_later(player_type *p_ptr, int y, int x);
+extern int stream_flush_tiles(player_type *p_ptr);
+extern bool player_congested(player_type *p_ptr);
 extern int send_term_info(player_type *p_ptr, byte flag, u16b line);
 extern int send_term_header(player_type *p_ptr, byte hint, cptr header);
 extern int send_term_writefile(connection_type *ct, byte fmode, cptr filename);
@@ -848,6 +903,8 @@ extern void display_itemlist(player_type *p_ptr);
 /* randart.c */
 extern artifact_type *randart_make(const object_type *o_ptr);
 extern void randart_name(const object_type *o_ptr, char *buffer);
+extern void randart_cache_wipe(void);
+extern cptr randart_cache_status(void);
 
 /* party.c */
 extern int party_lookup(cptr name);
@@ -880,10 +937,16 @@ extern bool place_specific_object(int Depth, int y1, int x1, object_type *forge,
 /* save.c */
 extern bool save_player(player_type *p_ptr);
 extern int scoop_player(char *nick, char *pass);
+extern void account_add(cptr base, cptr name, cptr pass, byte flags);
+extern void load_accounts(void);
 extern bool load_player(player_type *p_ptr);
 extern bool load_server_info(void);
 extern bool save_server_info(void);
 extern bool wr_dungeon_special_ext(int Depth, cptr levelname);
+extern bool convert_savefile(cptr name);
+extern void autosave_game(void);
+extern void autosave_wait(void);
+extern cptr autosave_status(void);
 
 
 /* spells1.c */
@@ -1020,6 +1083,7 @@ extern void macro_add(cptr pat, cptr act, bool cmd_flag);
 extern char inkey(void);
 extern cptr quark_str(s16b num);
 extern s16b quark_add(cptr str);
+extern void quark_collect(void);
 extern void fill_prevent_inscription(bool *arr, s16b quark);
 extern void update_prevent_inscriptions(player_type *p_ptr);
 extern bool check_guard_inscription( s16b quark, char what);
@@ -1052,12 +1116,14 @@ extern int color_text_to_attr(cptr name);
 extern int color_opposite(int color);
 extern cptr attr_to_text(byte a);
 extern void send_prepared_info(player_type *p_ptr, byte win, byte stream, byte extra_params);
+extern void send_prepared_diff(player_type *p_ptr, byte win, byte stream, sent_text_type *sent);
 extern void send_prepared_popup(player_type *p_ptr, cptr header);
 extern void monster_race_track_hack(player_type *p_ptr);
 extern void text_out(cptr buf);
 extern void text_out_c(byte a, cptr buf);
 extern void text_out_init(player_type *p_ptr);
 extern void text_out_done();
+extern bool text_info_row(player_type *p_ptr, int row);
 extern void text_out_save();
 extern void text_out_load();
 extern void c_prt(player_type *p_ptr, byte attr, cptr str, int row, int col);
@@ -1074,6 +1140,7 @@ extern void notice_stuff(player_type *p_ptr);
 extern void update_stuff(player_type *p_ptr);
 extern void redraw_stuff(player_type *p_ptr);
 extern void window_stuff(player_type *p_ptr);
+extern void window_stuff_tick(player_type *p_ptr);
 extern void handle_stuff(player_type *p_ptr);
 extern void prt_history(player_type *p_ptr);
 extern void c_prt_status_line(player_type *p_ptr, cave_view_type *dest, int len);
@@ -1141,6 +1208,7 @@ extern bool do_restoreXP_other(player_type *p_ptr);
 extern u32b level_speed(int Depth);
 extern int time_factor(player_type *p_ptr);
 extern int base_time_factor(player_type *p_ptr, int slowest);
+extern void invalidate_time_factors(int Depth);
 extern void show_motd(player_type *p_ptr);
 extern void show_tombstone(player_type *p_ptr);
 extern void wipe_socials();
@@ -1549,7 +1549,7 @@ void copy_file_info(player_type *p_ptr, cptr name, int line, int color)
 		if (next <= line) continue;
 
 		/* Too much */
-		if (i >= MAX_TXT_INFO) continue;
+		if (!text_info_row(p_ptr, i)) continue;
 
 		/* Extract color */
 		if (color) attr = color_char_to_attr(buf[0]);
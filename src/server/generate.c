@@ -4046,22 +4046,117 @@ static void town_gen(void)
 
 
 
+/*
+ * Dungeon level buffers.
+ *
+ * Each level lives in one contiguous slab, with the row pointers
+ * used by "cave[Depth][y][x]" pointing into it. Freed buffers are
+ * kept on a free list (up to "cfg_level_pool" of them) so players
+ * taking stairs back and forth don't churn the allocator.
+ */
+typedef struct level_buffer level_buffer;
+struct level_buffer
+{
+	cave_type *rows[MAX_HGT];	/* Row pointers, "cave[Depth]" (must be first) */
+	level_buffer *next;		/* Next spare buffer */
+	cave_type grid[MAX_HGT][MAX_WID];
+};
+
+static level_buffer *level_pool = NULL;	/* Spare buffers */
+static int level_pool_num = 0;		/* Number of spare buffers */
+static int level_pool_used = 0;		/* Number of buffers in use */
+static u32b level_pool_hits = 0;
+static u32b level_pool_misses = 0;
+
+/* Hack -- find the buffer from its row array */
+#define LEVEL_BUFFER(ROWS) ((level_buffer *)(ROWS))
+
 /*
  * Allocate the space needed for a dungeon level
  */
 void alloc_dungeon_level(int Depth)
 {
+	level_buffer *lb;
 	int i;
 
-	/* Allocate the array of rows */
-	C_MAKE(cave[Depth], MAX_HGT, cave_type *);
+	/* Reuse a spare buffer */
+	if (level_pool)
+	{
+		lb = level_pool;
+		level_pool = lb->next;
+		level_pool_num--;
+		level_pool_hits++;
+
+		/* Clear it */
+		C_WIPE(lb->grid, MAX_HGT, cave_type[MAX_WID]);
+	}
+
+	/* Allocate a new one */
+	else
+	{
+		MAKE(lb, level_buffer);
+		level_pool_misses++;
+
+		/* Point the rows into the slab */
+		for (i = 0; i < MAX_HGT; i++)
+		{
+			lb->rows[i] = lb->grid[i];
+		}
+	}
+
+	lb->next = NULL;
+	level_pool_used++;
+
+	cave[Depth] = lb->rows;
+}
+
+/*
+ * Return a level buffer to the pool, or free it if the pool is full
+ */
+static void level_pool_release(level_buffer *lb)
+{
+	level_pool_used--;
+
+	if (level_pool_num < cfg_level_pool)
+	{
+		lb->next = level_pool;
+		level_pool = lb;
+		level_pool_num++;
+	}
+	else
+	{
+		FREE(lb);
+	}
+}
+
+/*
+ * Free all spare level buffers
+ */
+void level_pool_flush(void)
+{
+	level_buffer *lb;
 
-	/* Allocate each row */
-	for (i = 0; i < MAX_HGT; i++)
+	while (level_pool)
 	{
-		/* Allocate it */
-		C_MAKE(cave[Depth][i], MAX_WID, cave_type);
+		lb = level_pool;
+		level_pool = lb->next;
+		FREE(lb);
 	}
+	level_pool_num = 0;
+}
+
+/*
+ * Report level pool statistics
+ */
+cptr level_pool_status(void)
+{
+	static char buf[160];
+
+	strnfmt(buf, sizeof(buf), "Level pool: %d in use, %d/%d spare (%ld bytes each), %lu hits, %lu misses\n",
+		level_pool_used, level_pool_num, (int)cfg_level_pool, (long)sizeof(level_buffer),
+		(unsigned long)level_pool_hits, (unsigned long)level_pool_misses);
+
+	return (buf);
 }
 
 /*
@@ -4090,15 +4185,14 @@ void dealloc_dungeon_level(int Depth)
 	/* Hack -- don't wipe wilderness objects */
 	if (Depth > 0) wipe_o_list(Depth);
 
-	/* Free up the space taken by each row */
-	for (i = 0; i < MAX_HGT; i++)
-	{
-		/* Dealloc that row */
-		FREE(cave[Depth][i]);
-	}
+	/* Forget the monster flow */
+	forget_flow(Depth);
+
+	/* Forget cached views */
+	view_stamp_on_depth[Depth]++;
 
-	/* Deallocate the array of rows */
-	FREE(cave[Depth]);
+	/* Give the space back */
+	level_pool_release(LEVEL_BUFFER(cave[Depth]));
 
 	/* Set that level to "ungenerated" */
 	cave[Depth] = NULL; 
@@ -4123,6 +4217,9 @@ void generate_cave(player_type *p_ptr, int Depth, int auto_scum)
 
 	/* No dungeon yet */
 	server_dungeon = FALSE;
+
+	/* Forget cached views */
+	view_stamp_on_depth[Depth]++;
 	
 	/* Default room align */
 	dungeon_align = TRUE;
@@ -1578,6 +1578,7 @@ static errr init_other(void)
 	/* Monster */
 	C_MAKE(r_char_s, z_info->r_max, char);
 	C_MAKE(r_attr_s, z_info->r_max, byte);
+	C_MAKE(r_count_s, z_info->r_max, u16b);
 
 	/* Object Kinds */
 	C_MAKE(k_char_s, z_info->k_max, char);
@@ -1619,6 +1620,7 @@ static errr init_other(void)
 
 	/* Quark variables */
 	C_MAKE(quark__str, QUARK_MAX, cptr);
+	C_MAKE(quark__hash, QUARK_HASH, s16b);
 
 	/* Message variables */
 	C_MAKE(message__ptr, MESSAGE_MAX, u16b);
@@ -2190,6 +2192,14 @@ void set_server_option(const char * option, char * value)
     {
         cfg_town_wall = str_to_boolean(value);
     }
+    else if (!strcmp(option,"MONSTER_FLOW"))
+    {
+        cfg_monster_flow = str_to_boolean(value);
+    }
+    else if (!strcmp(option,"LEVEL_POOL"))
+    {
+        cfg_level_pool = atoi(value);
+    }
     else if (!strcmp(option,"BASE_UNIQUE_RESPAWN_TIME"))
     {
         cfg_unique_respawn_time = atoi(value);
@@ -2218,6 +2228,15 @@ void set_server_option(const char * option, char * value)
 	{
 		cfg_instance_closed = str_to_boolean(value);
 	}
+	else if (!strcmp(option,"BINARY_SAVEFILES"))
+	{
+		cfg_save_binary = str_to_boolean(value);
+	}
+	else if (!strcmp(option,"TICK_TRACE"))
+	{
+		if (cfg_tick_trace) string_free(cfg_tick_trace);
+		cfg_tick_trace = (char*)string_make(value);
+	}
     else if (!strcmp(option,"PVP_NOTIFY"))
     {
 			cfg_pvp_notify = str_to_boolean(value);
@@ -2282,6 +2301,7 @@ void unload_server_cfg()
 	str_undup(cfg_console_password);
 	str_undup(cfg_dungeon_master);
 	str_undup(cfg_load_pref_file);
+	str_undup(cfg_tick_trace);
 }
 
 
@@ -2503,6 +2523,7 @@ void cleanup_angband(void)
 			dealloc_dungeon_level(i);
 		}
 	}
+	level_pool_flush();
 
 	/* Network */
 	close_network_server();
@@ -2553,6 +2574,7 @@ void cleanup_angband(void)
 	FREE(f_attr_s);
 	FREE(r_char_s);
 	FREE(r_attr_s);
+	FREE(r_count_s);
 
 	/* Free the lore, monster, and object lists */
 	FREE(m_list);
@@ -2570,6 +2592,7 @@ void cleanup_angband(void)
 	}
 	/* Free the list of "quarks" */
 	FREE((void*)quark__str);
+	FREE(quark__hash);
 
 	/* Free the info, name, and text arrays */
 	free_info(&flavor_head);
@@ -73,7 +73,168 @@ static u32b	x_check = 0L;
 static char file_buf[1024];
 
 /*
- * Functions to read data from the textual format save file
+ * Hack -- the current savefile uses the binary format (see "save.c").
+ *
+ * Each binary record is read whole into "rec_*", and the readers below
+ * take the typed value straight from there.  Only two things still see
+ * the text line a record stands for, rendered on demand into "file_buf":
+ * error messages and "rd_record()", and strings or binary data that a
+ * text savefile converted with "convert_savefile()" stored as some other
+ * type (it picks the narrowest record which reads back the same).
+ */
+static bool file_binary = FALSE;
+static bool rec_rendered;		/* "file_buf" holds the current record */
+static byte rec_tag;			/* Current record tag */
+static char rec_name[256];		/* Current record name */
+static huge rec_num[2];			/* Numeric payload (section length, etc) */
+static char rec_data[1024];		/* String/binary payload */
+static u32b rec_len;			/* Length of the above */
+
+/* Read a little-endian number of "bytes" size */
+static bool get_le(huge *dst, int bytes)
+{
+	byte buf[8];
+	int i;
+	if (file_read(file_handle, (char*)buf, bytes) != (size_t)bytes) return (FALSE);
+	*dst = 0;
+	for (i = bytes - 1; i >= 0; i--) *dst = (*dst << 8) | buf[i];
+	return (TRUE);
+}
+
+/* Read a binary record, header and payload */
+static bool get_record(void)
+{
+	byte len;
+	huge size;
+
+	rec_rendered = FALSE;
+	if (!file_readc(file_handle, &rec_tag)) return (FALSE);
+	if (!file_readc(file_handle, &len)) return (FALSE);
+	if (file_read(file_handle, rec_name, len) != len) return (FALSE);
+	rec_name[len] = '\0';
+	rec_len = 0;
+
+	switch (rec_tag)
+	{
+		case SF_TAG_END: return (TRUE);
+		case SF_TAG_SECTION:
+		case SF_TAG_UINT: return get_le(&rec_num[0], 4);
+		case SF_TAG_INT:
+			if (!get_le(&rec_num[0], 4)) return (FALSE);
+			rec_num[0] = (s64b)(s32b)rec_num[0];
+			return (TRUE);
+		case SF_TAG_HUGE: return get_le(&rec_num[0], 8);
+		case SF_TAG_HTURN:
+			return get_le(&rec_num[0], 8) && get_le(&rec_num[1], 8);
+		case SF_TAG_STR:
+		case SF_TAG_BINARY:
+			if (!get_le(&size, rec_tag == SF_TAG_STR ? 2 : 4)) return (FALSE);
+			rec_len = MIN(size, sizeof(rec_data));
+			if (file_read(file_handle, rec_data, rec_len) != rec_len) return (FALSE);
+			/* Paranoia -- drop what does not fit */
+			if (size > rec_len) file_skip(file_handle, size - rec_len);
+			return (TRUE);
+	}
+
+	plog(format("Unknown savefile record %i at record %i", rec_tag, line_counter));
+	return (FALSE);
+}
+
+/* Render the current binary record as the line the text format uses */
+static char *record_text(void)
+{
+	static const char hex[] = "0123456789abcdef";
+	char *c;
+	u32b i;
+
+	if (!file_binary || rec_rendered) return file_buf;
+	rec_rendered = TRUE;
+
+	switch (rec_tag)
+	{
+		case SF_TAG_SECTION:
+			strnfmt(file_buf, sizeof(file_buf), "<%s>", rec_name); break;
+		case SF_TAG_END:
+			strnfmt(file_buf, sizeof(file_buf), "</%s>", rec_name); break;
+		case SF_TAG_INT:
+			strnfmt(file_buf, sizeof(file_buf), "%s = %" PRId64, rec_name, (s64b)rec_num[0]); break;
+		case SF_TAG_UINT:
+		case SF_TAG_HUGE:
+			strnfmt(file_buf, sizeof(file_buf), "%s = %" PRIu64, rec_name, rec_num[0]); break;
+		case SF_TAG_HTURN:
+			strnfmt(file_buf, sizeof(file_buf), "%s = %" PRIu64 " %" PRIu64, rec_name, rec_num[0], rec_num[1]); break;
+		case SF_TAG_STR:
+			strnfmt(file_buf, sizeof(file_buf), "%s = ", rec_name);
+			c = file_buf + strlen(file_buf);
+			for (i = 0; i < rec_len && c < file_buf + sizeof(file_buf) - 1; i++) *c++ = rec_data[i];
+			*c = '\0';
+			break;
+		case SF_TAG_BINARY:
+			/* Same as "%2x", which pads with a space */
+			strnfmt(file_buf, sizeof(file_buf), "%s = ", rec_name);
+			c = file_buf + strlen(file_buf);
+			for (i = 0; i < rec_len && c < file_buf + sizeof(file_buf) - 2; i++)
+			{
+				byte b = (byte)rec_data[i];
+				*c++ = (b >> 4) ? hex[b >> 4] : ' ';
+				*c++ = hex[b & 0x0F];
+			}
+			*c = '\0';
+			break;
+	}
+	return file_buf;
+}
+
+/* Read the next line (or binary record) of the savefile */
+static bool next_line(void)
+{
+	line_counter++;
+	if (file_binary) return get_record();
+	return file_getl(file_handle, file_buf, sizeof(file_buf)-1);
+}
+
+/* The current binary record is the named number */
+#define REC_NUMBER(NAME) \
+	(file_binary && (rec_tag == SF_TAG_INT || rec_tag == SF_TAG_UINT || \
+	rec_tag == SF_TAG_HUGE) && !strcmp(rec_name, (NAME)))
+
+/* The current binary record is any named value */
+#define REC_VALUE(NAME) \
+	(rec_tag != SF_TAG_SECTION && rec_tag != SF_TAG_END && !strcmp(rec_name, (NAME)))
+
+/*
+ * Detect the format of a freshly opened savefile.  Binary savefiles
+ * start with SF_MAGIC, anything else is read as text.
+ */
+static bool start_savefile_read(void)
+{
+	char head[SF_HEADER_LEN];
+	huge version = 0;
+
+	line_counter = 0;
+	file_binary = FALSE;
+
+	if (file_read(file_handle, head, SF_HEADER_LEN) == SF_HEADER_LEN &&
+	    !memcmp(head, SF_MAGIC, SF_MAGIC_LEN))
+	{
+		file_seek(file_handle, SF_MAGIC_LEN);
+		get_le(&version, 4);
+		if (version > SF_FORMAT_VERSION)
+		{
+			plog(format("Binary savefile format %i is too new", (int)version));
+			return (FALSE);
+		}
+		file_binary = TRUE;
+		return (TRUE);
+	}
+
+	/* A text file */
+	file_seek(file_handle, 0);
+	return (TRUE);
+}
+
+/*
+ * Functions to read data from the save file
  */
 
 /* Start a section */
@@ -83,11 +244,15 @@ bool start_section_read(char* name)
 	char got_section[80];
 	bool matched = FALSE;
 	
-	if (file_getl(file_handle, file_buf, sizeof(file_buf)-1))
+	if (next_line())
 	{
-		line_counter++;
 		sprintf(seek_section,"<%s>",name);
-		if(sscanf(file_buf,"%s",got_section) == 1)
+		if (file_binary)
+		{
+			matched = (rec_tag == SF_TAG_SECTION && !strcmp(rec_name, name));
+			if (!matched) my_strcpy(got_section, record_text(), sizeof(got_section));
+		}
+		else if(sscanf(record_text(),"%s",got_section) == 1)
 		{
 			matched = !strcmp(got_section,seek_section);
 		}
@@ -107,11 +272,15 @@ bool end_section_read(char* name)
 	char got_section[80];
 	bool matched = FALSE;
 		
-	if (file_getl(file_handle, file_buf, sizeof(file_buf)-1))
+	if (next_line())
 	{
-		line_counter++;
 		sprintf(seek_section,"</%s>",name);
-		if(sscanf(file_buf,"%s",got_section) == 1)
+		if (file_binary)
+		{
+			matched = (rec_tag == SF_TAG_END && !strcmp(rec_name, name));
+			if (!matched) my_strcpy(got_section, record_text(), sizeof(got_section));
+		}
+		else if(sscanf(record_text(),"%s",got_section) == 1)
 		{
 			matched = !strcmp(got_section,seek_section);
 		}
@@ -134,13 +303,22 @@ bool read_byte(char* name, byte *dst)
 	u16b larger_value;
 #endif
 		
-	if (file_getl(file_handle, file_buf, sizeof(file_buf)-1))
+	if (next_line())
 	{
-		line_counter++;
+		if (file_binary)
+		{
+#ifndef SCNu8
+			larger_value = (u16b)rec_num[0];
+#else
+			value = (byte)rec_num[0];
+#endif
+			matched = REC_NUMBER(name);
+		}
+		else
 #ifndef SCNu8
-		if(sscanf(file_buf,"%s = %" SCNu16, seek_name,&larger_value) == 2)
+		if(sscanf(record_text(),"%s = %" SCNu16, seek_name,&larger_value) == 2)
 #else
-		if(sscanf(file_buf,"%s = %" SCNu8, seek_name,&value) == 2)
+		if(sscanf(record_text(),"%s = %" SCNu8, seek_name,&value) == 2)
 #endif
 		{
 			matched = !strcmp(seek_name,name);
@@ -148,7 +326,7 @@ bool read_byte(char* name, byte *dst)
 	}
 	if(!matched)
 	{
-		plog(format("Missing integer.  Expected '%s', found '%s' at line %i",name,file_buf,line_counter));
+		plog(format("Missing integer.  Expected '%s', found '%s' at line %i",name,record_text(),line_counter));
 		return (FALSE);
 	}
 #ifndef SCNu8
@@ -172,17 +350,21 @@ bool read_short(char* name, s16b *dst)
 	bool matched = FALSE;
 	s16b value;
 		
-	if (file_getl(file_handle, file_buf, sizeof(file_buf)-1))
+	if (next_line())
 	{
-		line_counter++;
-		if(sscanf(file_buf,"%s = %" SCNu16, seek_name,&value) == 2)
+		if (file_binary)
+		{
+			value = (s16b)rec_num[0];
+			matched = REC_NUMBER(name);
+		}
+		else if(sscanf(record_text(),"%s = %" SCNu16, seek_name,&value) == 2)
 		{
 			matched = !strcmp(seek_name,name);
 		}
 	}
 	if(!matched)
 	{
-		plog(format("Missing integer.  Expected '%s', found '%s' at line %i",name,file_buf,line_counter));
+		plog(format("Missing integer.  Expected '%s', found '%s' at line %i",name,record_text(),line_counter));
 		return (FALSE);
 	}
 	*dst = value;
@@ -196,17 +378,21 @@ bool read_int(char* name, int *dst)
 	bool matched = FALSE;
 	int value;
 		
-	if (file_getl(file_handle, file_buf, sizeof(file_buf)-1))
+	if (next_line())
 	{
-		line_counter++;
-		if(sscanf(file_buf,"%s = %i",seek_name,&value) == 2)
+		if (file_binary)
+		{
+			value = (int)rec_num[0];
+			matched = REC_NUMBER(name);
+		}
+		else if(sscanf(record_text(),"%s = %i",seek_name,&value) == 2)
 		{
 			matched = !strcmp(seek_name,name);
 		}
 	}
 	if(!matched)
 	{
-		plog(format("Missing integer.  Expected '%s', found '%s' at line %i",name,file_buf,line_counter));
+		plog(format("Missing integer.  Expected '%s', found '%s' at line %i",name,record_text(),line_counter));
 		return (FALSE);
 	}
 	*dst = value;
@@ -220,17 +406,21 @@ bool read_uint(const char* name, uint *dst)
 	bool matched = FALSE;
 	uint value;
 		
-	if (file_getl(file_handle, file_buf, sizeof(file_buf)-1))
+	if (next_line())
 	{
-		line_counter++;
-		if(sscanf(file_buf,"%s = %u",seek_name,&value) == 2)
+		if (file_binary)
+		{
+			value = (uint)rec_num[0];
+			matched = REC_NUMBER(name);
+		}
+		else if(sscanf(record_text(),"%s = %u",seek_name,&value) == 2)
 		{
 			matched = !strcmp(seek_name,name);
 		}
 	}
 	if(!matched)
 	{		
-		plog(format("Missing unsigned integer.  Expected '%s', found '%s' at line %i",name,file_buf,line_counter));
+		plog(format("Missing unsigned integer.  Expected '%s', found '%s' at line %i",name,record_text(),line_counter));
 		return (FALSE);
 	}
 	*dst = value;
@@ -244,17 +434,21 @@ bool read_huge(char* name, huge *dst)
 	bool matched = FALSE;
 	huge value;
 		
-	if (file_getl(file_handle, file_buf, sizeof(file_buf)-1))
+	if (next_line())
 	{
-		line_counter++;
-		if(sscanf(file_buf,"%s = %" SCNu64 ,seek_name,&value) == 2)
+		if (file_binary)
+		{
+			value = (huge)rec_num[0];
+			matched = REC_NUMBER(name);
+		}
+		else if(sscanf(record_text(),"%s = %" SCNu64 ,seek_name,&value) == 2)
 		{
 			matched = !strcmp(seek_name,name);
 		}
 	}
 	if(!matched)
 	{		
-		plog(format("Missing signed long.  Expected '%s', found '%s' at line %i",name,file_buf,line_counter));
+		plog(format("Missing signed long.  Expected '%s', found '%s' at line %i",name,record_text(),line_counter));
 		return (FALSE);
 	}
 	*dst = value;
@@ -268,17 +462,22 @@ bool read_hturn(char* name, hturn *value)
 	bool matched = FALSE;
 	s64b era, turn;
 
-	if (file_getl(file_handle, file_buf, sizeof(file_buf)-1))
+	if (next_line())
 	{
-		line_counter++;
-		if (sscanf(file_buf, "%s = %" SCNu64 " %" SCNu64, seek_name, &era, &turn) == 3)
+		if (file_binary)
+		{
+			era = rec_num[0];
+			turn = rec_num[1];
+			matched = (rec_tag == SF_TAG_HTURN && !strcmp(rec_name, name));
+		}
+		else if (sscanf(record_text(), "%s = %" SCNu64 " %" SCNu64, seek_name, &era, &turn) == 3)
 		{
 			matched = !strcmp(seek_name,name);
 		}
 	}
 	if(!matched)
 	{		
-		plog(format("Missing hturn.  Expected '%s', found '%s' at line %i",name,file_buf,line_counter));
+		plog(format("Missing hturn.  Expected '%s', found '%s' at line %i",name,record_text(),line_counter));
 		return (FALSE);
 	}
 	
@@ -294,14 +493,28 @@ bool read_str(char* name, char* value)
 	char seek_name[80];
 	bool matched = FALSE;
 	char *c;
+	u32b i;
 	
-	if (file_getl(file_handle, file_buf, sizeof(file_buf)-1))
+	if (next_line())
 	{
-		line_counter++;
-		sscanf(file_buf,"%s = ",seek_name);
-		if (!strcmp(seek_name,name))
+		if (file_binary)
 		{
-			matched = TRUE;
+			if (rec_tag == SF_TAG_STR && !strcmp(rec_name, name))
+			{
+				/* Same stop rule as the text parser below */
+				for (i = 0; i < rec_len && rec_data[i] >= 31; i++) *value++ = rec_data[i];
+				*value = '\0';
+				return (TRUE);
+			}
+			my_strcpy(seek_name, rec_name, sizeof(seek_name));
+
+			/* Converted from text, it looked like something else */
+			matched = REC_VALUE(name);
+		}
+		else
+		{
+			sscanf(record_text(),"%s = ",seek_name);
+			matched = !strcmp(seek_name,name);
 		}
 	}
 	if (!matched)
@@ -310,7 +523,7 @@ bool read_str(char* name, char* value)
 		return FALSE;
 	}
 
-	c = file_buf;	
+	c = record_text();	
 	while(*c != '=') c++;
 	c+=2;
 
@@ -350,17 +563,31 @@ bool read_float(char* name, float *dst)
 	bool matched = FALSE;
 	float value;
 	
-	if (file_getl(file_handle, file_buf, sizeof(file_buf)-1))
+	if (next_line())
 	{
-		line_counter++;
-		if(sscanf(file_buf,"%s = %f",seek_name,&value) == 2)
+		if (file_binary)
+		{
+			/* There is no float record, take any number */
+			if (rec_tag == SF_TAG_INT) value = (float)(s64b)rec_num[0];
+			else value = (float)rec_num[0];
+			matched = REC_NUMBER(name);
+
+			/* Converted from text, where it was written out as such */
+			if (rec_tag == SF_TAG_STR && !strcmp(rec_name, name))
+			{
+				rec_data[MIN(rec_len, sizeof(rec_data) - 1)] = '\0';
+				value = (float)strtod(rec_data, NULL);
+				matched = TRUE;
+			}
+		}
+		else if(sscanf(record_text(),"%s = %f",seek_name,&value) == 2)
 		{
 			matched = !strcmp(seek_name,name);
 		}
 	}
 	if(!matched)
 	{
-		plog(format("Missing float.  Expected '%s', found '%s' at line %i",name,file_buf,line_counter));
+		plog(format("Missing float.  Expected '%s', found '%s' at line %i",name,record_text(),line_counter));
 		return (FALSE);
 	}
 	*dst = value;
@@ -378,13 +605,24 @@ bool read_binary(char* name, char* value, int max_len)
 	unsigned int abyte;
 	hex[2] = '\0';
 
-	if (file_getl(file_handle, file_buf, sizeof(file_buf)-1))
+	if (next_line())
 	{
-		line_counter++;
-		sscanf(file_buf,"%s = ",seek_name);
-		if (!strcmp(seek_name,name))
+		if (file_binary)
+		{
+			if (rec_tag == SF_TAG_BINARY && !strcmp(rec_name, name))
+			{
+				memcpy(value, rec_data, MIN(rec_len, (u32b)max_len));
+				return (TRUE);
+			}
+			my_strcpy(seek_name, rec_name, sizeof(seek_name));
+
+			/* Converted from text, it looked like something else */
+			matched = REC_VALUE(name);
+		}
+		else
 		{
-			matched = TRUE;
+			sscanf(record_text(),"%s = ",seek_name);
+			matched = !strcmp(seek_name,name);
 		}
 	}
 	if (!matched)
@@ -393,7 +631,7 @@ bool read_binary(char* name, char* value, int max_len)
 		return (FALSE);
 	}
 
-	c = file_buf;	
+	c = record_text();	
 	while(*c != '=') c++;
 	c+=2;
 	
@@ -418,10 +656,9 @@ void skip_value(char* name)
 	/* Remember where we are incase there is nothing to skip */
 	fpos = file_tell(file_handle);
 	sprintf(seek_name,"%s = ",name);
-	if (file_getl(file_handle, file_buf, sizeof(file_buf)-1))
+	if (next_line())
 	{
-		line_counter++;
-		if(strstr(file_buf,seek_name) == NULL)
+		if (file_binary ? !REC_VALUE(name) : (strstr(record_text(),seek_name) == NULL))
 		{
 			/* Move back on seek failures */
 			file_seek(file_handle, fpos);
@@ -442,16 +679,20 @@ bool value_exists(const char* name)
 	/* Remember where we are */
 	fpos = file_tell(file_handle);
 	sprintf(seek_name,"%s = ",name);
-	if (file_getl(file_handle, file_buf, sizeof(file_buf)-1))
+	if (next_line())
 	{
-		matched = TRUE;
-		if(strstr(file_buf,seek_name) == NULL)
+		if (file_binary)
 		{
-			matched = FALSE;
+			matched = REC_VALUE(name);
+		}
+		else
+		{
+			matched = (strstr(record_text(),seek_name) != NULL);
 		}
 	}
 	/* Move back */
 	file_seek(file_handle, fpos);
+	line_counter--;
 	return(matched);
 }
 
@@ -465,19 +706,115 @@ bool section_exists(char* name)
 	
 	/* Remember where we are */
 	fpos = file_tell(file_handle);
-	if (file_getl(file_handle, file_buf, sizeof(file_buf)-1))
+	if (next_line())
 	{
 		sprintf(seek_section,"<%s>",name);
-		if(sscanf(file_buf,"%s",got_section) == 1)
+		if (file_binary)
+		{
+			matched = (rec_tag == SF_TAG_SECTION && !strcmp(rec_name, name));
+		}
+		else if(sscanf(record_text(),"%s",got_section) == 1)
 		{
 			matched = !strcmp(got_section,seek_section);
 		}
 	}
 	/* Move back */
 	file_seek(file_handle, fpos);
+	line_counter--;
 	return(matched);
 }
 
+/*
+ * Skip the named section, which must be next.  Binary savefiles jump
+ * straight past it, text ones are read through to the matching end.
+ */
+bool skip_section(char* name)
+{
+	char open_tag[80];
+	char end_tag[80];
+	char got_section[80];
+	int depth = 1;
+
+	if (!start_section_read(name)) return (FALSE);
+
+	/* The section length was read along with it */
+	if (file_binary) return file_skip(file_handle, (int)rec_num[0]);
+
+	strnfmt(open_tag, sizeof(open_tag), "<%s>", name);
+	strnfmt(end_tag, sizeof(end_tag), "</%s>", name);
+	while (next_line())
+	{
+		if (sscanf(file_buf, "%79s", got_section) != 1) continue;
+		if (!strcmp(got_section, open_tag)) depth++;
+		else if (!strcmp(got_section, end_tag) && !--depth) return (TRUE);
+	}
+
+	plog(format("Missing end section.  Expected '%s' at line %i", end_tag, line_counter));
+	return (FALSE);
+}
+
+/*
+ * Walk any savefile record by record, for "convert_savefile()".
+ */
+bool rd_record_open(cptr name, bool *binary)
+{
+	file_handle = file_open(name, MODE_READ, -1);
+	if (!file_handle) return (FALSE);
+	if (!start_savefile_read())
+	{
+		file_close(file_handle);
+		return (FALSE);
+	}
+	*binary = file_binary;
+	return (TRUE);
+}
+
+/*
+ * Read the next record into "name" (of 256 chars) and "value" (of 1024).
+ *
+ * Returns SF_TAG_SECTION, SF_TAG_END, or for a named value the tag of the
+ * binary record (text values are untyped and come as SF_TAG_STR), with
+ * the value in its text form.  Returns 0 at the end of the file.
+ */
+byte rd_record(char *name, char *value)
+{
+	char *c, *e;
+	byte tag;
+
+	while (next_line())
+	{
+		c = record_text();
+		while (*c == ' ') c++;
+
+		if (!*c) continue;
+		if (c[0] == '<')
+		{
+			tag = (c[1] == '/') ? SF_TAG_END : SF_TAG_SECTION;
+			c += (tag == SF_TAG_END) ? 2 : 1;
+			if (!(e = strchr(c, '>'))) break;
+			*e = '\0';
+			my_strcpy(name, c, 256);
+			value[0] = '\0';
+			return (tag);
+		}
+		if (!(e = strstr(c, " = "))) break;
+		*e = '\0';
+		my_strcpy(name, c, 256);
+		my_strcpy(value, e + 3, 1024);
+		return (file_binary ? rec_tag : SF_TAG_STR);
+	}
+
+	/* Either the end, or garbage */
+	if (!file_binary && !file_error(file_handle) && *file_buf)
+		plog(format("Unparsable savefile line %i: '%s'", line_counter, file_buf));
+	return (0);
+}
+
+void rd_record_close(void)
+{
+	file_close(file_handle);
+}
+
 /*
  * Show information on the screen, one line at a time.
  * Start at line 2, and wrap, if needed, back to line 2.
@@ -1627,6 +1964,8 @@ static errr rd_dungeon_special()
 	char levelname[32];
 	ang_file* fhandle;
 	ang_file* server_handle;
+	bool server_binary;
+	int server_line;
 	int i,num_levels,j=0,k=0;
 	
 	/* Clear all the special levels */
@@ -1655,11 +1994,15 @@ static errr rd_dungeon_special()
 		{
 			/* swap out the main file pointer for our level file */
 			server_handle = file_handle;
+			server_binary = file_binary;
+			server_line = line_counter;
 			file_handle = fhandle;
 			/* load the level */
-			ok = rd_dungeon(FALSE, 0);
+			ok = start_savefile_read() && rd_dungeon(FALSE, 0);
 			/* swap the file pointers back */
 			file_handle = server_handle;
+			file_binary = server_binary;
+			line_counter = server_line;
 			/* close the level file */
 			file_close(fhandle);
 			/* we have an arbitrary max number of levels */
@@ -1684,6 +2027,7 @@ bool rd_dungeon_special_ext(int Depth, cptr levelname)
 	char filename[1024];
 	ang_file* fhandle;
 	ang_file* server_handle;
+	bool server_binary;
 	
 	path_build(filename, 1024, ANGBAND_DIR_SAVE, levelname);
 
@@ -1693,13 +2037,15 @@ bool rd_dungeon_special_ext(int Depth, cptr levelname)
 	{
 			/* swap out the main file pointer for our level file */
 			server_handle = file_handle;
+			server_binary = file_binary;
 			file_handle = fhandle;
 
 			/* load the level */
-			ok = rd_dungeon(TRUE, Depth);
+			ok = start_savefile_read() && rd_dungeon(TRUE, Depth);
 
 			/* swap the file pointers back */
 			file_handle = server_handle;
+			file_binary = server_binary;
 
 			/* close the level file */
 			file_close(fhandle);
@@ -1746,95 +2092,120 @@ static bool rd_cave_memory(player_type *p_ptr)
  * This function parses savefile as if it was a text file, searching for
  * "pass =" string. It ignores the 'xml' format for sake
  * of maintance simplicity (i.e. it doesn't care about savefile format
- * changes). It attempts to read out the stored password, and compares it
- * to the password provided in "pass_word". If it matches, the hashed
- * password stored back onto the "pass_word" buff, which is assumed to be
- * of MAX_CHARS length.
+ * changes). Binary savefiles are walked section by section instead,
+ * stepping over everything up to the "header". The stored password
+ * is copied into "pass", which is assumed to be of MAX_CHARS length.
  *
- * Returns 0 on match, -1 on parsing error and -2 if password do not
- * match.
+ * Returns 0 on success, -1 on parsing error.
  *
  * See "scoop_player" in "save.c" for more info.
  */
-errr rd_savefile_new_scoop_aux(char *sfile, char *pass_word)
+errr rd_savefile_new_scoop_aux(char *sfile, char *pass)
 {
-	errr err;
+	errr err = 0;
 
-	char pass[80];
-	char temp[80];
-	char temp2[80];
-	
 	char *read;
 
 	bool read_pass = FALSE;
 
 	char buf[1024];
 
-	/* The savefile is a text file */
+	/* The savefile is a text or binary file */
 	file_handle = file_open(sfile, MODE_READ, -1);
 
 	/* Paranoia */
 	if (!file_handle) return (-1);
 
-	/* Try to fetch the data */
-	while (file_getl(file_handle, buf, 1024))
+	if (!start_savefile_read())
 	{
-		read = strtok(buf, " \t=");
-		if (!strcmp(read, "pass"))
-		{
-			read = strtok(NULL, " \t\n=");
-			my_strcpy(pass, read, 80);
-			read_pass = TRUE;
-			continue;
-		}
-		if (read_pass) break;
+		file_close(file_handle);
+		return (-1);
 	}
 
-	/* Paranoia */
-	temp[0] = '\0';
-	
-	/* Here's where we do our password encryption handling */
-	my_strcpy(temp, (const char *)pass, 80);
-	MD5Password(temp); /* The hashed version of our stored password */
-	my_strcpy(temp2, (const char *)pass_word, 80);
-	MD5Password(temp2); /* The hashed version of password from client */
-
-	err = 0;
-
-	if (strstr(pass, "$1$"))
-	{ /* Most likely an MD5 hashed password saved */
-		if (strcmp(pass, pass_word))
-		{ /* No match, might be clear text from client */
-			if (strcmp(pass, temp2))
-			{
-				/* No, it's not correct */
-				err = -2;
-			}
-			/* Old style client, but OK otherwise */
+	/* Jump to the header */
+	if (file_binary)
+	{
+		bool ok = start_section_read("mangband_player_save");
+
+		while (ok && !section_exists("header"))
+		{
+			my_strcpy(buf, rec_name, sizeof(buf));
+			ok = (rec_tag == SF_TAG_SECTION) && skip_section(buf);
 		}
+		read_pass = ok && start_section_read("header") &&
+			read_str("playername", buf) && read_str("pass", buf);
+		if (read_pass) my_strcpy(pass, buf, MAX_CHARS);
 	}
+
+	/* Try to fetch the data */
 	else
-	{ /* Most likely clear text password saved */
-		if (strstr(pass_word, "$1$"))
-		{ /* Most likely hashed password from new client */
-			if (strcmp(temp, pass_word))
-			{
-				/* No, it doesn't match hatched */
-				err = -2;
-			}
-		}
-		else
-		{ /* Most likely clear text from client as well */
-			if (strcmp(pass, pass_word))
+	{
+		while (file_getl(file_handle, buf, 1024))
+		{
+			read = strtok(buf, " \t=");
+			if (read && !strcmp(read, "pass"))
 			{
-				/* No, it's not correct */
-				err = -2;
+				read = strtok(NULL, " \t\n=");
+				my_strcpy(pass, read ? read : "", MAX_CHARS);
+				read_pass = TRUE;
+				break;
 			}
 		}
-		/* Good match with clear text, save the hashed */
-		my_strcpy(pass_word, (const char *)temp, MAX_CHARS);
 	}
 
+	/* No password */
+	if (!read_pass) err = -1;
+
+	/* Check for errors */
+	if (file_error(file_handle)) err = -1;
+
+	/* Close the file */
+	file_close(file_handle);
+
+	/* Result */
+	return (err);
+}
+
+/*
+ * Read the account index (see "save.c")
+ */
+errr rd_accounts(cptr name)
+{
+#undef __try
+#define __try(X) if (!(X)) { err = -1; break; }
+	errr err = 0;
+	int i, num;
+	byte flags;
+	char base[MAX_CHARS];
+	char player[MAX_CHARS];
+	char pass[1024];
+
+	file_handle = file_open(name, MODE_READ, -1);
+
+	/* Paranoia */
+	if (!file_handle) return (-1);
+
+	if (!start_savefile_read() ||
+	    !start_section_read("mangband_accounts") ||
+	    !read_int("count", &num))
+	{
+		file_close(file_handle);
+		return (-1);
+	}
+
+	for (i = 0; i < num; i++)
+	{
+		__try( start_section_read("account") );
+		__try( read_str("base", base) );
+		__try( read_str("name", player) );
+		__try( read_str("pass", pass) );
+		__try( read_byte("flags", &flags) );
+		__try( end_section_read("account") );
+
+		account_add(base, player, pass, flags);
+	}
+	if (!err && !end_section_read("mangband_accounts")) err = -1;
+
 	/* Check for errors */
 	if (file_error(file_handle)) err = -1;
 
@@ -2185,14 +2556,14 @@ errr rd_savefile_new(player_type *p_ptr)
 {
 	errr err;
 
-	/* The savefile is a text file */
+	/* The savefile is a text or binary file */
 	file_handle = file_open(p_ptr->savefile, MODE_READ, -1);
 
 	/* Paranoia */
 	if (!file_handle) return (-1);
 
 	/* Call the sub-function */
-	err = rd_savefile_new_aux(p_ptr);
+	err = start_savefile_read() ? rd_savefile_new_aux(p_ptr) : -1;
 
 	/* Check for errors */
 	if (file_error(file_handle)) err = -1;
@@ -2227,9 +2598,12 @@ errr rd_server_savefile()
 	/* Savefile name */
 	path_build(savefile, 1024, ANGBAND_DIR_SAVE, "server");
 
-	/* The server savefile is a binary file */
+	/* The server savefile is a text or binary file */
 	file_handle = file_open(savefile, MODE_READ, -1);
-	line_counter = 0;
+
+	/* Paranoia */
+	if (!file_handle) return (-1);
+	__try( start_savefile_read() );
 
 
 	__try( start_section_read("mangband_server_save") );
@@ -2239,9 +2613,6 @@ errr rd_server_savefile()
 	__try( read_int("patch", &major) );
 	__try( end_section_read("version") );
 
-	/* Paranoia */
-	if (!file_handle) return (-1);
-
         /* Clear the checksums */
         v_check = 0L;
         x_check = 0L;
@@ -2360,7 +2731,11 @@ errr rd_server_savefile()
 		/* load the monsters */
 		for (i = 1; i < tmp32u; i++)
 		{
-			__try( rd_monster(&m_list[m_pop()]) );
+			s16b m_idx = m_pop();
+			__try( rd_monster(&m_list[m_idx]) );
+
+			/* Place it on it's level list */
+			if (m_list[m_idx].r_idx) monster_link_depth(m_idx);
 		}
 	__try( end_section_read("monsters") );
 
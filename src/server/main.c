@@ -346,6 +346,28 @@ int main(int argc, char *argv[])
 				show_version();
 			break;
 
+			case 'w':
+			case 'W':
+			arg_record_file = string_make(&argv[0][2]);
+			break;
+
+			case 'y':
+			case 'Y':
+			arg_replay_file = string_make(&argv[0][2]);
+			break;
+
+			case 'q':
+			case 'Q':
+			arg_replay_fast = TRUE;
+			break;
+
+			case 'x':
+			case 'X':
+			/* Convert a savefile and quit */
+			if (!convert_savefile(&argv[0][2])) quit("Savefile conversion failed");
+			quit(NULL);
+			break;
+
 			case 'h':
 			default:
 			usage:
@@ -361,6 +383,10 @@ int main(int argc, char *argv[])
 			puts("  -d<path> Look for data files in the directory <path>");
 			puts("  -s<path> Look for save files in the directory <path>");
 			puts("  -b<path> Look for bone files in the directory <path>");
+			puts("  -x<file> Convert savefile <file> between text and binary");
+			puts("  -w<file> Record all input to <file>");
+			puts("  -y<file> Replay input recorded in <file>");
+			puts("  -q       Replay as fast as possible");
 
 			/* Actually abort the process */
 			quit(NULL);
@@ -387,6 +413,9 @@ int main(int argc, char *argv[])
 	/* Load the mangband.cfg options */
 	load_server_cfg();
 
+	/* Start recording or replaying input */
+	replay_init();
+
 	/* Test existance of 'news.txt' and 'scores.raw' */
 	show_news();
 
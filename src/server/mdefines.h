@@ -150,6 +150,8 @@
  * Misc constants
  */
 #define SERVER_SAVE	10		/* Minutes between server saves */
+#define MONSTER_FLOW_DEPTH	32	/* Monsters "hear" players this many steps away */
+#define FLOW_NONE	255		/* Grid is too far from any player */
 #define TOWN_DAWN		50000	/* Number of turns from dawn to dawn XXX */
 #define GROW_TREE	5000		/* How often to grow a new tree in town */
 #define GROW_CROPS	5000		/* How often to grow a bunch of new vegetables in wilderness */
@@ -193,6 +195,23 @@
 #define MAX_SIGHT	20	/* Maximum view distance */
 #define MAX_RANGE	18	/* Maximum range (spells, etc) */
 
+/*
+ * Phases of a game turn, as measured by "tick_phase()"
+ */
+#define TICK_LEVELS	0	/* Level (de)allocation and arrivals */
+#define TICK_PLAYERS	1	/* process_player_end() and _begin() */
+#define TICK_MONSTERS	2	/* process_monsters() */
+#define TICK_OBJECTS	3	/* process_objects() */
+#define TICK_WORLD	4	/* process_world() */
+#define TICK_VARIOUS	5	/* process_various(), regen_monsters() */
+#define TICK_STUFF	6	/* handle_stuff() */
+#define TICK_NETWORK	7	/* Reading and writing sockets */
+#define TICK_COMMANDS	8	/* Executing player commands */
+#define TICK_TOTAL	9	/* All of the above */
+#define TICK_MAX	10
+
+#define TICK_HISTORY	1024	/* Turns to keep for the percentiles */
+
 /*
  * Maximum number of picked up/stolen objects a monster can carry
  */
@@ -778,6 +797,32 @@ enum {
 #define ORIGIN_BYTES 4 /* savefile bytes - room for 32 origin types */
 
 
+/*
+ * Binary savefile format (see "save.c" and "load2.c").
+ *
+ * The file starts with SF_MAGIC and a 4-byte format version, followed
+ * by a stream of records.  Each record is a tag byte, a name (one length
+ * byte, then the characters) and a payload depending on the tag.  All
+ * numbers are little-endian.  A section record carries the byte length
+ * of its body (up to and including the matching end record), so a whole
+ * section can be stepped over without parsing it.
+ */
+#define SF_MAGIC	"\211MSV"
+#define SF_MAGIC_LEN	4
+#define SF_HEADER_LEN	8
+#define SF_FORMAT_VERSION	1
+#define SF_MAX_DEPTH	16	/* Deepest section nesting */
+
+#define SF_TAG_SECTION	'S'	/* u32 body length */
+#define SF_TAG_END	'E'	/* no payload */
+#define SF_TAG_INT	'i'	/* s32 */
+#define SF_TAG_UINT	'u'	/* u32 */
+#define SF_TAG_HUGE	'h'	/* u64 */
+#define SF_TAG_HTURN	't'	/* u64 era, u64 turn */
+#define SF_TAG_STR	's'	/* u16 length, characters */
+#define SF_TAG_BINARY	'b'	/* u32 length, bytes */
+
+
 /*
  * Legal restrictions for "summon_specific()"
  */
@@ -445,7 +445,7 @@ bool make_attack_spell(player_type *p_ptr, int m_idx)
 	bool blind = (p_ptr->blind ? TRUE : FALSE);
 
 	/* Extract the "see-able-ness" */
-	bool seen = (!blind && p_ptr->mon_vis[m_idx]);
+	bool seen = (!blind && idx_has(p_ptr->mon_vis, m_idx));
 
 
 	/* Assume "normal" target */
@@ -2082,69 +2082,48 @@ static int mon_will_run(player_type *p_ptr, int m_idx)
 
 
 
-#ifdef MONSTER_FLOW
-
 /*
  * Choose the "best" direction for "flowing"
  *
  * Note that ghosts and rock-eaters are never allowed to "flow",
  * since they should move directly towards the player.
  *
- * Prefer "non-diagonal" directions, but twiddle them a little
- * to angle slightly towards the player's actual location.
- *
- * Allow very perceptive monsters to track old "spoor" left by
- * previous locations occupied by the player.  This will tend
- * to have monsters end up either near the player or on a grid
- * recently occupied by the player (and left via "teleport").
- *
- * Note that if "smell" is turned on, all monsters get vicious.
- *
- * Also note that teleporting away from a location will cause
- * the monsters who were chasing you to converge on that location
- * as long as you are still near enough to "annoy" them without
- * being close enough to chase directly.  I have no idea what will
- * happen if you combine "smell" with low "aaf" values.
+ * The level's flow field gives the number of steps to the nearest
+ * player, so going down the gradient leads around walls towards
+ * him.  Monsters too far away to "hear" anybody do not flow.
  */
-static bool get_moves_aux(int m_idx, int *yp, int *xp)
+static bool get_moves_aux(player_type *p_ptr, int m_idx, int *yp, int *xp)
 {
-	int i, y, x, y1, x1, when = 0, cost = 999;
+	int i, y, x, y1, x1, cost;
+	int Depth;
 
-	cave_type *c_ptr;
+	flow_type *flow;
 
 	monster_type *m_ptr = &m_list[m_idx];
 	monster_race *r_ptr = &r_info[m_ptr->r_idx];
 
 	/* Monster flowing disabled */
-	if (!flow_by_sound) return (FALSE);
+	if (!cfg_monster_flow) return (FALSE);
 
 	/* Monster can go through rocks */
 	if (r_ptr->flags2 & RF2_PASS_WALL) return (FALSE);
 	if (r_ptr->flags2 & RF2_KILL_WALL) return (FALSE);
 
 	/* Monster location */
+	Depth = m_ptr->dun_depth;
 	y1 = m_ptr->fy;
 	x1 = m_ptr->fx;
 
-	/* Monster grid */
-	c_ptr = &cave[y1][x1];
+	/* Hack -- Player can see us, run towards him */
+	if (player_has_los_bold(p_ptr, y1, x1)) return (FALSE);
 
-	/* The player is not currently near the monster grid */
-	if (c_ptr->when < cave[py][px].when)
-	{
-		/* The player has never been near the monster grid */
-		if (!c_ptr->when) return (FALSE);
-
-		/* The monster is not allowed to track the player */
-		if (!flow_by_smell) return (FALSE);
-	}
+	/* Get the flow of this level */
+	flow = get_flow(Depth);
 
 	/* Monster is too far away to notice the player */
-	if (c_ptr->cost > MONSTER_FLOW_DEPTH) return (FALSE);
-	if (c_ptr->cost > r_ptr->aaf) return (FALSE);
-
-	/* Hack -- Player can see us, run towards him */
-	if (player_has_los_bold(y1, x1)) return (FALSE);
+	cost = flow->cost[y1][x1];
+	if (cost == FLOW_NONE) return (FALSE);
+	if (cost > r_ptr->aaf) return (FALSE);
 
 	/* Check nearby grids, diagonals first */
 	for (i = 7; i >= 0; i--)
@@ -2154,32 +2133,26 @@ static bool get_moves_aux(int m_idx, int *yp, int *xp)
 		x = x1 + ddx_ddd[i];
 
 		/* Ignore illegal locations */
-		if (!cave[y][x].when) continue;
-
-		/* Ignore ancient locations */
-		if (cave[y][x].when < when) continue;
+		if (!in_bounds(Depth, y, x)) continue;
 
 		/* Ignore distant locations */
-		if (cave[y][x].cost > cost) continue;
+		if (flow->cost[y][x] >= cost) continue;
 
-		/* Save the cost and time */
-		when = cave[y][x].when;
-		cost = cave[y][x].cost;
+		/* Save the cost */
+		cost = flow->cost[y][x];
 
-		/* Hack -- Save the "twiddled" location */
-		(*yp) = py + 16 * ddy_ddd[i];
-		(*xp) = px + 16 * ddx_ddd[i];
+		/* Hack -- Save a location in that direction */
+		(*yp) = y1 + 16 * ddy_ddd[i];
+		(*xp) = x1 + 16 * ddx_ddd[i];
 	}
 
 	/* No legal move (?) */
-	if (!when) return (FALSE);
+	if (cost == flow->cost[y1][x1]) return (FALSE);
 
 	/* Success */
 	return (TRUE);
 }
 
-#endif
-
 
 /*
  * Choose "logical" directions for monster movement
@@ -2232,15 +2205,11 @@ static void get_moves(player_type *p_ptr, int m_idx, int *mm)
 		}
 	}
 
-
-#ifdef MONSTER_FLOW
 	/* Flow towards the player */
-	if (flow_by_sound)
+	else
 	{
-		/* Flow towards the player */
-		(void)get_moves_aux(m_idx, &y2, &x2);
+		(void)get_moves_aux(p_ptr, m_idx, &y2, &x2);
 	}
-#endif
 
 	/* Extract the "pseudo-direction" */
 	y = m_ptr->fy - y2;
@@ -2524,7 +2493,7 @@ static void process_monster(int Ind, int m_idx)
 				m_ptr->csleep -= d;
 
 				/* Notice the "not waking up" */
-				if (p_ptr->mon_vis[m_idx])
+				if (idx_has(p_ptr->mon_vis, m_idx))
 				{
 					/* Hack -- Count the ignores */
 					if (l_ptr->ignore < MAX_UCHAR) l_ptr->ignore++;
@@ -2535,10 +2504,10 @@ static void process_monster(int Ind, int m_idx)
 			else
 			{
 				/* Reset sleep counter */
-				m_ptr->csleep = 0;
+				set_monster_sleep(m_ptr, 0);
 
 				/* Notice the "waking up" */
-				if (p_ptr->mon_vis[m_idx])
+				if (idx_has(p_ptr->mon_vis, m_idx))
 				{
 					char m_name[80];
 
@@ -2588,7 +2557,7 @@ static void process_monster(int Ind, int m_idx)
 			m_ptr->stunned = 0;
 
 			/* Message if visible */
-			if (p_ptr->mon_vis[m_idx])
+			if (idx_has(p_ptr->mon_vis, m_idx))
 			{
 				char m_name[80];
 
@@ -2628,7 +2597,7 @@ static void process_monster(int Ind, int m_idx)
 			m_ptr->confused = 0;
 
 			/* Message if visible */
-			if (p_ptr->mon_vis[m_idx])
+			if (idx_has(p_ptr->mon_vis, m_idx))
 			{
 				char m_name[80];
 
@@ -2661,7 +2630,7 @@ static void process_monster(int Ind, int m_idx)
 			m_ptr->monfear = 0;
 
 			/* Visual note */
-			if (p_ptr->mon_vis[m_idx])
+			if (idx_has(p_ptr->mon_vis, m_idx))
 			{
 				char m_name[80];
 				char m_poss[80];
@@ -2705,7 +2674,7 @@ static void process_monster(int Ind, int m_idx)
 				if (multiply_monster(m_idx))
 				{
 					/* Take note if visible */
-					if (p_ptr->mon_vis[m_idx])
+					if (idx_has(p_ptr->mon_vis, m_idx))
 					{
 						l_ptr->flags2 |= RF2_MULTIPLY;
 
@@ -2742,8 +2711,8 @@ static void process_monster(int Ind, int m_idx)
 	         (randint0(100) < 75))
 	{
 		/* Memorize flags */
-		if (p_ptr->mon_vis[m_idx]) l_ptr->flags1 |= RF1_RAND_50;
-		if (p_ptr->mon_vis[m_idx]) l_ptr->flags1 |= RF1_RAND_25;
+		if (idx_has(p_ptr->mon_vis, m_idx)) l_ptr->flags1 |= RF1_RAND_50;
+		if (idx_has(p_ptr->mon_vis, m_idx)) l_ptr->flags1 |= RF1_RAND_25;
 
 		/* Try four "random" directions */
 		mm[0] = mm[1] = mm[2] = mm[3] = 5;
@@ -2754,7 +2723,7 @@ static void process_monster(int Ind, int m_idx)
 	         (randint0(100) < 50))
 	{
 		/* Memorize flags */
-		if (p_ptr->mon_vis[m_idx]) l_ptr->flags1 |= RF1_RAND_50;
+		if (idx_has(p_ptr->mon_vis, m_idx)) l_ptr->flags1 |= RF1_RAND_50;
 
 		/* Try four "random" directions */
 		mm[0] = mm[1] = mm[2] = mm[3] = 5;
@@ -2765,7 +2734,7 @@ static void process_monster(int Ind, int m_idx)
 	         (randint0(100) < 25))
 	{
 		/* Memorize flags */
-		if (p_ptr->mon_vis[m_idx]) l_ptr->flags1 |= RF1_RAND_25;
+		if (idx_has(p_ptr->mon_vis, m_idx)) l_ptr->flags1 |= RF1_RAND_25;
 
 		/* Try four "random" directions */
 		mm[0] = mm[1] = mm[2] = mm[3] = 5;
@@ -3012,7 +2981,7 @@ static void process_monster(int Ind, int m_idx)
 		    (r_ptr->flags1 & RF1_NEVER_BLOW))
 		{
 			/* Hack -- memorize lack of attacks */
-			if (p_ptr->mon_vis[m_idx]) l_ptr->flags1 |= RF1_NEVER_BLOW;
+			if (idx_has(p_ptr->mon_vis, m_idx)) l_ptr->flags1 |= RF1_NEVER_BLOW;
 
 			/* Do not move */
 			do_move = FALSE;
@@ -3049,7 +3018,7 @@ static void process_monster(int Ind, int m_idx)
 		if (do_move && (r_ptr->flags1 & RF1_NEVER_MOVE))
 		{
 			/* Hack -- memorize lack of attacks */
-			if (p_ptr->mon_vis[m_idx]) l_ptr->flags1 |= RF1_NEVER_MOVE;
+			if (idx_has(p_ptr->mon_vis, m_idx)) l_ptr->flags1 |= RF1_NEVER_MOVE;
 
 			/* Do not move */
 			do_move = FALSE;
@@ -3136,9 +3105,9 @@ static void process_monster(int Ind, int m_idx)
 			everyone_lite_spot(Depth, ny, nx);
 
 			/* Possible disturb */
-			if (p_ptr->mon_vis[m_idx] &&
+			if (idx_has(p_ptr->mon_vis, m_idx) &&
 			    (option_p(p_ptr,DISTURB_MOVE) ||
-			     (p_ptr->mon_los[m_idx] &&
+			     (idx_has(p_ptr->mon_los, m_idx) &&
 			      option_p(p_ptr,DISTURB_NEAR))))
 			{
 				/* Disturb */
@@ -3287,7 +3256,7 @@ static void process_monster(int Ind, int m_idx)
 	  l_ptr = p_ptr->l_list + m_ptr->r_idx;
 
 	/* Learn things from observable monster */
-	if (p_ptr->mon_vis[m_idx])
+	if (idx_has(p_ptr->mon_vis, m_idx))
 	{
 		/* Monster opened a door */
 		if (did_open_door) l_ptr->flags2 |= RF2_OPEN_DOOR;
@@ -3322,7 +3291,7 @@ static void process_monster(int Ind, int m_idx)
 		m_ptr->monfear = 0;
 
 		/* Message if seen */
-		if (p_ptr->mon_vis[m_idx])
+		if (idx_has(p_ptr->mon_vis, m_idx))
 		{
 			char m_name[80];
 
@@ -3373,7 +3342,7 @@ static void process_monster(int Ind, int m_idx)
  
 void process_monsters(void)
 {
-	int			k, i, e, pl;
+	int			k, i, e;
 	int			fx, fy;
 
 	bool		test;
@@ -3403,27 +3372,24 @@ void process_monsters(void)
 			/* Excise the monster */
 			m_fast[k] = m_fast[--m_top];
 
+			/* The index can be reused now */
+			m_free[m_free_num++] = i;
+
 			/* Skip */
 			continue;
 		}
 
 
-		/* Find the closest player */
-		for (pl = 1; pl <= NumPlayers; pl++)
+		/* Find the closest player (on the same dungeon level) */
+		for (p_ptr = p_first_on_depth[m_ptr->dun_depth]; p_ptr; p_ptr = p_ptr->next_on_depth)
 		{
 			int j;
 			bool in_los;
 
-			p_ptr = Players[pl];
-
 			/* Hack -- notice death or departure */
 			if (!p_ptr->alive || p_ptr->death || p_ptr->new_level_flag)
 				continue;
 
-			/* Make sure he's on the same dungeon level */
-			if (p_ptr->dun_depth != m_ptr->dun_depth)
-				continue;
-
 			/* Hack -- Skip him if he's shopping */
 			if (p_ptr->store_num != -1)
 				continue;
@@ -3451,7 +3417,7 @@ void process_monsters(void)
 			}
 			/* Remember this player */
 			dis_to_closest = j;
-			closest = pl;
+			closest = p_ptr->Ind;
 			lowhp = p_ptr->chp;
 			closest_in_los = in_los;
 		}
@@ -3534,19 +3500,6 @@ void process_monsters(void)
 			test = TRUE;
 		}
 
-#ifdef MONSTER_FLOW
-		/* Hack -- Monsters can "smell" the player from far away */
-		/* Note that most monsters have "aaf" of "20" or so */
-		else if (flow_by_sound &&
-		         (cave[py][px].when == cave[fy][fx].when) &&
-		         (cave[fy][fx].cost < MONSTER_FLOW_DEPTH) &&
-		         (cave[fy][fx].cost < r_ptr->aaf))
-		{
-			/* We can "smell" the player */
-			test = TRUE;
-		}
-#endif
-
 		/* Do nothing unless a wanderer */
 		if (!test && !(r_ptr->flags2 & RF2_WANDERER) ) continue;
 
@@ -35,6 +35,52 @@ bool allow_unique_level(int r_idx, int Depth)
 }
 
 
+/*
+ * Add a monster to the list of monsters on its level.
+ *
+ * Every live monster is kept on a doubly-linked list of the monsters
+ * sharing its "dun_depth", starting at "m_first_on_depth[Depth]". This
+ * allows loops which only care about one level to skip the rest of
+ * the "m_list[]" array entirely. Index 0 terminates the list.
+ * The length of each list is kept in "m_num_on_depth[Depth]".
+ */
+void monster_link_depth(int m_idx)
+{
+	monster_type *m_ptr = &m_list[m_idx];
+	int Depth = m_ptr->dun_depth;
+
+	/* Insert at the head */
+	m_ptr->prev_on_depth = 0;
+	m_ptr->next_on_depth = m_first_on_depth[Depth];
+	if (m_ptr->next_on_depth) m_list[m_ptr->next_on_depth].prev_on_depth = m_idx;
+	m_first_on_depth[Depth] = m_idx;
+	m_num_on_depth[Depth]++;
+}
+
+/*
+ * Remove a monster from the list of monsters on its level.
+ */
+void monster_unlink_depth(int m_idx)
+{
+	monster_type *m_ptr = &m_list[m_idx];
+	int Depth = m_ptr->dun_depth;
+
+	/* Fix neighbours */
+	if (m_ptr->prev_on_depth)
+	{
+		m_list[m_ptr->prev_on_depth].next_on_depth = m_ptr->next_on_depth;
+		m_num_on_depth[Depth]--;
+	}
+	else if (m_first_on_depth[Depth] == m_idx)
+	{
+		m_first_on_depth[Depth] = m_ptr->next_on_depth;
+		m_num_on_depth[Depth]--;
+	}
+	if (m_ptr->next_on_depth) m_list[m_ptr->next_on_depth].prev_on_depth = m_ptr->prev_on_depth;
+
+	m_ptr->next_on_depth = m_ptr->prev_on_depth = 0;
+}
+
 /*
  * Delete a monster by index.
  *
@@ -105,6 +151,9 @@ void delete_monster_idx(int i)
 	/* Visual update */
 	everyone_lite_spot(Depth, y, x);
 
+	/* Leave the level */
+	monster_unlink_depth(i);
+
 	/* Wipe the Monster */
 	WIPE(m_ptr, monster_type);
 }
@@ -180,12 +229,12 @@ static void compact_monsters_aux(int i1, int i2)
 	for (Ind = 1; Ind <= NumPlayers; Ind++)
 	{
 
-		Players[Ind]->mon_vis[i2] = Players[Ind]->mon_vis[i1];
-		Players[Ind]->mon_los[i2] = Players[Ind]->mon_los[i1];
-		Players[Ind]->mon_det[i2] = Players[Ind]->mon_det[i1];
+		idx_put(Players[Ind]->mon_vis, i2, idx_has(Players[Ind]->mon_vis, i1));
+		idx_put(Players[Ind]->mon_los, i2, idx_has(Players[Ind]->mon_los, i1));
+		mon_det_move(Players[Ind], i1, i2);
 		
 		/* Hack -- copy hurt flag */
-		Players[Ind]->mon_hrt[i2] = Players[Ind]->mon_hrt[i1];;
+		idx_put(Players[Ind]->mon_hrt, i2, idx_has(Players[Ind]->mon_hrt, i1));
 
 		/* Hack -- Update the target */
 		if (Players[Ind]->target_who == (int)(i1)) Players[Ind]->target_who = i2;
@@ -194,6 +243,11 @@ static void compact_monsters_aux(int i1, int i2)
 		if (Players[Ind]->health_who == (int)(i1)) health_track(Players[Ind], i2);
 	}
 
+	/* Repair the level list */
+	if (m_ptr->prev_on_depth) m_list[m_ptr->prev_on_depth].next_on_depth = i2;
+	else if (m_first_on_depth[Depth] == (int)(i1)) m_first_on_depth[Depth] = i2;
+	if (m_ptr->next_on_depth) m_list[m_ptr->next_on_depth].prev_on_depth = i2;
+
 	/* Hack -- move monster */
 	COPY(&m_list[i2], &m_list[i1], monster_type);
 
@@ -291,8 +345,8 @@ void compact_monsters(int size)
 		m_max--;
 	}
 
-	/* Reset "m_nxt" */
-	m_nxt = m_max;
+	/* No holes left */
+	m_free_num = 0;
 
 
 	/* Reset "m_top" */
@@ -343,7 +397,7 @@ void wipe_m_list(int Depth)
 	}
 
 	/* Reset the monster array */
-	m_nxt = m_max = 1;
+	m_max = 1;
 
 	/* No live monsters */
 	m_top = 0;
@@ -358,13 +412,10 @@ void wipe_m_list(int Depth)
 	health_track(0);
 #endif
 
-	/* Delete all the monsters */
-	for (i = m_max - 1; i >= 1; i--)
+	/* Delete all the monsters on this level */
+	while ((i = m_first_on_depth[Depth]))
 	{
-		monster_type *m_ptr = &m_list[i];
-
-		if (m_ptr->dun_depth == Depth)
-			delete_monster_idx(i);
+		delete_monster_idx(i);
 	}
 
 	/* Compact the monster list */
@@ -379,10 +430,29 @@ void wipe_m_list(int Depth)
  *
  * Note that this function must maintain the special "m_fast"
  * array of indexes of "live" monsters.
+ *
+ * Dead monsters stay in "m_fast" until "process_monsters()" excises
+ * them, which is when their index is pushed on the "m_free" stack.
+ * So an index on the stack is never in "m_fast", and can be reused
+ * right away. (Holes still waiting to be excised can't be reused.)
  */
 s16b m_pop(void)
 {
-	int i, n, k;
+	int i;
+
+
+	/* Reuse a hole */
+	if (m_free_num)
+	{
+		/* Get the index */
+		i = m_free[--m_free_num];
+
+		/* Update "m_fast" */
+		m_fast[m_top++] = i;
+
+		/* Return the index */
+		return (i);
+	}
 
 
 	/* Normal allocation */
@@ -402,47 +472,109 @@ s16b m_pop(void)
 	}
 
 
-	/* Check for some space */
-	for (n = 1; n < MAX_M_IDX; n++)
-	{
-		/* Get next space */
-		i = m_nxt;
+	/* Warn the player */
+	if (server_dungeon) plog("Too many monsters!");
 
-		/* Advance (and wrap) the "next" pointer */
-		if (++m_nxt >= MAX_M_IDX) m_nxt = 1;
+	/* Try not to crash */
+	return (0);
+}
 
-		/* Skip monsters in use */
-		if (m_list[i].r_idx) continue;
 
-		/* Verify space XXX XXX */
-		if (m_top >= MAX_M_IDX) continue;
 
-		/* Verify not allocated */
-		for (k = 0; k < m_top; k++)
-		{
-			/* Hack -- Prevent errors */
-			if (m_fast[k] == i) i = 0;
-		}
 
-		/* Oops XXX XXX */
-		if (!i) continue;
+/*
+ * Cached "prob3" running totals, one per level, see "get_mon_num()".
+ *
+ * Which entries are allowed, and with what weight, only depends on the
+ * level and on "prob2", so the totals are built once per level and a
+ * roll becomes a binary search. Set 0 is used without a
+ * "get_mon_num_hook" (and never goes stale), set 1 is thrown away each
+ * time "get_mon_num_prep()" installs a hook.
+ */
+typedef struct mon_alloc_level mon_alloc_level;
+struct mon_alloc_level
+{
+	u32b stamp;	/* Valid if equal to "mon_alloc_stamp[set]" */
+	s16b num;	/* Entries considered at this level */
+	s32b *total;	/* Running total of "prob3" over those entries */
+};
 
-		/* Update "m_fast" */
-		m_fast[m_top++] = i;
+static mon_alloc_level *mon_alloc_cache[2];
+static u32b mon_alloc_stamp[2] = { 1, 1 };
+static int mon_alloc_hooked = 0;
 
-		/* Use this monster */
-		return (i);
-	}
+/*
+ * Build (if needed) and return the running totals for a level
+ * ("level" is already clamped to -1..MAX_DEPTH-1)
+ */
+static mon_alloc_level *mon_alloc_get(int level)
+{
+	alloc_entry *table = alloc_race_table;
+	mon_alloc_level *ap;
+	monster_race *r_ptr;
+	s32b total = 0;
+	int i;
 
+	/* Allocate the cache */
+	if (!mon_alloc_cache[mon_alloc_hooked])
+		C_MAKE(mon_alloc_cache[mon_alloc_hooked], MAX_DEPTH + 1, mon_alloc_level);
 
-	/* Warn the player */
-	if (server_dungeon) plog("Too many monsters!");
+	ap = &mon_alloc_cache[mon_alloc_hooked][level + 1];
 
-	/* Try not to crash */
-	return (0);
+	/* Still good */
+	if (ap->stamp == mon_alloc_stamp[mon_alloc_hooked]) return (ap);
+
+	/* Allocate the totals (the number of entries per level never changes) */
+	if (!ap->total) C_MAKE(ap->total, alloc_race_size, s32b);
+
+	/* Process probabilities */
+	for (i = 0; i < alloc_race_size; i++)
+	{
+		/* Monsters are sorted by depth */
+		if (table[i].level > level) break;
+
+		/* Access the actual race */
+		r_ptr = &r_info[table[i].index];
+
+		/* Hack -- No town monsters in the dungeon */
+		if ((level > 0) && (table[i].level <= 0)) { ap->total[i] = total; continue; }
+
+		/* Depth Monsters never appear out of depth */
+		/* FIXME: This might cause FORCE_DEPTH monsters to appear out of depth */
+		if ((r_ptr->flags1 & RF1_FORCE_DEPTH) && (r_ptr->level > level)) { ap->total[i] = total; continue; }
+
+		/* Unique Monsters never appear in the wilderness */
+		if ((r_ptr->flags1 & RF1_UNIQUE) && (level < 0)) { ap->total[i] = total; continue; }
+
+		/* Accept */
+		total += table[i].prob2;
+		ap->total[i] = total;
+	}
+
+	ap->num = i;
+	ap->stamp = mon_alloc_stamp[mon_alloc_hooked];
+
+	return (ap);
 }
 
+/*
+ * Find the entry a roll of "value" (0..total-1) lands on
+ */
+static int mon_alloc_find(mon_alloc_level *ap, s32b value)
+{
+	int lo = 0, hi = ap->num - 1;
+
+	/* Find the first entry whose running total exceeds "value" */
+	while (lo < hi)
+	{
+		int mid = (lo + hi) / 2;
 
+		if (ap->total[mid] > value) hi = mid;
+		else lo = mid + 1;
+	}
+
+	return (lo);
+}
 
 
 /*
@@ -452,6 +584,12 @@ errr get_mon_num_prep(void)
 {
 	int i;
 
+	/* Pick the prefix sum cache, see "get_mon_num()" */
+	mon_alloc_hooked = (get_mon_num_hook ? 1 : 0);
+
+	/* Forget whatever the previous hook allowed */
+	if (mon_alloc_hooked) mon_alloc_stamp[1]++;
+
 	/* Scan the allocation table */
 	for (i = 0; i < alloc_race_size; i++)
 	{
@@ -483,9 +621,9 @@ errr get_mon_num_prep(void)
  * Choose a monster race that seems "appropriate" to the given level
  *
  * This function uses the "prob2" field of the "monster allocation table",
- * and various local information, to calculate the "prob3" field of the
- * same table, which is then used to choose an "appropriate" monster, in
- * a relatively efficient manner.
+ * and various local information, to calculate running totals of the
+ * "prob3" weights (cached per level, see "mon_alloc_get()"), which are
+ * then binary searched to choose an "appropriate" monster.
  *
  * Note that "town" monsters will *only* be created in the town, and
  * "normal" monsters will *never* be created in the town, unless the
@@ -515,12 +653,9 @@ s16b get_mon_num(int level)
 {
 	int			i, j, p, d1 = 0, d2 = 0;
 
-	int			r_idx;
+	long		total;
 
-	long		value, total;
-
-	monster_race	*r_ptr;
-	monster_type	*m_ptr;
+	mon_alloc_level	*ap;
 
 	alloc_entry		*table = alloc_race_table;
 
@@ -538,22 +673,7 @@ s16b get_mon_num(int level)
 	}
 
 	/* Limit the total number of townies */
-	j = 0;
-	if (level == 0)
-	{
-		for (i = m_top - 1; i >= 0; i--)
-		{
-			/* Access the index */
-			p = m_fast[i];
-
-			/* Access the monster */
-			m_ptr = &m_list[p];
-			
-			/* Count townies */
-			if (m_ptr->dun_depth == 0) j++;
-		}
-	}
-	if (j > cfg_max_townies) return(0);
+	if ((level == 0) && (m_num_on_depth[0] > cfg_max_townies)) return(0);
 	
 
 	if (level > 0)
@@ -587,80 +707,21 @@ s16b get_mon_num(int level)
 		level += ((d2 < 5) ? d2 : 5);
 	} */
 
-	/* Reset total */
-	total = 0L;
+	/* Every level below zero, or above the deepest monster, looks the same */
+	if (level < -1) level = -1;
+	if (level > MAX_DEPTH - 1) level = MAX_DEPTH - 1;
 
-	/* Process probabilities */
-	for (i = 0; i < alloc_race_size; i++)
-	{
-		/* Monsters are sorted by depth */
-		if (table[i].level > level) break;
-
-
-		/* XXX disabling this 
-		{
-			 ceiling 
-			if (table[i].level > -level) break;
-			 floor 
-			if (table[i].level < level) continue; 
-		}
-		*/
-
-		/* Default */
-		table[i].prob3 = 0;
-
-		/* Hack -- No town monsters in the dungeon */
-		if ((level > 0) && (table[i].level <= 0)) continue;
-
-		/* Access the "r_idx" of the chosen monster */
-		r_idx = table[i].index;
-
-		/* Access the actual race */
-		r_ptr = &r_info[r_idx];
-
-		/* Hack -- "unique" monsters must be "unique" */
-        /*if ((r_ptr->flags1 & RF1_UNIQUE) &&
-		    (r_ptr->cur_num >= r_ptr->max_num))
-		{
-			continue;
-        }*/
-
-		/* Depth Monsters never appear out of depth */
-		/* FIXME: This might cause FORCE_DEPTH monsters to appear out of depth */
-		if ((r_ptr->flags1 & RF1_FORCE_DEPTH) && (r_ptr->level > level))
-		{
-			continue;
-		}
-
-		/* Unique Monsters never appear in the wilderness */
-		if ((r_ptr->flags1 & RF1_UNIQUE) && (level < 0))
-		{
-			continue;
-		}
-
-		/* Accept */
-		table[i].prob3 = table[i].prob2;
-
-		/* Total */
-		total += table[i].prob3;
-	}
+	/* Get the running totals */
+	ap = mon_alloc_get(level);
 
 	/* No legal monsters */
+	if (!ap->num) return (0);
+	total = ap->total[ap->num - 1];
 	if (total <= 0) return (0);
 
 
 	/* Pick a monster */
-	value = randint0(total);
-
-	/* Find the monster */
-	for (i = 0; i < alloc_race_size; i++)
-	{
-		/* Found the entry */
-		if (value < table[i].prob3) break;
-
-		/* Decrement */
-		value = value - table[i].prob3;
-	}
+	i = mon_alloc_find(ap, randint0(total));
 
 
 	/* Power boost */
@@ -673,17 +734,7 @@ s16b get_mon_num(int level)
 		j = i;
 
 		/* Pick a monster */
-		value = randint0(total);
-
-		/* Find the monster */
-		for (i = 0; i < alloc_race_size; i++)
-		{
-			/* Found the entry */
-			if (value < table[i].prob3) break;
-
-			/* Decrement */
-			value = value - table[i].prob3;
-		}
+		i = mon_alloc_find(ap, randint0(total));
 
 		/* Keep the "best" one */
 		if (abs(table[i].level) < abs(table[j].level)) i = j;
@@ -696,17 +747,7 @@ s16b get_mon_num(int level)
 		j = i;
 
 		/* Pick a monster */
-		value = randint0(total);
-
-		/* Find the monster */
-		for (i = 0; i < alloc_race_size; i++)
-		{
-			/* Found the entry */
-			if (value < table[i].prob3) break;
-
-			/* Decrement */
-			value = value - table[i].prob3;
-		}
+		i = mon_alloc_find(ap, randint0(total));
 
 		/* Keep the "best" one */
 		if (abs(table[i].level) < abs(table[j].level)) i = j;
@@ -733,11 +774,8 @@ void display_monlist(player_type *p_ptr)
 	monster_race *r_ptr;
 	player_type  *q_ptr;
 
-	u16b *race_counts;
-
-
-	/* Allocate the array */
-	C_MAKE(race_counts, z_info->r_max, u16b);
+	/* Shared counters, every race counted below is zeroed again */
+	u16b *race_counts = r_count_s;
 
 	/* Iterate over mon_list */
 	for (idx = 1; idx < m_max; idx++)
@@ -745,7 +783,7 @@ void display_monlist(player_type *p_ptr)
 		m_ptr = &m_list[idx];
 
 		/* Only visible monsters */
-		if (!p_ptr->mon_vis[idx]) continue;
+		if (!idx_has(p_ptr->mon_vis, idx)) continue;
 
 		/* Hack -- ignore mimics, unless DM */
 		if (m_ptr->mimic_k_idx && !(p_ptr->dm_flags & DM_SEE_MONSTERS)) continue;
@@ -762,7 +800,7 @@ void display_monlist(player_type *p_ptr)
 		m_ptr = &m_list[idx];
 
 		/* Only visible monsters */
-		if (!p_ptr->mon_vis[idx]) continue;
+		if (!idx_has(p_ptr->mon_vis, idx)) continue;
 
 		/* Do each race only once */
 		if (!race_counts[m_ptr->r_idx]) continue;
@@ -812,7 +850,7 @@ void display_monlist(player_type *p_ptr)
 	for (idx = 1; idx <= NumPlayers; idx++)
 	{
 		/* Only visible players */
-		if (!p_ptr->play_vis[idx]) continue;
+		if (!idx_has(p_ptr->play_vis, idx)) continue;
 
 		q_ptr = Players[idx];
 
@@ -837,9 +875,6 @@ void display_monlist(player_type *p_ptr)
 		text_out("\n");
 	}
 
-	/* Free the race counters */
-	FREE(race_counts);
-
 	/* Done */
 	text_out_done();
 }
@@ -909,7 +944,7 @@ void monster_desc(player_type *p_ptr, char *desc, int m_idx, int mode)
 	if (p_ptr)
 	{
 		/* Can we "see" it (exists + forced, or visible + not unforced) */
-		seen = (m_ptr && ((mode & 0x80) || (!(mode & 0x40) && p_ptr->mon_vis[m_idx])));
+		seen = (m_ptr && ((mode & 0x80) || (!(mode & 0x40) && idx_has(p_ptr->mon_vis, m_idx))));
 	}
 	else
 	{
@@ -1218,18 +1253,28 @@ void reveal_mimic(int m_idx)
 		/* Skip players on different depth */
 		if (p_ptr->dun_depth != m_ptr->dun_depth) continue;
 		/* Skip players who don't see this monster */
-		if (!p_ptr->mon_vis[m_idx]) continue;
+		if (!idx_has(p_ptr->mon_vis, m_idx)) continue;
 
 		lite_spot(p_ptr, m_ptr->fy, m_ptr->fx);
 		p_ptr->window |= PW_ITEMLIST | PW_MONLIST;
 	}
 }
 
+/*
+ * Put a monster to sleep, or wake it up if "v" is 0.  A sleeping monster
+ * doesn't count towards time bubbles, so those may change.
+ */
+void set_monster_sleep(monster_type *m_ptr, int v)
+{
+	if (!m_ptr->csleep != !v) invalidate_time_factors(m_ptr->dun_depth);
+	m_ptr->csleep = v;
+}
+
 /* Clear all visibility and tracking flags. */
 void forget_monster(player_type *p_ptr, int m_idx, bool deleted)
 {
 	/* Was visible? Update monster list then */
-	if (p_ptr->mon_vis[m_idx]) p_ptr->window |= (PW_MONLIST);
+	if (idx_has(p_ptr->mon_vis, m_idx)) p_ptr->window |= (PW_MONLIST);
 
 	/* Remove cursor tracking */
 	if (p_ptr->cursor_who == m_idx)
@@ -1249,14 +1294,101 @@ void forget_monster(player_type *p_ptr, int m_idx, bool deleted)
 	if (p_ptr->health_who == m_idx) health_track(p_ptr, 0);
 
 	/* Clear all visibility flags */
-	p_ptr->mon_vis[m_idx] = FALSE;
-	p_ptr->mon_los[m_idx] = FALSE;
-	p_ptr->mon_det[m_idx] = 0;
+	idx_off(p_ptr->mon_vis, m_idx);
+	idx_off(p_ptr->mon_los, m_idx);
+	mon_det_set(p_ptr, m_idx, 0);
 
 	/* Remove hurt flag (only if monster is completely dead) */
-	if (deleted) p_ptr->mon_hrt[m_idx] = FALSE;
+	if (deleted) idx_off(p_ptr->mon_hrt, m_idx);
 }
 
+/*
+ * Monster "detection" is rare and short-lived, so instead of keeping
+ * a counter for every possible monster, each player keeps a small
+ * list of timers. The "mon_det" bitset tells which monsters are in
+ * the list, so "update_mon()" can check it cheaply.
+ */
+byte mon_det_turns(player_type *p_ptr, int m_idx)
+{
+	int i;
+
+	/* Not detected */
+	if (!idx_has(p_ptr->mon_det, m_idx)) return 0;
+
+	for (i = 0; i < p_ptr->mon_det_num; i++)
+	{
+		if (p_ptr->mon_det_list[i].m_idx == m_idx)
+			return p_ptr->mon_det_list[i].turns;
+	}
+
+	/* Paranoia */
+	return 0;
+}
+
+/*
+ * Set the detection timer for a monster (0 forgets it)
+ */
+void mon_det_set(player_type *p_ptr, int m_idx, int turns)
+{
+	mon_det_type *old;
+	int i = p_ptr->mon_det_num;
+
+	/* Find the old timer */
+	if (idx_has(p_ptr->mon_det, m_idx))
+	{
+		for (i = 0; i < p_ptr->mon_det_num; i++)
+		{
+			if (p_ptr->mon_det_list[i].m_idx == m_idx) break;
+		}
+	}
+
+	/* Forget */
+	if (turns <= 0)
+	{
+		/* Move the last timer into the hole */
+		if (i < p_ptr->mon_det_num)
+		{
+			p_ptr->mon_det_list[i] = p_ptr->mon_det_list[--p_ptr->mon_det_num];
+		}
+		idx_off(p_ptr->mon_det, m_idx);
+		return;
+	}
+
+	/* New timer */
+	if (i == p_ptr->mon_det_num)
+	{
+		/* Grow the list */
+		if (p_ptr->mon_det_num == p_ptr->mon_det_max)
+		{
+			old = p_ptr->mon_det_list;
+			p_ptr->mon_det_max = (p_ptr->mon_det_max ? p_ptr->mon_det_max * 2 : 16);
+			C_MAKE(p_ptr->mon_det_list, p_ptr->mon_det_max, mon_det_type);
+			if (old)
+			{
+				C_COPY(p_ptr->mon_det_list, old, p_ptr->mon_det_num, mon_det_type);
+				FREE(old);
+			}
+		}
+		p_ptr->mon_det_list[p_ptr->mon_det_num++].m_idx = m_idx;
+		idx_on(p_ptr->mon_det, m_idx);
+	}
+
+	p_ptr->mon_det_list[i].turns = MIN(turns, 255);
+}
+
+/*
+ * Move a detection timer from one monster index to another
+ * (see "compact_monsters_aux()")
+ */
+void mon_det_move(player_type *p_ptr, int i1, int i2)
+{
+	int turns = mon_det_turns(p_ptr, i1);
+
+	mon_det_set(p_ptr, i1, 0);
+	mon_det_set(p_ptr, i2, turns);
+}
+
+
 /*
  * This function updates the monster record of the given monster
  *
@@ -1321,8 +1453,6 @@ void update_mon(int m_idx, bool dist)
 
 	int Depth = m_ptr->dun_depth;
 
-	int Ind = m_ptr->closest_player;
-
 	/* Seen at all */
 	bool flag = FALSE;
 
@@ -1341,22 +1471,15 @@ void update_mon(int m_idx, bool dist)
 	bool do_invisible = FALSE;
 	bool do_cold_blood = FALSE;
 
-	/* Check for each player */
-	for (Ind = 1; Ind <= NumPlayers; Ind++)
+	/* Check for each player on this depth (players on other depths
+	 * forgot about this monster when they left, see player_change_depth()) */
+	for (p_ptr = p_first_on_depth[Depth]; p_ptr; p_ptr = p_ptr->next_on_depth)
 	{
-		p_ptr = Players[Ind];
 		l_ptr = p_ptr->l_list + m_ptr->r_idx;
 		/* Reset the flags */
 		flag = easy = hard = FALSE;
 		nearby = FALSE;
 
-		/* If he's not on this depth, skip him */
-		if (p_ptr->dun_depth != Depth)
-		{
-			forget_monster(p_ptr, m_idx, FALSE);
-			continue;
-		}
-
 		/* If our wilderness level has been deallocated, stop here...
 		 * we are "detatched" monsters.
 		 */
@@ -1452,16 +1575,16 @@ void update_mon(int m_idx, bool dist)
 		}
 
 		/* HACK ! - Detected via magical means, counts as "hard" */
-		if (p_ptr->mon_det[m_idx]) hard = flag = TRUE;
+		if (idx_has(p_ptr->mon_det, m_idx)) hard = flag = TRUE;
 
 		/* The monster is now visible */
 		if (flag)
 		{
 			/* It was previously unseen */
-			if (!p_ptr->mon_vis[m_idx])
+			if (!idx_has(p_ptr->mon_vis, m_idx))
 			{
 				/* Mark as visible */
-				p_ptr->mon_vis[m_idx] = TRUE;
+				idx_on(p_ptr->mon_vis, m_idx);
 
 				/* Draw the monster */
 				lite_spot(p_ptr, fy, fx);
@@ -1496,10 +1619,10 @@ void update_mon(int m_idx, bool dist)
 		else
 		{
 			/* It was previously seen */
-			if (p_ptr->mon_vis[m_idx])
+			if (idx_has(p_ptr->mon_vis, m_idx))
 			{
 				/* Mark as not visible */
-				p_ptr->mon_vis[m_idx] = FALSE;
+				idx_off(p_ptr->mon_vis, m_idx);
 
 				/* Erase the monster */
 				lite_spot(p_ptr, fy, fx);
@@ -1520,10 +1643,13 @@ void update_mon(int m_idx, bool dist)
 		if (easy || (hard && nearby))
 		{
 			/* Change */
-			if (!p_ptr->mon_los[m_idx])
+			if (!idx_has(p_ptr->mon_los, m_idx))
 			{
 				/* Mark as easily visible */
-				p_ptr->mon_los[m_idx] = TRUE;
+				idx_on(p_ptr->mon_los, m_idx);
+
+				/* Time bubble may change */
+				invalidate_time_factors(p_ptr->dun_depth);
 
 				/* Disturb on appearance */
 				if (option_p(p_ptr,DISTURB_NEAR)) disturb(p_ptr, 1, 0);
@@ -1534,10 +1660,13 @@ void update_mon(int m_idx, bool dist)
 		else
 		{
 			/* Change */
-			if (p_ptr->mon_los[m_idx])
+			if (idx_has(p_ptr->mon_los, m_idx))
 			{
 				/* Mark as not easily visible */
-				p_ptr->mon_los[m_idx] = FALSE;
+				idx_off(p_ptr->mon_los, m_idx);
+
+				/* Time bubble may change */
+				invalidate_time_factors(p_ptr->dun_depth);
 
 				/* Disturb on disappearance */
 				if (option_p(p_ptr,DISTURB_NEAR)) disturb(p_ptr, 1, 0);
@@ -1556,21 +1685,25 @@ void update_mon(int m_idx, bool dist)
  */
 void update_monsters(bool dist)
 {
-	int          i;
+	int          i, m_idx;
 
 	/* Efficiency -- Clear multihued flag */
 	scan_monsters = FALSE;
 
-	/* Update each (live) monster */
-	for (i = 1; i < m_max; i++)
+	/* Only levels with players on them matter */
+	for (i = 1; i <= NumPlayers; i++)
 	{
-		monster_type *m_ptr = &m_list[i];
+		player_type *p_ptr = Players[i];
 
-		/* Skip dead monsters */
-		if (!m_ptr->r_idx) continue;
+		/* Visit each level once (by it's first player) */
+		if (p_first_on_depth[p_ptr->dun_depth] != p_ptr) continue;
 
-		/* Update the monster */
-		update_mon(i, dist);
+		/* Update each monster on it */
+		for (m_idx = m_first_on_depth[p_ptr->dun_depth]; m_idx; m_idx = m_list[m_idx].next_on_depth)
+		{
+			/* Update the monster */
+			update_mon(m_idx, dist);
+		}
 	}
 }
 
@@ -1682,10 +1815,10 @@ void update_player(player_type *q_ptr)
 		if (flag)
 		{
 			/* It was previously unseen */
-			if (!p_ptr->play_vis[q_ptr->Ind])
+			if (!idx_has(p_ptr->play_vis, q_ptr->Ind))
 			{
 				/* Mark as visible */
-				p_ptr->play_vis[q_ptr->Ind] = TRUE;
+				idx_on(p_ptr->play_vis, q_ptr->Ind);
 
 				/* Draw the player */
 				lite_spot(p_ptr, py, px);
@@ -1706,10 +1839,10 @@ void update_player(player_type *q_ptr)
 		else
 		{
 			/* It was previously seen */
-			if (p_ptr->play_vis[q_ptr->Ind])
+			if (idx_has(p_ptr->play_vis, q_ptr->Ind))
 			{
 				/* Mark as not visible */
-				p_ptr->play_vis[q_ptr->Ind] = FALSE;
+				idx_off(p_ptr->play_vis, q_ptr->Ind);
 
 				/* Erase the player */
 				lite_spot(p_ptr, py, px);
@@ -1730,10 +1863,13 @@ void update_player(player_type *q_ptr)
 		if (easy || (hard && nearby))
 		{
 			/* Change */
-			if (!p_ptr->play_los[q_ptr->Ind])
+			if (!idx_has(p_ptr->play_los, q_ptr->Ind))
 			{
 				/* Mark as easily visible */
-				p_ptr->play_los[q_ptr->Ind] = TRUE;
+				idx_on(p_ptr->play_los, q_ptr->Ind);
+
+				/* Time bubble may change */
+				invalidate_time_factors(p_ptr->dun_depth);
 
 				/* Disturb on appearance */
 				if (option_p(p_ptr,DISTURB_NEAR) && check_hostile(p_ptr, q_ptr))
@@ -1748,10 +1884,13 @@ void update_player(player_type *q_ptr)
 		else
 		{
 			/* Change */
-			if (p_ptr->play_los[q_ptr->Ind])
+			if (idx_has(p_ptr->play_los, q_ptr->Ind))
 			{
 				/* Mark as not easily visible */
-				p_ptr->play_los[q_ptr->Ind] = FALSE;
+				idx_off(p_ptr->play_los, q_ptr->Ind);
+
+				/* Time bubble may change */
+				invalidate_time_factors(p_ptr->dun_depth);
 
 				/* Disturb on disappearance */
 				if (option_p(p_ptr,DISTURB_NEAR) && check_hostile(p_ptr, q_ptr))
@@ -1900,6 +2039,9 @@ static bool place_monster_one(int Depth, int y, int x, int r_idx, bool slp)
 	m_ptr->fx = x;
 	m_ptr->dun_depth = Depth;
 
+	/* Enter the level */
+	monster_link_depth(c_ptr->m_idx);
+
 
 	/* Hack -- Count the monsters on the level */
 	r_ptr->cur_num++;
@@ -1961,10 +2103,10 @@ static bool place_monster_one(int Depth, int y, int x, int r_idx, bool slp)
 
 	for (Ind = 1; Ind <= NumPlayers; Ind++)
 	{
-		Players[Ind]->mon_los[c_ptr->m_idx] = FALSE;
-		Players[Ind]->mon_vis[c_ptr->m_idx] = FALSE;
-		Players[Ind]->mon_det[c_ptr->m_idx] = 0;
-		Players[Ind]->mon_hrt[c_ptr->m_idx] = FALSE;		
+		idx_off(Players[Ind]->mon_los, c_ptr->m_idx);
+		idx_off(Players[Ind]->mon_vis, c_ptr->m_idx);
+		mon_det_set(Players[Ind], c_ptr->m_idx, 0);
+		idx_off(Players[Ind]->mon_hrt, c_ptr->m_idx);		
 	}
 
 	/* Update the monster */
@@ -478,12 +478,16 @@ int stream_char_raw(player_type *p_ptr, int st, int y, int x, byte a, char c, by
 	/* Do not send streams not subscribed to */
 	if (!p_ptr->stream_hgt[st]) return 1;
 
+	/* Hack -- queued grids must not overwrite this one later */
+	if (p_ptr->tile_dirty_any && st == DUNGEON_STREAM_p(p_ptr))
+		stream_flush_tiles(p_ptr);
+
 	/* Header + Body (with or without transperancy) */
 	l = ((y << 8) & 0x7F00) | (x & 0x00FF) | 0x8000;
 	if (stream->flag & SF_TRANSPARENT)
-		n = cq_printf(&ct->wbuf, "%c%d%c%c%c%c", stream->pkt, l, a, c, a, c);
+		n = cq_pack_stream_char_trn(&ct->wbuf, stream->pkt, l, a, c, a, c);
 	else
-		n = cq_printf(&ct->wbuf, "%c%d%c%c", stream->pkt, l, a, c);
+		n = cq_pack_stream_char(&ct->wbuf, stream->pkt, l, a, c);
 	if (n <= 0)
 	{
 		client_withdraw(ct);
@@ -497,13 +501,17 @@ int stream_char(player_type *p_ptr, int st, int y, int x)
 {
 	connection_type *ct;
 	const stream_type *stream = &streams[st];
-	cave_view_type *source = p_ptr->stream_cave[st] + y * MAX_WID;
+	cave_view_type *source;
 	u16b l;
 	int n;
 
 	/* Programmer error */
 	if (y > 127 || x > 255) { printf("stream_char is limited to y <= 127, x <= 255, you are using y %d, x %d\n", y, x); return -1; }
 
+	/* Text streams read from the (growable) "info" buffer */
+	if (p_ptr->stream_cave[st] != &p_ptr->scr_info[0][0] && !text_info_row(p_ptr, y)) return -1;
+	source = p_ptr->stream_cave[st] + y * MAX_WID;
+
 	/* Paranoia -- do not send to closed connection */
 	if (p_ptr->conn == -1) return -1;
 	ct = Conn[p_ptr->conn];
@@ -514,9 +522,9 @@ int stream_char(player_type *p_ptr, int st, int y, int x)
 	/* Header + Body (with or without transperancy) */
 	l = ((y << 8) & 0x7F00) | (x & 0x00FF) | 0x8000;
 	if (stream->flag & SF_TRANSPARENT)
-		n = cq_printf(&ct->wbuf, "%c%ud%c%c%c%c", stream->pkt, l, source[x].a, source[x].c, p_ptr->trn_info[y][x].a, p_ptr->trn_info[y][x].c);
+		n = cq_pack_stream_char_trn(&ct->wbuf, stream->pkt, l, source[x].a, source[x].c, p_ptr->trn_info[y][x].a, p_ptr->trn_info[y][x].c);
 	else
-		n = cq_printf(&ct->wbuf, "%c%ud%c%c", stream->pkt, l, source[x].a, source[x].c);
+		n = cq_pack_stream_char(&ct->wbuf, stream->pkt, l, source[x].a, source[x].c);
 	if (n <= 0)
 	{
 		client_withdraw(ct);
@@ -536,11 +544,14 @@ int stream_line_as(player_type *p_ptr, int st, int y, int as_y)
 	s16b	cols = p_ptr->stream_wid[st];
 	byte	rle = stream->rle;
 	byte	trn = (stream->flag & SF_TRANSPARENT);
-	source 	= p_ptr->stream_cave[st] + y * MAX_WID;
 
 	/* Programmer error */
 	if (as_y & 0x8000) { printf("stream_line is limited to y <= 32767, you are using y %d\n", as_y); return -1; }
 
+	/* Text streams read from the (growable) "info" buffer */
+	if (p_ptr->stream_cave[st] != &p_ptr->scr_info[0][0] && !text_info_row(p_ptr, y)) return -1;
+	source 	= p_ptr->stream_cave[st] + y * MAX_WID;
+
 	/* Paranoia -- do not send to closed connection */
 	if (p_ptr->conn == -1) return -1;
 	ct = Conn[p_ptr->conn];
@@ -551,11 +562,23 @@ int stream_line_as(player_type *p_ptr, int st, int y, int as_y)
 	/* Paranoia -- respect row bounds */
 	if (as_y >= p_ptr->stream_hgt[st] && !(stream->flag & SF_MAXBUFFER)) return -1;
 
+	/* Big redraws can fill the buffer in one go; hand what we have
+	 * to the kernel now, so only a client that is genuinely not
+	 * reading gets withdrawn below. */
+	if (cq_len(&ct->wbuf) >= CONN_HIGH_WATER(ct))
+	{
+		if (connection_flush(ct) < 0)
+		{
+			if (connection_input_hook) connection_input_hook(ct, NULL, -1);
+			ct->close = 1;
+		}
+	}
+
 	/* Begin cq "transaction" */
 	start_pos = ct->wbuf.len;
 
 	/* Packet header */
-	if (cq_printf(&ct->wbuf, "%c%ud", stream->pkt, as_y) <= 0)
+	if (cq_pack_stream_line(&ct->wbuf, stream->pkt, as_y) <= 0)
 	{
 		ct->wbuf.len = start_pos; /* rewind */
 		client_withdraw(ct);
@@ -577,6 +600,120 @@ int stream_line_as(player_type *p_ptr, int st, int y, int as_y)
 	return 1;
 }
 
+/*
+ * Mark a dungeon grid (in screen coordinates) as changed. Instead of
+ * sending each grid as it changes, we collect them here and send them
+ * in one go from "stream_flush_tiles()", at handle_stuff() time.
+ *
+ * Old clients get the grid right away.
+ */
+int stream_tile_later(player_type *p_ptr, int y, int x)
+{
+	if (!client_version_atleast(p_ptr->version, 1,5,4))
+	{
+		return stream_char(p_ptr, DUNGEON_STREAM_p(p_ptr), y, x);
+	}
+
+	p_ptr->tile_dirty[y][x >> 5] |= (1UL << (x & 31));
+	p_ptr->tile_dirty_any = TRUE;
+
+	/* Ok */
+	return 1;
+}
+
+/*
+ * Longest run of unchanged grids we'd rather resend than start a new
+ * packet for (a span header costs as much as 2-3 encoded grids).
+ */
+#define TILE_SPAN_GAP	2
+
+/*
+ * Send all the grids marked by "stream_tile_later()". Each row is cut
+ * into spans of changed grids, and every span goes out as a single
+ * PKT_STREAM_SPAN packet, encoded with the stream's own RLE method.
+ * Lone grids are sent as usual.
+ */
+int stream_flush_tiles(player_type *p_ptr)
+{
+	connection_type *ct;
+	int st = DUNGEON_STREAM_p(p_ptr);
+	const stream_type *stream = &streams[st];
+	byte trn = (stream->flag & SF_TRANSPARENT);
+	int y, x, x1, x2, start_pos;
+	u32b *row;
+
+	/* Nothing to do */
+	if (!p_ptr->tile_dirty_any) return 1;
+	p_ptr->tile_dirty_any = FALSE;
+
+	/* Paranoia -- do not send to closed connection */
+	if (p_ptr->conn == -1 || !p_ptr->stream_hgt[st])
+	{
+		C_WIPE(p_ptr->tile_dirty, MAX_HGT * ((MAX_WID + 31) / 32), u32b);
+		return -1;
+	}
+	ct = Conn[p_ptr->conn];
+
+	for (y = 0; y < MAX_HGT; y++)
+	{
+		row = p_ptr->tile_dirty[y];
+
+		for (x = 0; x < MAX_WID; x++)
+		{
+			/* Skip clean words quickly */
+			if (!row[x >> 5])
+			{
+				x |= 31;
+				continue;
+			}
+			if (!(row[x >> 5] & (1UL << (x & 31)))) continue;
+
+			/* Find the end of this span */
+			x1 = x2 = x;
+			for (x++; x < MAX_WID && x - x2 <= TILE_SPAN_GAP + 1; x++)
+			{
+				if (row[x >> 5] & (1UL << (x & 31))) x2 = x;
+			}
+			x = x2;
+
+			/* Lone grid */
+			if (x1 == x2)
+			{
+				stream_char(p_ptr, st, y, x1);
+				continue;
+			}
+
+			/* Begin cq "transaction" */
+			start_pos = ct->wbuf.len;
+
+			/* Packet header */
+			if (cq_pack_stream_span(&ct->wbuf, PKT_STREAM_SPAN, stream->pkt, y, x1, x2 - x1 + 1) <= 0)
+			{
+				ct->wbuf.len = start_pos; /* rewind */
+				client_withdraw(ct);
+			}
+			/* (Secondary) */
+			if (trn && cq_printc(&ct->wbuf, stream->rle, &p_ptr->trn_info[y][x1], x2 - x1 + 1) <= 0)
+			{
+				ct->wbuf.len = start_pos; /* rewind */
+				client_withdraw(ct);
+			}
+			/* Packet body */
+			if (cq_printc(&ct->wbuf, stream->rle, p_ptr->stream_cave[st] + y * MAX_WID + x1, x2 - x1 + 1) <= 0)
+			{
+				ct->wbuf.len = start_pos; /* rewind */
+				client_withdraw(ct);
+			}
+		}
+
+		/* Done with this row */
+		C_WIPE(row, (MAX_WID + 31) / 32, u32b);
+	}
+
+	/* Ok */
+	return 1;
+}
+
 int send_term_info(player_type *p_ptr, byte flag, u16b line)
 {
 	connection_type *ct;
@@ -729,12 +866,25 @@ int send_item_tester_info(connection_type *ct, int id)
 	return 1;
 }
 
+/*
+ * Client isn't reading fast enough (see "CONN_CONGESTED()"). Whatever
+ * can wait -- redraws, sub-windows, changed map grids -- is then held
+ * back in the "redraw"/"window"/"tile_dirty" flags, which coalesce
+ * until the queue drains; pure eye candy is dropped.
+ */
+bool player_congested(player_type *p_ptr)
+{
+	if (p_ptr->conn == -1) return FALSE;
+	return (CONN_CONGESTED(Conn[p_ptr->conn]) ? TRUE : FALSE);
+}
+
 int send_slash_fx(player_type *p_ptr, byte y, byte x, byte dir, byte fx)
 {
 	connection_type *ct;
 	if (p_ptr->conn == -1) return -1;
 	ct = Conn[p_ptr->conn];
 	if (!p_ptr->supports_slash_fx) return 1;
+	if (CONN_CONGESTED(ct)) return 0;
 	if (cq_printf(&ct->wbuf, "%c" "%c%c" "%c%b", PKT_SLASH_FX, y, x, dir, fx) <= 0)
 	{
 		/* No space in buffer, but we don't really care for this packet */
@@ -748,6 +898,7 @@ int send_air_char(player_type *p_ptr, byte y, byte x, char a, char c, u16b delay
 	connection_type *ct;
 	if (p_ptr->conn == -1) return -1;
 	ct = Conn[p_ptr->conn];
+	if (CONN_CONGESTED(ct)) return 0;
 	if (cq_printf(&ct->wbuf, "%c" "%c%c" "%c%c" "%ud%ud", PKT_AIR, y, x, a, c, delay, fade) <= 0)
 	{
 		/* No space in buffer, but we don't really care for this packet */
@@ -940,7 +1091,7 @@ int send_message(player_type *p_ptr, cptr msg, u16b typ)
 	/* Clip end of msg if too long */
 	my_strcpy(buf, msg, MSG_LEN);
 
-	if (!cq_printf(&ct->wbuf, "%c%ud%S", PKT_MESSAGE, typ, buf))
+	if (!cq_pack_message(&ct->wbuf, PKT_MESSAGE, typ, buf))
 	{
 		client_withdraw(ct);
 	}
@@ -1475,7 +1626,8 @@ int recv_settings(connection_type *ct, player_type *p_ptr) {
 		switch (i)
 		{
 			case 0: p_ptr->use_graphics  = val; break;
-			case 3: p_ptr->hitpoint_warn = (byte_hack)val; break;
+			case 3: p_ptr->hitpoint_warn = (byte_hack)val;
+				invalidate_time_factors(p_ptr->dun_depth); break;
 			case 5: p_ptr->supports_slash_fx = (bool)val; break;
 			default: break;
 		}
@@ -1557,6 +1709,10 @@ int recv_stream_size(connection_type *ct, player_type *p_ptr) {
 		p_ptr->stream_wid[st] = x;
 		p_ptr->stream_hgt[st] = y;
 
+		/* The client starts this window over */
+		if (st == STREAM_MONLIST_TEXT) p_ptr->sent_monlist.known = FALSE;
+		if (st == STREAM_ITEMLIST_TEXT) p_ptr->sent_itemlist.known = FALSE;
+
 		/* Subscribe / Unsubscribe */
 		if (y)
 		{
@@ -1760,6 +1916,7 @@ int recv_redraw(connection_type *ct, player_type *p_ptr)
 		p_ptr->store_num = -1; //TODO: check if this is really necessary/okay?
 		p_ptr->redraw |= (PR_BASIC | PR_EXTRA | PR_MAP | PR_FLOOR);
 		p_ptr->window |= (PW_SPELL | PW_PLAYER | PW_MAP | PW_MONLIST | PW_ITEMLIST);
+		p_ptr->sent_monlist.known = p_ptr->sent_itemlist.known = FALSE;
 		p_ptr->update |= (PU_BONUS | PU_VIEW | PU_MANA | PU_HP);
 		p_ptr->redraw_inven |= (0xFFFFFFFFFFFFFFFFLL);
 		//TODO: check if there are more generic ways to apply those
@@ -18,6 +18,7 @@
 #define ONE_SECOND	1000000 /* 1 million "microseconds" */
 
 int ticks = 0;
+static int ticks_passed = 0; /* Game turns in this pass of handle_timers() */
 
 /* List heads */
 eptr first_connection = NULL;
@@ -50,6 +51,7 @@ static int		(*handlers[256])(connection_type *ct, player_type *p_ptr);
 static cptr		schemes[256];
 
 bool client_names_ok(char *nick_name, char *real_name, char *host_name);
+void post_process_players(void);
 
 /* Scheme to use for parsing next packet */ 
 cptr next_scheme = NULL;
@@ -129,16 +131,16 @@ void reindex_player(int oldPInd, int newPInd)
 		}
 
 		/* Visibility flags */
-		p_ptr->play_vis[newPInd] = p_ptr->play_vis[oldPInd];
-		p_ptr->play_los[newPInd] = p_ptr->play_los[oldPInd];
+		idx_put(p_ptr->play_vis, newPInd, idx_has(p_ptr->play_vis, oldPInd));
+		idx_put(p_ptr->play_los, newPInd, idx_has(p_ptr->play_los, oldPInd));
 		p_ptr->play_det[newPInd] = p_ptr->play_det[oldPInd];
 
 		/* Vanishing player was visible, update list */
-		if (newPInd == 0 && p_ptr->play_vis[oldPInd]) p_ptr->window |= (PW_MONLIST);
+		if (newPInd == 0 && idx_has(p_ptr->play_vis, oldPInd)) p_ptr->window |= (PW_MONLIST);
 
 		/* And forget about old index */
-		p_ptr->play_vis[oldPInd] = FALSE;
-		p_ptr->play_los[oldPInd] = FALSE;
+		idx_off(p_ptr->play_vis, oldPInd);
+		idx_off(p_ptr->play_los, oldPInd);
 		p_ptr->play_det[oldPInd] = 0;
 	}
 }
@@ -173,6 +175,9 @@ int player_enter(int ind)
 	/* Hack -- store own index! */
 	p_ptr->Ind = PInd;
 
+	/* Appear on the level list */
+	player_link_depth(p_ptr);
+
 	/* Hack -- join '#public' channel */
 	send_channel(p_ptr, CHAN_JOIN, 0, DEFAULT_CHANNEL);
 
@@ -279,6 +284,9 @@ int player_leave(int p_idx)
 	int ind = Get_Conn[p_idx];
 	int saved = 0;
 
+	/* Disappear from the level list */
+	player_unlink_depth(p_ptr);
+
 	/* Be paranoid */
 	if (cave[p_ptr->dun_depth])
 	{
@@ -420,18 +428,577 @@ void player_drop(int ind)
 /* Fast termination of connection (used by shutdown routine) */
 
 
+/*
+ * Input recording and replay
+ *
+ * "-w<file>" logs everything that makes one run of the server differ
+ * from another: the RNG state right after seeding, the savefiles that
+ * get loaded, and every chunk of bytes read from a player connection,
+ * in order with the network passes, game turns and second ticks.
+ *
+ * "-y<file>" feeds such a log back through the very same handlers, using
+ * connections without sockets (their output is simply dropped).  Turns
+ * are paced in real time, or run back to back with "-q".  Every few
+ * turns the recording also stores a hash of the game state, which the
+ * replay checks, so a replay is both a benchmark and a correctness test.
+ *
+ * Replay against a copy of the save directory as it was when recording
+ * started, as players leaving during the replay get saved there.
+ */
+#define REC_RNG 	'G'	/* RNG state after seeding */
+#define REC_FILE	'F'	/* Savefile loaded (name, hash) */
+#define REC_ACCEPT	'A'	/* New connection (serial, address) */
+#define REC_READ	'R'	/* Bytes read (serial, length, data) */
+#define REC_HANGUP	'X'	/* Peer has hung up (serial) */
+#define REC_WFAIL	'W'	/* Send has failed (serial) */
+#define REC_PASS	'N'	/* End of a pass over the connections */
+#define REC_TICK	'T'	/* Game turn (tick number) */
+#define REC_SECOND	'S'	/* Second tick */
+#define REC_POST	'P'	/* post_process_players() */
+#define REC_HASH	'H'	/* State hash (tick number, hash) */
+
+#define REC_MAGIC	"MAngband input log\n"
+#define REC_HASH_TICKS	64	/* Turns between state hashes */
+
+#define REPLAY_OFF	0
+#define REPLAY_RECORD	1
+#define REPLAY_PLAY	2
+
+static int replay_mode = REPLAY_OFF;
+static ang_file *replay_fd = NULL;
+static int replay_serial = 0;	/* Last connection number given out */
+static u32b replay_ticks = 0;	/* Turns recorded or replayed */
+
+static char **replay_files = NULL;	/* Savefiles seen so far */
+static int replay_files_num = 0;
+static int replay_files_max = 0;
+
+/* Savefiles loaded in the recording, which the replay has yet to load */
+#define REPLAY_FILES_WAIT	16
+static char *replay_wait_name[REPLAY_FILES_WAIT];
+static u32b replay_wait_hash[REPLAY_FILES_WAIT];
+static int replay_wait_num = 0;
+
+static u32b replay_hashes = 0;	/* State hashes compared */
+static u32b replay_mismatches = 0;	/* ... which did not match */
+static u32b replay_diverged = 0;	/* Differences of any kind */
+
+/* The last event read */
+static byte rev_code;
+static u32b rev_serial, rev_value;
+static char rev_data[PD_LARGE_BUFFER + 1];
+static int rev_len;
+static bool rev_peeked = FALSE;
+
+/* FNV-1a */
+static u32b replay_hash(u32b h, const byte *buf, int len)
+{
+	while (len--)
+	{
+		h ^= *buf++;
+		h *= 16777619UL;
+	}
+	return (h);
+}
+static u32b replay_hash32(u32b h, u32b v)
+{
+	byte b[4];
+	b[0] = (byte)v; b[1] = (byte)(v >> 8); b[2] = (byte)(v >> 16); b[3] = (byte)(v >> 24);
+	return replay_hash(h, b, 4);
+}
+
+/*
+ * Hash the parts of the game state that go wrong first when a replay
+ * goes astray: the RNG, the turn, and every player, monster and object.
+ */
+static u32b replay_state_hash(void)
+{
+	u32b h = 2166136261UL;
+	int i;
+
+	h = replay_hash32(h, (u32b)turn.era);
+	h = replay_hash32(h, (u32b)turn.turn);
+	h = replay_hash32(h, Rand_place);
+	for (i = 0; i < RAND_DEG; i++) h = replay_hash32(h, Rand_state[i]);
+
+	h = replay_hash32(h, NumPlayers);
+	for (i = 1; i <= NumPlayers; i++)
+	{
+		player_type *p_ptr = Players[i];
+
+		h = replay_hash(h, (byte*)p_ptr->name, strlen(p_ptr->name));
+		h = replay_hash32(h, p_ptr->dun_depth);
+		h = replay_hash32(h, (p_ptr->py << 16) | p_ptr->px);
+		h = replay_hash32(h, p_ptr->chp);
+		h = replay_hash32(h, p_ptr->exp);
+		h = replay_hash32(h, p_ptr->au);
+		h = replay_hash32(h, p_ptr->energy);
+	}
+	for (i = 1; i < m_max; i++)
+	{
+		monster_type *m_ptr = &m_list[i];
+
+		if (!m_ptr->r_idx) continue;
+		h = replay_hash32(h, i);
+		h = replay_hash32(h, m_ptr->r_idx);
+		h = replay_hash32(h, m_ptr->dun_depth);
+		h = replay_hash32(h, (m_ptr->fy << 16) | m_ptr->fx);
+		h = replay_hash32(h, m_ptr->hp);
+	}
+	for (i = 1; i < o_max; i++)
+	{
+		object_type *o_ptr = &o_list[i];
+
+		if (!o_ptr->k_idx) continue;
+		h = replay_hash32(h, i);
+		h = replay_hash32(h, o_ptr->k_idx);
+		h = replay_hash32(h, o_ptr->dun_depth);
+		h = replay_hash32(h, (o_ptr->iy << 16) | o_ptr->ix);
+		h = replay_hash32(h, o_ptr->number);
+	}
+
+	return (h);
+}
+
+/*
+ * Write an event (numbers are little-endian)
+ */
+static void record_u32(byte *buf, u32b v)
+{
+	buf[0] = (byte)v; buf[1] = (byte)(v >> 8); buf[2] = (byte)(v >> 16); buf[3] = (byte)(v >> 24);
+}
+static void record_event(byte code, u32b serial, u32b value, const char *data, int len)
+{
+	/* Note -- REC_HASH keeps the hash in "serial" */
+	byte buf[12];
+	int n = 0;
+
+	buf[n++] = code;
+	switch (code)
+	{
+		case REC_ACCEPT: case REC_READ: case REC_HANGUP: case REC_WFAIL:
+			record_u32(buf + n, serial); n += 4;
+			break;
+		case REC_TICK: case REC_HASH: case REC_FILE:
+			record_u32(buf + n, value); n += 4;
+			break;
+	}
+	if (code == REC_HASH) { record_u32(buf + n, serial); n += 4; }
+	if (data) { buf[n++] = (byte)len; buf[n++] = (byte)(len >> 8); }
+
+	file_write(replay_fd, (char*)buf, n);
+	if (data) file_write(replay_fd, data, len);
+}
+
+/*
+ * Read the next event (or, after "replay_peek()", the same one again).
+ * Returns FALSE at the end of the log.
+ */
+static bool replay_read(byte *buf, int n)
+{
+	return (file_read(replay_fd, (char*)buf, n) == (size_t)n);
+}
+static u32b replay_u32(byte *buf)
+{
+	return (buf[0] | (buf[1] << 8) | (buf[2] << 16) | ((u32b)buf[3] << 24));
+}
+static bool replay_next(void)
+{
+	byte buf[8];
+	bool data = FALSE;
+
+	if (rev_peeked)
+	{
+		rev_peeked = FALSE;
+		return (TRUE);
+	}
+
+	if (!replay_read(&rev_code, 1)) return (FALSE);
+	rev_serial = rev_value = 0;
+	rev_len = 0;
+
+	switch (rev_code)
+	{
+		case REC_READ:
+			data = TRUE;
+			/* Fall through */
+		case REC_HANGUP: case REC_WFAIL:
+			if (!replay_read(buf, 4)) return (FALSE);
+			rev_serial = replay_u32(buf);
+			break;
+		case REC_ACCEPT:
+			if (!replay_read(buf, 4)) return (FALSE);
+			rev_serial = replay_u32(buf);
+			data = TRUE;
+			break;
+		case REC_FILE:
+			data = TRUE;
+			/* Fall through */
+		case REC_TICK:
+			if (!replay_read(buf, 4)) return (FALSE);
+			rev_value = replay_u32(buf);
+			break;
+		case REC_HASH:
+			if (!replay_read(buf, 8)) return (FALSE);
+			rev_value = replay_u32(buf);
+			rev_serial = replay_u32(buf + 4);
+			break;
+		case REC_RNG:
+			rev_len = 2 + RAND_DEG * 4;
+			if (!replay_read((byte*)rev_data, rev_len)) return (FALSE);
+			break;
+		case REC_PASS: case REC_SECOND: case REC_POST:
+			break;
+		default:
+			quit(format("Replay log is damaged (event %d)", rev_code));
+	}
+
+	if (data)
+	{
+		if (!replay_read(buf, 2)) return (FALSE);
+		rev_len = buf[0] | (buf[1] << 8);
+		if (rev_len > (int)sizeof(rev_data) - 1) quit("Replay log is damaged (length)");
+		if (!replay_read((byte*)rev_data, rev_len)) return (FALSE);
+		rev_data[rev_len] = '\0';
+	}
+
+	return (TRUE);
+}
+static bool replay_peek(void)
+{
+	if (!replay_next()) return (FALSE);
+	rev_peeked = TRUE;
+	return (TRUE);
+}
+
+/* Watch the bytes read from recorded connections */
+static void record_input(connection_type *ct, char *buf, int len)
+{
+	if (!ct->serial) return;
+
+	if (len > 0) record_event(REC_READ, ct->serial, 0, buf, len);
+	else record_event(len ? REC_WFAIL : REC_HANGUP, ct->serial, 0, NULL, 0);
+}
+
+/*
+ * Start recording to, or replaying from, the files given on the
+ * command line.  Must be called before "play_game()".
+ */
+void replay_init(void)
+{
+	char buf[sizeof(REC_MAGIC)];
+
+	if (arg_record_file && arg_replay_file) quit("Cannot record and replay at the same time");
+
+	if (arg_record_file)
+	{
+		replay_fd = file_open(arg_record_file, MODE_WRITE, FTYPE_RAW);
+		if (!replay_fd) quit(format("Cannot write %s", arg_record_file));
+		file_write(replay_fd, REC_MAGIC, strlen(REC_MAGIC));
+		replay_mode = REPLAY_RECORD;
+		connection_input_hook = record_input;
+		plog(format("Recording input to %s", arg_record_file));
+	}
+	else if (arg_replay_file)
+	{
+		replay_fd = file_open(arg_replay_file, MODE_READ, -1);
+		if (!replay_fd) quit(format("Cannot read %s", arg_replay_file));
+		if (!replay_read((byte*)buf, strlen(REC_MAGIC)) || strncmp(buf, REC_MAGIC, strlen(REC_MAGIC)))
+			quit(format("%s is not an input log", arg_replay_file));
+		replay_mode = REPLAY_PLAY;
+		plog(format("Replaying input from %s%s", arg_replay_file, arg_replay_fast ? " (fast)" : ""));
+	}
+}
+
+/*
+ * Note a savefile about to be loaded.  Only the first load of each
+ * file counts, later ones read what this very run has saved.
+ */
+void replay_savefile(cptr path)
+{
+	char buf[1024];
+	cptr name;
+	ang_file *fd;
+	u32b hash = 2166136261UL;
+	size_t n;
+	int i;
+
+	if (!replay_mode) return;
+
+	/* Compare names only, the replay may use another directory */
+	name = strrchr(path, PATH_SEP[0]);
+	name = (name ? name + 1 : path);
+
+	for (i = 0; i < replay_files_num; i++)
+	{
+		if (streq(replay_files[i], name)) return;
+	}
+	if (replay_files_num == replay_files_max)
+	{
+		char **new_files;
+		replay_files_max = MAX(16, replay_files_max * 2);
+		C_MAKE(new_files, replay_files_max, char*);
+		if (replay_files_num) C_COPY(new_files, replay_files, replay_files_num, char*);
+		if (replay_files) FREE(replay_files);
+		replay_files = new_files;
+	}
+	replay_files[replay_files_num++] = (char*)string_make(name);
+
+	/* Hash it (an empty hash for missing files) */
+	fd = file_open(path, MODE_READ, -1);
+	if (fd)
+	{
+		while ((n = file_read(fd, buf, sizeof(buf))) > 0 && n != (size_t)-1)
+			hash = replay_hash(hash, (byte*)buf, n);
+		file_close(fd);
+	}
+	else hash = 0;
+
+	if (replay_mode == REPLAY_RECORD)
+	{
+		record_event(REC_FILE, 0, hash, name, strlen(name));
+		return;
+	}
+
+	/* Find it among the loads seen in this pass */
+	for (i = 0; i < replay_wait_num; i++)
+	{
+		if (streq(replay_wait_name[i], name)) break;
+	}
+	if (i < replay_wait_num)
+	{
+		if (replay_wait_hash[i] != hash)
+		{
+			plog(format("Replay: savefile %s differs from the recording", name));
+			replay_diverged++;
+		}
+		string_free(replay_wait_name[i]);
+		replay_wait_num--;
+		replay_wait_name[i] = replay_wait_name[replay_wait_num];
+		replay_wait_hash[i] = replay_wait_hash[replay_wait_num];
+		return;
+	}
+
+	/* Or right ahead (while starting up) */
+	if (!replay_peek() || rev_code != REC_FILE || !streq(rev_data, name))
+	{
+		plog(format("Replay: savefile %s was not loaded in the recording", name));
+		replay_diverged++;
+		return;
+	}
+	replay_next();
+	if (rev_value != hash)
+	{
+		plog(format("Replay: savefile %s differs from the recording", name));
+		replay_diverged++;
+	}
+}
+
+/* Complain about savefiles the replay should have loaded by now */
+static void replay_files_missed(void)
+{
+	while (replay_wait_num)
+	{
+		replay_wait_num--;
+		plog(format("Replay: savefile %s was loaded in the recording only", replay_wait_name[replay_wait_num]));
+		string_free(replay_wait_name[replay_wait_num]);
+		replay_diverged++;
+	}
+}
+
+/*
+ * The RNG has just been seeded.  Remember its state, or restore the
+ * recorded one.
+ */
+void replay_rng(void)
+{
+	byte buf[2 + RAND_DEG * 4];
+	int i;
+
+	if (replay_mode == REPLAY_RECORD)
+	{
+		buf[0] = (byte)Rand_place; buf[1] = (byte)(Rand_place >> 8);
+		for (i = 0; i < RAND_DEG; i++) record_u32(buf + 2 + i * 4, Rand_state[i]);
+		record_event(REC_RNG, 0, 0, NULL, 0);
+		file_write(replay_fd, (char*)buf, sizeof(buf));
+	}
+	else if (replay_mode == REPLAY_PLAY)
+	{
+		/* Skip savefiles we did not load */
+		while (replay_next() && rev_code == REC_FILE)
+		{
+			plog(format("Replay: savefile %s was loaded in the recording only", rev_data));
+			replay_diverged++;
+		}
+		if (rev_code != REC_RNG) quit("Replay log is damaged (no RNG state)");
+
+		Rand_quick = FALSE;
+		Rand_place = (byte)rev_data[0] | ((byte)rev_data[1] << 8);
+		for (i = 0; i < RAND_DEG; i++) Rand_state[i] = replay_u32((byte*)rev_data + 2 + i * 4);
+	}
+}
+
+/* Find a replayed connection */
+static connection_type *replay_conn(u32b serial)
+{
+	eptr iter;
+
+	for (iter = first_connection; iter; iter = iter->next)
+	{
+		connection_type *ct = (connection_type*)iter->data2;
+		if (ct->serial == (int)serial) return (ct);
+	}
+
+	return (NULL);
+}
+
+/*
+ * Feed the log back to the game, instead of "network_loop()"
+ */
+static void replay_loop(void)
+{
+	connection_type *ct;
+	connection_type *wfail[64];
+	int wfail_num = 0;
+	bool passed = FALSE;
+	micro start, tick_len = ONE_SECOND / cfg_fps, wait, p50, p99, max, peak;
+	long elapsed;
+
+	start = clock_micro();
+	tick_start();
+
+	while (replay_next())
+	{
+		switch (rev_code)
+		{
+			case REC_ACCEPT:
+			{
+				eptr new_connection = add_connection(first_connection, -1, hub_read, hub_close);
+				if (!first_connection) first_connection = new_connection;
+				ct = new_connection->data2;
+				ct->serial = rev_serial;
+				my_strcpy(ct->host_addr, rev_data, sizeof(ct->host_addr));
+				break;
+			}
+			case REC_READ:
+				if (!(ct = replay_conn(rev_serial))) break;
+				if (cq_nwrite(&ct->rbuf, rev_data, rev_len) <= 0) ct->close = 1;
+				break;
+			case REC_HANGUP:
+				if ((ct = replay_conn(rev_serial))) ct->close = 1;
+				break;
+			case REC_WFAIL:
+				if (!(ct = replay_conn(rev_serial))) break;
+				/* Failed while sending the replies of the pass */
+				if (!passed && wfail_num < 64) wfail[wfail_num++] = ct;
+				else ct->close = 1;
+				break;
+			case REC_PASS:
+				first_connection = handle_connections(first_connection);
+				if (wfail_num)
+				{
+					while (wfail_num) wfail[--wfail_num]->close = 1;
+					first_connection = handle_connections(first_connection);
+				}
+				tick_phase(TICK_NETWORK);
+				ticks_passed = 0;
+				passed = TRUE;
+				break;
+			case REC_TICK:
+				if (rev_value != replay_ticks + 1)
+					quit(format("Replay log is damaged (turn %lu after %lu)", (unsigned long)rev_value, (unsigned long)replay_ticks));
+				dungeon_tick(0, NULL);
+
+				/* Keep to the clock */
+				if (!arg_replay_fast)
+				{
+					wait = start + (micro)replay_ticks * tick_len - clock_micro();
+					if (wait > 0) network_pause(wait);
+					tick_start();
+				}
+				break;
+			case REC_SECOND:
+				second_tick(0, NULL);
+				break;
+			case REC_POST:
+				replay_files_missed();
+				post_process_players();
+				tick_phase(TICK_COMMANDS);
+				passed = FALSE;
+				break;
+			case REC_HASH:
+				replay_hashes++;
+				if (replay_state_hash() != rev_serial)
+				{
+					if (!replay_mismatches) plog(format("Replay: game state differs from the recording at turn %lu", (unsigned long)rev_value));
+					replay_mismatches++;
+					replay_diverged++;
+				}
+				break;
+			case REC_FILE:
+				/* Wait for the replay to load it */
+				if (replay_wait_num == REPLAY_FILES_WAIT) replay_files_missed();
+				replay_wait_name[replay_wait_num] = (char*)string_make(rev_data);
+				replay_wait_hash[replay_wait_num] = rev_value;
+				replay_wait_num++;
+				break;
+		}
+	}
+
+	replay_files_missed();
+
+	/* Report */
+	elapsed = (long)(clock_micro() - start);
+	tick_stats(TICK_TOTAL, &p50, &p99, &max, &peak);
+	plog(format("Replay: %lu turns in %ld.%03ld sec, %ld turns per second",
+		(unsigned long)replay_ticks, elapsed / 1000000, (elapsed / 1000) % 1000,
+		(long)((double)replay_ticks * 1000000.0 / MAX(elapsed, 1))));
+	plog(format("Replay: turn p50 %ld usec, p99 %ld, max %ld, %lu overruns",
+		(long)p50, (long)p99, (long)peak, (unsigned long)tick_overruns));
+	plog(format("Replay: %lu of %lu state hashes matched",
+		(unsigned long)(replay_hashes - replay_mismatches), (unsigned long)replay_hashes));
+
+	quit(replay_diverged ? "Replay diverged from the recording" : NULL);
+}
+
+/* Finish the log */
+static void replay_close(void)
+{
+	int i;
+
+	if (replay_fd) file_close(replay_fd);
+	replay_fd = NULL;
+	replay_mode = REPLAY_OFF;
+	connection_input_hook = NULL;
+
+	for (i = 0; i < replay_files_num; i++) string_free(replay_files[i]);
+	if (replay_files) FREE(replay_files);
+	replay_files = NULL;
+	replay_files_num = replay_files_max = 0;
+}
+
 /* Init */
 void setup_network_server()
 {
+	if (cfg_tick_trace) tick_trace_open(cfg_tick_trace);
+
+	/** Prepare FD_SETS **/
+	network_reset();
+
+	/* Replay -- no timers, no sockets */
+	if (replay_mode == REPLAY_PLAY)
+	{
+		alloc_server_memory();
+		setup_tables(handlers, schemes);
+		return;
+	}
+
 	/** Add timers **/
 	/* Dungeon Turn */
 	first_timer = add_timer(NULL, (ONE_SECOND / cfg_fps), (callback)dungeon_tick);
 	/* Every Second */
 	add_timer(first_timer, (ONE_SECOND), (callback)second_tick);
 
-	/** Prepare FD_SETS **/
-	network_reset();
-
 	/** Add UDP */
 	/* Meta-server */
 	first_sender = add_sender(NULL, cfg_meta_address, 8800, ONE_SECOND * 4, report_to_meta);
@@ -500,16 +1067,38 @@ void network_loop()
 #ifdef DEBUG
 	plog("Serving with delicious DEBUG cheeze!");
 #endif
+	if (replay_mode == REPLAY_PLAY) replay_loop();
 	while (1)
 	{
+		micro sleep;
+
+		tick_start();
+
 		first_listener = handle_listeners(first_listener);
 		first_connection = handle_connections(first_connection);
 		first_sender = handle_senders(first_sender, static_timer(1));
+		tick_phase(TICK_NETWORK);
+		if (replay_mode == REPLAY_RECORD) record_event(REC_PASS, 0, 0, NULL, 0);
+
+		ticks_passed = 0;
 		first_timer = handle_timers(first_timer, static_timer(0));
 
+		/* Start measuring time spent until the pause */
+		static_timer(2);
+
+		if (replay_mode == REPLAY_RECORD) record_event(REC_POST, 0, 0, NULL, 0);
 		post_process_players(); /* Execute all commands */
+		tick_phase(TICK_COMMANDS);
 
-		network_pause(2000); /* 0.002 ms "sleep" */
+		/* Send what this pass produced right away */
+		flush_connections(first_connection);
+
+		/* Sleep until the next timer is due (or some socket is ready) */
+		sleep = timers_delay(first_timer);
+		if (first_sender) sleep = MIN(sleep, senders_delay(first_sender));
+		sleep -= static_timer(2);
+
+		network_pause(MAX(sleep, 0));
 	}
 }
 
@@ -526,6 +1115,10 @@ void close_network_server()
 	e_release_all(first_connection, 0, 1);
 	e_release_all(first_sender, 0, 1);
 
+	/* Finish the tick trace and the input log */
+	tick_trace_open(NULL);
+	replay_close();
+
 	/* Release memory */
 	free_server_memory();
 }
@@ -659,6 +1252,8 @@ int second_tick(int data1, data data2) {
 
 	/* plog("A Second Passed"); */ ticks = 0;
 
+	if (replay_mode == REPLAY_RECORD) record_event(REC_SECOND, 0, 0, NULL, 0);
+
 	/* Update shutdown timer */
 	if (shutdown_timer) 
 	{
@@ -699,8 +1294,18 @@ int second_tick(int data1, data data2) {
 int dungeon_tick(int data1, data data2) {
 	/* plog("The Clock Ticked"); */ ticks++;
 
+	replay_ticks++;
+	if (replay_mode == REPLAY_RECORD) record_event(REC_TICK, 0, replay_ticks, NULL, 0);
+
 	/* Game Turn */
 	dungeon();
+
+	/* Measure it (a second turn in the same pass is catching up) */
+	tick_finish(ticks_passed++ > 0);
+
+	/* Leave a checkpoint */
+	if (replay_mode == REPLAY_RECORD && !(replay_ticks % REC_HASH_TICKS))
+		record_event(REC_HASH, replay_state_hash(), replay_ticks, NULL, 0);
 	return 2;
 }
 					/* data1 is (int)fd */
@@ -712,6 +1317,14 @@ int accept_client(int data1, data data2) {
 	new_connection = add_connection(first_connection, fd, hub_read, hub_close);
 	if (!first_connection) first_connection = new_connection;
 
+	/* Record it */
+	if (replay_mode == REPLAY_RECORD)
+	{
+		connection_type *ct = new_connection->data2;
+		ct->serial = ++replay_serial;
+		record_event(REC_ACCEPT, ct->serial, 0, ct->host_addr, strlen(ct->host_addr));
+	}
+
 	/* Disable Nagle's algorithm */
 	denaglefd(fd);   
 
@@ -1215,19 +1828,19 @@ u16b connection_type_ok(u16b conntype)
  * WebSocket (RFC6455) Interface.
  */
 
-/* Add websocket frame header and then send bytes as-is. */
+/* Fill websocket frame header for the next "wframe" bytes of "wbuf".
+ * The body is then sent as-is, straight from the buffer. */
 int websocket_send(int data1, data data2)
 {
 	static bool initialized = FALSE;
 	static cq tmp_buf;
-	int i, n, header_len;
+	int n;
 	connection_type *ct = data2;
-	char* mesg = (char*) ct->uptr;
 	int len;
 
 	/* Prepare frame header */
 	bool FIN = TRUE;
-	bool RSV1, RSV2, RSV3 = FALSE;
+	bool RSV1 = FALSE, RSV2 = FALSE, RSV3 = FALSE;
 	byte OPCODE = 0x02;
 	char first_byte =
 		(FIN ? 0x80 : 0)
@@ -1236,7 +1849,7 @@ int websocket_send(int data1, data data2)
 		| (RSV3 ? 1 << 4 : 0)
 		| (OPCODE & 0x0F);
 
-	len = cq_len(&ct->wbuf);
+	len = ct->wframe;
 	if (!len) return 0;
 
 	if (!initialized)
@@ -1250,19 +1863,9 @@ int websocket_send(int data1, data data2)
 	cq_printf(&tmp_buf, "%uv", len);
 
 	/* Dump header */
-	header_len = cq_len(&tmp_buf);
-	n = cq_read(&tmp_buf, &mesg[0], PD_LARGE_BUFFER);
-	if (n < header_len)
-	{
-		return -1;
-	}
-	/* Dump body */
-	n = cq_read(&ct->wbuf, &mesg[n], PD_LARGE_BUFFER);
-	if (n < len)
-	{
-		return -1;
-	}
-	return n + header_len;
+	n = cq_len(&tmp_buf);
+	if (n > (int)sizeof(ct->whdr)) return -1;
+	return cq_read(&tmp_buf, &ct->whdr[0], n);
 }
 
 
@@ -110,8 +110,8 @@ static void excise_object_idx(int o_idx)
 		/* No one can see it anymore */
 		for (i = 1; i <= NumPlayers; i++)
 		{
-			if (Players[i]->obj_vis[o_idx]) Players[i]->window |= (PW_ITEMLIST);
-			Players[i]->obj_vis[o_idx] = FALSE;
+			if (idx_has(Players[i]->obj_vis, o_idx)) Players[i]->window |= (PW_ITEMLIST);
+			idx_off(Players[i]->obj_vis, o_idx);
 		}
 	}
 }
@@ -297,7 +297,7 @@ static void compact_objects_aux(int i1, int i2)
 
 	/* Copy the visibility flags for each player */
 	for (Ind = 1; Ind <= NumPlayers; Ind++)
-		Players[Ind]->obj_vis[i2] = Players[Ind]->obj_vis[i1];
+		idx_put(Players[Ind]->obj_vis, i2, idx_has(Players[Ind]->obj_vis, i1));
 
 	/* Hack -- move object */
 	COPY(&o_list[i2], &o_list[i1], object_type);
@@ -344,8 +344,8 @@ void compact_objects(int size)
 			o_max--;
 		}
 
-		/* Reset "o_nxt" */
-		o_nxt = o_max;
+		/* No holes left */
+		o_free_num = 0;
 
 		/* Reset "o_top" */
 		o_top = 0;
@@ -529,20 +529,20 @@ void wipe_o_list(int Depth)
  *
  * Note that this function must maintain the special "o_fast"
  * array of pointers to "live" objects.
+ *
+ * Dead objects are pushed on the "o_free" stack when "process_objects()"
+ * excises them from "o_fast", see "m_pop()".
  */
 s16b o_pop(void)
 {
-	int i, n, k;
+	int i;
 
 
-	/* Initial allocation */
-	if (o_max < MAX_O_IDX)
+	/* Reuse a hole */
+	if (o_free_num)
 	{
-		/* Get next space */
-		i = o_max;
-
-		/* Expand object array */
-		o_max++;
+		/* Get the index */
+		i = o_free[--o_free_num];
 
 		/* Update "o_fast" */
 		o_fast[o_top++] = i;
@@ -552,30 +552,14 @@ s16b o_pop(void)
 	}
 
 
-	/* Check for some space */
-	for (n = 1; n < MAX_O_IDX; n++)
+	/* Initial allocation */
+	if (o_max < MAX_O_IDX)
 	{
 		/* Get next space */
-		i = o_nxt;
-
-		/* Advance (and wrap) the "next" pointer */
-		if (++o_nxt >= MAX_O_IDX) o_nxt = 1;
-
-		/* Skip objects in use */
-		if (o_list[i].k_idx) continue;
-
-		/* Verify space XXX XXX */
-		if (o_top >= MAX_O_IDX) continue;
-
-		/* Verify not allocated */
-		for (k = 0; k < o_top; k++)
-		{
-			/* Hack -- Prevent errors */
-			if (o_fast[k] == i) i = 0;
-		}
+		i = o_max;
 
-		/* Oops XXX XXX */
-		if (!i) continue;
+		/* Expand object array */
+		o_max++;
 
 		/* Update "o_fast" */
 		o_fast[o_top++] = i;
@@ -594,6 +578,90 @@ s16b o_pop(void)
 
 
 
+/*
+ * Cached "prob3" running totals, one per level, see "get_obj_num()"
+ * and "mon_alloc_get()". Kinds allowed while opening a chest get their
+ * own row of levels.
+ */
+typedef struct obj_alloc_level obj_alloc_level;
+struct obj_alloc_level
+{
+	u32b stamp;	/* Valid if equal to "obj_alloc_stamp[set]" */
+	s16b num;	/* Entries considered at this level */
+	s32b *total;	/* Running total of "prob3" over those entries */
+};
+
+static obj_alloc_level *obj_alloc_cache[2];
+static u32b obj_alloc_stamp[2] = { 1, 1 };
+static int obj_alloc_hooked = 0;
+
+/*
+ * Build (if needed) and return the running totals for a level
+ * ("level" is already clamped to -1..MAX_DEPTH-1)
+ */
+static obj_alloc_level *obj_alloc_get(int level)
+{
+	alloc_entry *table = alloc_kind_table;
+	obj_alloc_level *ap;
+	object_kind *k_ptr;
+	s32b total = 0;
+	int i;
+
+	/* Allocate the cache */
+	if (!obj_alloc_cache[obj_alloc_hooked])
+		C_MAKE(obj_alloc_cache[obj_alloc_hooked], 2 * (MAX_DEPTH + 1), obj_alloc_level);
+
+	ap = &obj_alloc_cache[obj_alloc_hooked][(opening_chest ? MAX_DEPTH + 1 : 0) + level + 1];
+
+	/* Still good */
+	if (ap->stamp == obj_alloc_stamp[obj_alloc_hooked]) return (ap);
+
+	/* Allocate the totals */
+	if (!ap->total) C_MAKE(ap->total, alloc_kind_size, s32b);
+
+	/* Process probabilities */
+	for (i = 0; i < alloc_kind_size; i++)
+	{
+		/* Objects are sorted by depth */
+		if (table[i].level > level) break;
+
+		/* Access the actual kind */
+		k_ptr = &k_info[table[i].index];
+
+		/* Hack -- prevent embedded chests */
+		if (opening_chest && (k_ptr->tval == TV_CHEST)) { ap->total[i] = total; continue; }
+
+		/* Accept */
+		total += table[i].prob2;
+		ap->total[i] = total;
+	}
+
+	ap->num = i;
+	ap->stamp = obj_alloc_stamp[obj_alloc_hooked];
+
+	return (ap);
+}
+
+/*
+ * Find the entry a roll of "value" (0..total-1) lands on
+ */
+static int obj_alloc_find(obj_alloc_level *ap, s32b value)
+{
+	int lo = 0, hi = ap->num - 1;
+
+	/* Find the first entry whose running total exceeds "value" */
+	while (lo < hi)
+	{
+		int mid = (lo + hi) / 2;
+
+		if (ap->total[mid] > value) hi = mid;
+		else lo = mid + 1;
+	}
+
+	return (lo);
+}
+
+
 /*
  * Apply a "object restriction function" to the "object allocation table"
  */
@@ -604,6 +672,12 @@ errr get_obj_num_prep(void)
 	/* Get the entry */
 	alloc_entry *table = alloc_kind_table;
 
+	/* Pick the prefix sum cache, see "get_obj_num()" */
+	obj_alloc_hooked = (get_obj_num_hook ? 1 : 0);
+
+	/* Forget whatever the previous hook allowed */
+	if (obj_alloc_hooked) obj_alloc_stamp[1]++;
+
 	/* Scan the allocation table */
 	for (i = 0; i < alloc_kind_size; i++)
 	{
@@ -632,9 +706,9 @@ errr get_obj_num_prep(void)
  * Choose an object kind that seems "appropriate" to the given level
  *
  * This function uses the "prob2" field of the "object allocation table",
- * and various local information, to calculate the "prob3" field of the
- * same table, which is then used to choose an "appropriate" object, in
- * a relatively efficient manner.
+ * and various local information, to calculate running totals of the
+ * "prob3" weights (cached per level, see "obj_alloc_get()"), which are
+ * then binary searched to choose an "appropriate" object.
  *
  * It is (slightly) more likely to acquire an object of the given level
  * than one of a lower level.  This is done by choosing several objects
@@ -647,11 +721,9 @@ s16b get_obj_num(int level)
 {
 	int			i, j, p;
 
-	int			k_idx;
-
-	long		value, total;
+	long		total;
 
-	object_kind		*k_ptr;
+	obj_alloc_level	*ap;
 
 	alloc_entry		*table = alloc_kind_table;
 
@@ -668,50 +740,21 @@ s16b get_obj_num(int level)
 	}
 
 
-	/* Reset total */
-	total = 0L;
-
-	/* Process probabilities */
-	for (i = 0; i < alloc_kind_size; i++)
-	{
-		/* Objects are sorted by depth */
-		if (table[i].level > level) break;
-
-		/* Default */
-		table[i].prob3 = 0;
-
-		/* Access the index */
-		k_idx = table[i].index;
-
-		/* Access the actual kind */
-		k_ptr = &k_info[k_idx];
-
-		/* Hack -- prevent embedded chests */
-		if (opening_chest && (k_ptr->tval == TV_CHEST)) continue;
-
-		/* Accept */
-		table[i].prob3 = table[i].prob2;
+	/* Every level below zero, or above the deepest object, looks the same */
+	if (level < -1) level = -1;
+	if (level > MAX_DEPTH - 1) level = MAX_DEPTH - 1;
 
-		/* Total */
-		total += table[i].prob3;
-	}
+	/* Get the running totals */
+	ap = obj_alloc_get(level);
 
 	/* No legal objects */
+	if (!ap->num) return (0);
+	total = ap->total[ap->num - 1];
 	if (total <= 0) return (0);
 
 
 	/* Pick an object */
-	value = randint0(total);
-
-	/* Find the object */
-	for (i = 0; i < alloc_kind_size; i++)
-	{
-		/* Found the entry */
-		if (value < table[i].prob3) break;
-
-		/* Decrement */
-		value = value - table[i].prob3;
-	}
+	i = obj_alloc_find(ap, randint0(total));
 
 
 	/* Power boost */
@@ -724,17 +767,7 @@ s16b get_obj_num(int level)
 		j = i;
 
 		/* Pick a object */
-		value = randint0(total);
-
-		/* Find the monster */
-		for (i = 0; i < alloc_kind_size; i++)
-		{
-			/* Found the entry */
-			if (value < table[i].prob3) break;
-
-			/* Decrement */
-			value = value - table[i].prob3;
-		}
+		i = obj_alloc_find(ap, randint0(total));
 
 		/* Keep the "best" one */
 		if (table[i].level < table[j].level) i = j;
@@ -747,17 +780,7 @@ s16b get_obj_num(int level)
 		j = i;
 
 		/* Pick a object */
-		value = randint0(total);
-
-		/* Find the object */
-		for (i = 0; i < alloc_kind_size; i++)
-		{
-			/* Found the entry */
-			if (value < table[i].prob3) break;
-
-			/* Decrement */
-			value = value - table[i].prob3;
-		}
+		i = obj_alloc_find(ap, randint0(total));
 
 		/* Keep the "best" one */
 		if (table[i].level < table[j].level) i = j;
@@ -3577,7 +3600,7 @@ bool place_specific_object(int Depth, int y1, int x1, object_type *forge, int le
 				for (i = 1; i <= NumPlayers; i++)
 				{
 					/* He can't see it */
-					Players[i]->obj_vis[o_idx] = FALSE;
+					idx_off(Players[i]->obj_vis, o_idx);
 				}
 			
 				
@@ -3731,7 +3754,7 @@ object_type* place_object(int Depth, int y, int x, bool good, bool great, byte o
 		for (i = 1; i <= NumPlayers; i++)
 		{
 			/* He can't see it */
-			Players[i]->obj_vis[o_idx] = FALSE;
+			idx_off(Players[i]->obj_vis, o_idx);
 		}
 
 		/* Add origin */
@@ -3917,7 +3940,7 @@ void place_gold(int Depth, int y, int x)
 		for (j = 1; j <= NumPlayers; j++)
 		{
 			/* This player can't see it */
-			Players[j]->obj_vis[o_idx] = FALSE;
+			idx_off(Players[j]->obj_vis, o_idx);
 		}
 	}
 
@@ -4119,7 +4142,7 @@ void drop_near(object_type *o_ptr, int chance, int Depth, int y, int x)
 			for (k = 1; k <= NumPlayers; k++)
 			{
 				/* This player cannot see it */
-				Players[k]->obj_vis[o_idx] = FALSE;
+				idx_off(Players[k]->obj_vis, o_idx);
 			}
 
 			/* Note the spot */
@@ -4432,7 +4455,7 @@ void floor_item_notify(player_type *p_ptr, s16b o_idx, bool force)
 	if (o_idx) for (i = 1; i <= NumPlayers; i++)
 	{
 		if (Players[i]->dun_depth != p_ptr->dun_depth) continue;
-		if (Players[i]->obj_vis[o_idx]) Players[i]->window |= (PW_ITEMLIST);
+		if (idx_has(Players[i]->obj_vis, o_idx)) Players[i]->window |= (PW_ITEMLIST);
 	}
 
 	if (!force && p_ptr->delta_floor_item == o_idx) return;
@@ -4941,7 +4964,7 @@ static void notify_player_standing_on(int o_idx)
 	for (Ind = 1; Ind <= NumPlayers; Ind++)
 	{
 		p_ptr = Players[Ind];
-		if (p_ptr->obj_vis[o_idx]) p_ptr->window |= (PW_ITEMLIST);
+		if (idx_has(p_ptr->obj_vis, o_idx)) p_ptr->window |= (PW_ITEMLIST);
 	}
 }
 
@@ -4974,6 +4997,9 @@ void process_objects(void)
 			/* Excise it */
 			o_fast[k] = o_fast[--o_top];
 
+			/* The index can be reused now */
+			o_free[o_free_num++] = i;
+
 			/* Skip */
 			continue;
 		}
@@ -5397,7 +5423,7 @@ int scan_floor(player_type *p_ptr, int *items, int max_size, int y, int x, int m
 			continue;
 #else
 		/* MAngband-specific: squelch/mode 0x02 alternative */
-		if ((mode & 0x02) && !(p_ptr->obj_vis[this_o_idx])) continue;
+		if ((mode & 0x02) && !(idx_has(p_ptr->obj_vis, this_o_idx))) continue;
 #endif
 
 		/* Accept this item */
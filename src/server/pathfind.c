@@ -18,16 +18,28 @@
 /*** Constants ***/
 #define DUNGEON_WID MAX_WID
 #define DUNGEON_HGT MAX_HGT
+#define PF_NODE(Y,X) ((Y) * DUNGEON_WID + (X))
 
 
 
 /*** Globals ***/
 
-static int terrain[MAX_PF_RADIUS][MAX_PF_RADIUS];
-/*char pf_result[MAX_PF_LENGTH];
-int pf_result_index;*/
-
-static int ox, oy, ex, ey;
+/*
+ * Scratch grid of the A* search.  Entries are only valid when their
+ * "stamp" matches the current search, so nothing needs clearing.
+ */
+static u16b pf_stamp[DUNGEON_HGT * DUNGEON_WID];
+static byte pf_cost[DUNGEON_HGT * DUNGEON_WID];	/* Steps from the player */
+static byte pf_dir[DUNGEON_HGT * DUNGEON_WID];	/* Step that reached the grid */
+static s16b pf_pos[DUNGEON_HGT * DUNGEON_WID];	/* Place in the heap, or -1 once closed */
+static u16b pf_search = 0;
+
+/* Open set, a binary heap ordered by (cost + estimate) */
+static s16b pf_heap[DUNGEON_HGT * DUNGEON_WID];
+static u16b pf_key[DUNGEON_HGT * DUNGEON_WID];
+static int pf_heap_num;
+
+/* Orthogonal directions first, so they win ties */
 static int dir_search[8] = {2,4,6,8,1,3,7,9};
 
 
@@ -53,168 +65,159 @@ static bool is_valid_pf(player_type *p_ptr, int y, int x)
 	return (TRUE);
 }
 
-static void fill_terrain_info(player_type *p_ptr)
+/*
+ * Binary heap helpers
+ */
+static void pf_heap_set(int i, int n)
 {
-	int i, j;
+	pf_heap[i] = n;
+	pf_pos[n] = i;
+}
 
-	ox = MAX(p_ptr->px - MAX_PF_RADIUS / 2, 0);
-	oy = MAX(p_ptr->py - MAX_PF_RADIUS / 2, 0);
+static void pf_heap_up(int i)
+{
+	int n = pf_heap[i];
 
-	ex = MIN(p_ptr->px + MAX_PF_RADIUS / 2 - 1, DUNGEON_WID);
-	ey = MIN(p_ptr->py + MAX_PF_RADIUS / 2 - 1, DUNGEON_HGT);
+	while (i > 0 && pf_key[pf_heap[(i - 1) / 2]] > pf_key[n])
+	{
+		pf_heap_set(i, pf_heap[(i - 1) / 2]);
+		i = (i - 1) / 2;
+	}
+	pf_heap_set(i, n);
+}
 
-	for (j = 0; j < MAX_PF_RADIUS; j++)
-	for (i = 0; i < MAX_PF_RADIUS; i++)
-		terrain[j][i] = -1;
+static int pf_heap_pop(void)
+{
+	int top = pf_heap[0];
+	int n = pf_heap[--pf_heap_num];
+	int i = 0, c;
 
-	for (j = oy; j < ey; j++)
-		for (i = ox; i < ex; i++)
-			if (is_valid_pf(p_ptr, j, i))
-				terrain[j - oy][i - ox] = MAX_PF_LENGTH;
+	while ((c = i * 2 + 1) < pf_heap_num)
+	{
+		if (c + 1 < pf_heap_num && pf_key[pf_heap[c + 1]] < pf_key[pf_heap[c]]) c++;
+		if (pf_key[pf_heap[c]] >= pf_key[n]) break;
+		pf_heap_set(i, pf_heap[c]);
+		i = c;
+	}
+	if (pf_heap_num) pf_heap_set(i, n);
 
-	terrain[p_ptr->py - oy][p_ptr->px - ox] = 1;
+	/* Closed */
+	pf_pos[top] = -1;
+	return (top);
 }
 
-#define MARK_DISTANCE(c,d) if ((c <= MAX_PF_LENGTH) && (c > d)) { c = d; try_again = (TRUE); }
+/*
+ * Every step costs the same, diagonal or not, so the octile estimate
+ * degenerates into the larger of the two distances.  Ties are broken
+ * towards grids nearer the goal (the estimate sits in the low bits).
+ */
+static u16b pf_estimate(int y, int x, int cost, int ty, int tx)
+{
+	int h = MAX(ABS(y - ty), ABS(x - tx));
+	return (u16b)(((cost + h) << 8) | h);
+}
 
 bool findpath(player_type *p_ptr, int y, int x)
 {
-	int i, j, k;
-	int dir = 10;
-	bool try_again;
-	int cur_distance;
+	int n, k, dir, cy, cx, ny, nx, nn;
+	int goal = PF_NODE(y, x);
+	int start = PF_NODE(p_ptr->py, p_ptr->px);
+	byte cost;
 
-	fill_terrain_info(p_ptr);
-
-	terrain[p_ptr->py - oy][p_ptr->px - ox] = 1;
-
-	if ((x >= ox) && (x < ex) && (y >= oy) && (y < ey))
-	{
-		if ((cave[p_ptr->dun_depth][y][x].m_idx > 0) && (p_ptr->mon_los[cave[p_ptr->dun_depth][y][x].m_idx ]))
-		{
-			terrain[y - oy][x - ox] = MAX_PF_LENGTH;
-		}
-
-#if 0
-		else if (terrain[y-oy][x-ox] != MAX_PF_LENGTH)
-		{
-		   bell();
-		   return (FALSE);
-		}
-#endif
-
-		terrain[y - oy][x - ox] = MAX_PF_LENGTH;
-	}
-	else
+	/* Paranoia -- stay on the level */
+	if ((y < 0) || (y >= DUNGEON_HGT) || (x < 0) || (x >= DUNGEON_WID))
 	{
 		bell();
 		return (FALSE);
 	}
 
-	if (terrain[y - oy][x - ox] == -1)
+	/* Start a new search, wipe the stamps once they wrap around */
+	if (++pf_search == 0)
 	{
-		bell();
-		return (FALSE);
+		C_WIPE(pf_stamp, DUNGEON_HGT * DUNGEON_WID, u16b);
+		pf_search = 1;
 	}
 
+	/* Start from the player */
+	pf_stamp[start] = pf_search;
+	pf_cost[start] = 0;
+	pf_key[start] = pf_estimate(p_ptr->py, p_ptr->px, 0, y, x);
+	pf_heap_num = 1;
+	pf_heap_set(0, start);
 
-	/* 
-	 * And now starts the very naive and very 
-	 * inefficient pathfinding algorithm
-	 */
-	do
+	/* Search */
+	while (pf_heap_num)
 	{
-		try_again = FALSE;
+		n = pf_heap_pop();
+
+		/* Found it */
+		if (n == goal) break;
 
-		for (j = oy + 1; j < ey - 1; j++)
+		cy = n / DUNGEON_WID;
+		cx = n % DUNGEON_WID;
+		cost = pf_cost[n] + 1;
+
+		for (k = 0; k < 8; k++)
 		{
-			for (i = ox + 1; i < ex - 1; i++)
-			{
-				cur_distance = terrain[j - oy][i - ox] + 1;
+			dir = dir_search[k];
+			ny = cy + ddy[dir];
+			nx = cx + ddx[dir];
 
-				if ((cur_distance > 0) && (cur_distance < MAX_PF_LENGTH))
-				{
-					for (dir = 1; dir < 10; dir++)
-					{
-						if (dir == 5)
-							dir++;
+			/* Stay on the level */
+			if ((ny < 0) || (ny >= DUNGEON_HGT) || (nx < 0) || (nx >= DUNGEON_WID)) continue;
 
-						MARK_DISTANCE(terrain[j - oy + ddy[dir]][i - ox + ddx[dir]], cur_distance);
-					}
-				}
+			/* Paths must fit in "pf_result" */
+			if (cost + MAX(ABS(ny - y), ABS(nx - x)) >= MAX_PF_LENGTH) continue;
+
+			nn = PF_NODE(ny, nx);
+
+			/* Seen before */
+			if (pf_stamp[nn] == pf_search)
+			{
+				/* Closed, or no better */
+				if ((pf_pos[nn] < 0) || (pf_cost[nn] <= cost)) continue;
 			}
-		}
+			else
+			{
+				/* Hack -- the goal itself is always allowed */
+				if ((nn != goal) && !is_valid_pf(p_ptr, ny, nx))
+				{
+					/* Never look at it again */
+					pf_stamp[nn] = pf_search;
+					pf_pos[nn] = -1;
+					continue;
+				}
 
-		if (terrain[y - oy][x - ox] < MAX_PF_LENGTH)
-			try_again = (FALSE);
+				/* New grid */
+				pf_stamp[nn] = pf_search;
+				pf_heap_set(pf_heap_num++, nn);
+			}
 
+			/* Record the (better) way there */
+			pf_cost[nn] = cost;
+			pf_dir[nn] = dir;
+			pf_key[nn] = pf_estimate(ny, nx, cost, y, x);
+			pf_heap_up(pf_pos[nn]);
+		}
 	}
-	while (try_again);
 
 	/* Failure */
-	if (terrain[y - oy][x - ox] == MAX_PF_LENGTH)
+	if ((pf_stamp[goal] != pf_search) || (pf_pos[goal] >= 0) || (goal == start))
 	{
 		bell();
 		return (FALSE);
 	}
 
-	/* Success */
-	i = x;
-	j = y;
-
+	/* Success, store the path backwards */
 	p_ptr->pf_result_index = 0;
-
-	while ((i != p_ptr->px) || (j != p_ptr->py))
+	for (n = goal; n != start; )
 	{
-		cur_distance = terrain[j - oy][i - ox] - 1;
-		for (k = 0; k < 8; k++)
-		{
-			dir = dir_search[k];
-
-			/* Paranoia -- stay in terrain[][] bounds */
-			if (j - oy + ddy[dir] < 0 ||
-			    j - oy + ddy[dir] >= MAX_PF_RADIUS ||
-			    i - ox + ddx[dir] < 0 ||
-			    i - ox + ddx[dir] >= MAX_PF_RADIUS)
-			{
-				/* Skip this direction */
-				dir = 5;
-				continue;
-			}
-
-			if (terrain[j - oy + ddy[dir]][i - ox + ddx[dir]] == cur_distance)
-				break;
-		}
-
-		/* Should never happend */
-		if (dir == 10)
-		{
-			bell();
-			return (FALSE);
-		}
-
-		else if (dir == 5)
-		{
-			bell();
-			return (FALSE);
-		}
-
-		p_ptr->pf_result[p_ptr->pf_result_index++] = '0' + (char)(10 - dir);
-		i += ddx[dir];
-		j += ddy[dir];
-
-		/* Paranoia -- stay in pf_result[MAX_PF_LENGTH] bounds */
-		if (p_ptr->pf_result_index >= MAX_PF_LENGTH)
-		{
-			bell();
-			return (FALSE);
-		}
+		dir = pf_dir[n];
+		p_ptr->pf_result[p_ptr->pf_result_index++] = '0' + (char)dir;
+		n = PF_NODE(n / DUNGEON_WID - ddy[dir], n % DUNGEON_WID - ddx[dir]);
 	}
 
 	p_ptr->pf_result_index--;
 
 	return (TRUE);
 }
-
-
-
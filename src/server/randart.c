@@ -1042,12 +1042,12 @@ static void add_ability (artifact_type *a_ptr)
 
 
 /*
- * Returns pointer to randart artifact_type structure.
+ * Generate a randart into the "randart" prototype.
  *
  * o_ptr should contain the seed (in name3) plus a tval
  * and sval. It returns NULL on illegal sval and tvals.
  */
-artifact_type *randart_make(const object_type *o_ptr)
+static artifact_type *randart_generate(const object_type *o_ptr)
 {
 	s32b power = 0;
 	int tries;
@@ -1345,6 +1345,151 @@ artifact_type *randart_make(const object_type *o_ptr)
 }
 
 
+/*
+ * Cache of generated randarts.
+ *
+ * Generation re-runs the whole power balancing loop, and artifact_ptr()
+ * is used all over the place (object_flags, object_desc, store pricing,
+ * calc_bonuses...), so results are kept in a small set-associative
+ * table, with LRU replacement inside each set.
+ *
+ * Besides the seed, generation looks at the curse, the pval/bpval pair,
+ * and the to-hit/to-dam/to-ac of rings and amulets, so those are part of
+ * the key as well.
+ */
+#define RANDART_CACHE_SETS	64
+#define RANDART_CACHE_WAYS	4
+
+typedef struct randart_cache_entry randart_cache_entry;
+struct randart_cache_entry
+{
+	bool used;
+	u32b stamp;	/* Last use, for LRU */
+
+	s16b k_idx;	/* Key */
+	s32b name3;
+	byte cursed;
+	s16b pval;
+	s16b bpval;
+	s16b to_h;
+	s16b to_d;
+	s16b to_a;
+
+	artifact_type art;
+};
+
+static randart_cache_entry randart_cache[RANDART_CACHE_SETS][RANDART_CACHE_WAYS];
+static u32b randart_stamp = 0;
+static u32b randart_hits = 0;
+static u32b randart_misses = 0;
+
+/* Build the cache key of an object, leaving out what generation ignores */
+static void randart_key(const object_type *o_ptr, randart_cache_entry *key)
+{
+	object_kind *kind = &k_info[o_ptr->k_idx];
+
+	key->k_idx = o_ptr->k_idx;
+	key->name3 = o_ptr->name3;
+	key->cursed = (cursed_p(o_ptr) ? 1 : 0);
+	key->bpval = o_ptr->bpval;
+	key->pval = (o_ptr->bpval ? o_ptr->pval : 0);
+	if ((kind->tval == TV_AMULET) || (kind->tval == TV_RING))
+	{
+		key->to_h = o_ptr->to_h;
+		key->to_d = o_ptr->to_d;
+		key->to_a = o_ptr->to_a;
+	}
+	else
+	{
+		key->to_h = key->to_d = key->to_a = 0;
+	}
+}
+
+/*
+ * Returns pointer to randart artifact_type structure, generating
+ * it if needed.  The pointer stays valid until the entry is evicted,
+ * which takes at least RANDART_CACHE_WAYS other randarts.
+ */
+artifact_type *randart_make(const object_type *o_ptr)
+{
+	randart_cache_entry key, *set, *e, *victim;
+	artifact_type *art;
+	u32b h;
+	int i;
+
+	randart_key(o_ptr, &key);
+
+	/* Pick a set */
+	h = (u32b)key.name3 * 2654435761UL + (u32b)key.k_idx;
+	set = randart_cache[(h >> 16) % RANDART_CACHE_SETS];
+
+	/* Look it up */
+	victim = &set[0];
+	for (i = 0; i < RANDART_CACHE_WAYS; i++)
+	{
+		e = &set[i];
+		if (e->used && e->k_idx == key.k_idx && e->name3 == key.name3 &&
+		    e->cursed == key.cursed && e->pval == key.pval &&
+		    e->bpval == key.bpval && e->to_h == key.to_h &&
+		    e->to_d == key.to_d && e->to_a == key.to_a)
+		{
+			randart_hits++;
+			e->stamp = ++randart_stamp;
+			return (&e->art);
+		}
+
+		/* Remember the least recently used (or empty) way */
+		if (!e->used || (victim->used && e->stamp < victim->stamp))
+			victim = e;
+	}
+
+	randart_misses++;
+
+	/* Make it */
+	art = randart_generate(o_ptr);
+
+	/* Illegal kinds are cheap to reject, do not cache them */
+	if (!art) return (NULL);
+
+	/* Remember it */
+	*victim = key;
+	victim->used = TRUE;
+	victim->stamp = ++randart_stamp;
+	victim->art = *art;
+
+	return (&victim->art);
+}
+
+/*
+ * Forget all the cached randarts (e.g. when object kinds changed)
+ */
+void randart_cache_wipe(void)
+{
+	C_WIPE(randart_cache, RANDART_CACHE_SETS * RANDART_CACHE_WAYS, randart_cache_entry);
+	randart_stamp = 0;
+}
+
+/*
+ * Report cache statistics
+ */
+cptr randart_cache_status(void)
+{
+	static char buf[160];
+	int i, j, used = 0;
+	u32b total = randart_hits + randart_misses;
+
+	for (i = 0; i < RANDART_CACHE_SETS; i++)
+		for (j = 0; j < RANDART_CACHE_WAYS; j++)
+			if (randart_cache[i][j].used) used++;
+
+	strnfmt(buf, sizeof(buf), "Randart cache: %d/%d entries, %lu hits, %lu misses (%lu%% hits)\n",
+		used, RANDART_CACHE_SETS * RANDART_CACHE_WAYS,
+		(unsigned long)randart_hits, (unsigned long)randart_misses,
+		(unsigned long)(total ? (randart_hits * 100.0 / total) : 0));
+
+	return (buf);
+}
+
 /*
  * Make random artifact name.
  */
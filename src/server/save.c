@@ -5,6 +5,12 @@
 #include "mangband.h"
 #include "../common/md5.h"
 
+#if defined(WINDOWS)
+# include <windows.h>
+#elif defined(HAVE_PTHREAD)
+# include <pthread.h>
+#endif
+
 /*
  * Some "local" parameters, used to help write savefiles
  */
@@ -18,12 +24,135 @@ static int xml_indent = 0L;
 static char xml_buf[32];
 static char *xml_prefix = xml_buf;
 
+/*
+ * Hack -- autosaves are serialized into memory ("save_buf") instead,
+ * and reach the disk later from a background thread (see below).
+ */
+static bool file_memory = FALSE;
+static char *save_buf = NULL;
+static size_t save_len, save_pos, save_size;
+
+/* Append "n" bytes to the save "file" */
+static void sf_write(const char *buf, size_t n)
+{
+	if (!file_memory)
+	{
+		file_write(file_handle, buf, n);
+		return;
+	}
+
+	/* Grow the buffer */
+	if (save_pos + n > save_size)
+	{
+		size_t size = MAX(save_size * 2, save_pos + n);
+		char *grown = C_RNEW(size, char);
+		if (save_len) memcpy(grown, save_buf, save_len);
+		FREE(save_buf);
+		save_buf = grown;
+		save_size = size;
+	}
+
+	memcpy(save_buf + save_pos, buf, n);
+	save_pos += n;
+	if (save_pos > save_len) save_len = save_pos;
+}
+
+/* Append a formatted string to the save "file" */
+static void sf_putf(const char *fmt, ...)
+{
+	char buf[1024];
+	va_list vp;
+
+	va_start(vp, fmt);
+	(void)vstrnfmt(buf, sizeof(buf), fmt, vp);
+	va_end(vp);
+
+	sf_write(buf, strlen(buf));
+}
+
+static size_t sf_tell(void)
+{
+	return (file_memory ? save_pos : file_tell(file_handle));
+}
+
+static void sf_seek(size_t pos)
+{
+	if (file_memory) save_pos = pos;
+	else file_seek(file_handle, pos);
+}
+
+static bool sf_error(void)
+{
+	return (file_memory ? FALSE : file_error(file_handle));
+}
+
+static void save_memory_begin(void);
+static void save_memory_end(cptr name, bool ok);
+static void account_note(player_type *p_ptr);
+
+/*
+ * Hack -- the current save "file" uses the binary format.
+ * Open sections remember where their length field lives, so it
+ * can be filled in once the section is closed.
+ */
+static bool file_binary = FALSE;
+static size_t sect_pos[SF_MAX_DEPTH];
+static int sect_depth = 0;
+
+/* Write a little-endian number of "bytes" size */
+static void put_le(huge value, int bytes)
+{
+	char buf[8];
+	int i;
+	for (i = 0; i < bytes; i++)
+	{
+		buf[i] = (char)(value & 0xFF);
+		value >>= 8;
+	}
+	sf_write(buf, bytes);
+}
+
+/* Write a binary record header */
+static void put_tag(byte tag, cptr name)
+{
+	size_t len = strlen(name);
+	char head[2];
+	if (len > 255) len = 255;
+	head[0] = (char)tag;
+	head[1] = (char)len;
+	sf_write(head, 2);
+	sf_write(name, len);
+}
+
+/*
+ * Prepare a freshly opened save "file", in the format requested
+ */
+static void start_savefile(bool binary)
+{
+	file_binary = binary;
+	sect_depth = 0;
+	xml_indent = 0;
+	if (!binary) return;
+	sf_write(SF_MAGIC, SF_MAGIC_LEN);
+	put_le(SF_FORMAT_VERSION, 4);
+}
+
 /* Start a section */
 static void start_section(char* name)
 {
 	int i;
+	if (file_binary)
+	{
+		put_tag(SF_TAG_SECTION, name);
+		/* Paranoia -- keep writing even if nested too deep */
+		if (sect_depth < SF_MAX_DEPTH)
+			sect_pos[sect_depth] = sf_tell();
+		sect_depth++;
+		put_le(0, 4);
+		return;
+	}
 	if(xml_indent == 0) xml_prefix[0] = '\0';
-	file_putf(file_handle, "%s<%s>\n", xml_prefix,name);
+	sf_putf("%s<%s>\n", xml_prefix,name);
 	xml_indent += 2;
 	for(i = 0;i<xml_indent;i++) xml_buf[i] = ' ';
 	xml_buf[xml_indent] = '\0';
@@ -33,68 +162,125 @@ static void start_section(char* name)
 static void end_section(char* name)
 {
 	int i;
+	if (file_binary)
+	{
+		size_t here;
+		put_tag(SF_TAG_END, name);
+		if (--sect_depth >= SF_MAX_DEPTH || sect_depth < 0) return;
+		/* Go back and fill in the body length */
+		here = sf_tell();
+		sf_seek(sect_pos[sect_depth]);
+		put_le(here - sect_pos[sect_depth] - 4, 4);
+		sf_seek(here);
+		return;
+	}
 	xml_indent -= 2;
 	for(i = 0;i<xml_indent;i++) xml_buf[i] = ' ';
 	xml_buf[xml_indent] = '\0';
-	file_putf(file_handle, "%s</%s>\n", xml_prefix, name);
+	sf_putf("%s</%s>\n", xml_prefix, name);
 }
 
 /* Write an integer */
 static void write_int(char* name, int value)
 {
-	file_putf(file_handle, "%s%s = %i\n", xml_prefix, name, value);
+	if (file_binary)
+	{
+		put_tag(SF_TAG_INT, name);
+		put_le((u32b)value, 4);
+		return;
+	}
+	sf_putf("%s%s = %i\n", xml_prefix, name, value);
 }
 
 /* Write an unsigned integer value */
 static void write_uint(const char* name, unsigned int value)
 {
-	file_putf(file_handle, "%s%s = %u\n", xml_prefix, name, value);
+	if (file_binary)
+	{
+		put_tag(SF_TAG_UINT, name);
+		put_le(value, 4);
+		return;
+	}
+	sf_putf("%s%s = %u\n", xml_prefix, name, value);
 }
 
 /* Write an signed long value */
 static void write_huge(char* name, huge value)
 {
-	file_putf(file_handle, "%s%s = %" PRIu64 "\n", xml_prefix,name, value);
+	if (file_binary)
+	{
+		put_tag(SF_TAG_HUGE, name);
+		put_le(value, 8);
+		return;
+	}
+	sf_putf("%s%s = %" PRIu64 "\n", xml_prefix,name, value);
 }
 
 /* Write an hturn */
 static void write_hturn(char* name, hturn *value)
 {
-	file_putf(file_handle, "%s%s = %" PRIu64 " %" PRIu64 "\n", xml_prefix, name, value->era, value->turn);
+	if (file_binary)
+	{
+		put_tag(SF_TAG_HTURN, name);
+		put_le(value->era, 8);
+		put_le(value->turn, 8);
+		return;
+	}
+	sf_putf("%s%s = %" PRIu64 " %" PRIu64 "\n", xml_prefix, name, value->era, value->turn);
 }
 
 /* Write a string */
 static void write_str(char* name, char* value)
 {
-	file_putf(file_handle, "%s%s = %s\n", xml_prefix, name, value);
+	if (file_binary)
+	{
+		size_t len = strlen(value);
+		if (len > 0xFFFF) len = 0xFFFF;
+		put_tag(SF_TAG_STR, name);
+		put_le(len, 2);
+		sf_write(value, len);
+		return;
+	}
+	sf_putf("%s%s = %s\n", xml_prefix, name, value);
 }
 
 /* Write a quark (as string) */
 static void write_quark(char* name, u16b quark)
 {
 	char *value = quark ? (char*)quark_str(quark) : "";
-	file_putf(file_handle, "%s%s = %s\n", xml_prefix, name, value);
+	write_str(name, value);
 }
 
 #if 0
 static void write_float(char* name, float value)
 {
-	file_putf(file_handle, "%s%s = %f\n", xml_prefix, name, value);
+	sf_putf("%s%s = %f\n", xml_prefix, name, value);
 }
 #endif
 /* Write binary data */
 static void write_binary(char* name, char* data, int len)
 {
+	static const char digits[] = "0123456789abcdef";
+	char hex[2];
 	int i;
 	byte b;
-	file_putf(file_handle, "%s%s = ", xml_prefix, name);
+	if (file_binary)
+	{
+		put_tag(SF_TAG_BINARY, name);
+		put_le(len, 4);
+		sf_write(data, len);
+		return;
+	}
+	sf_putf("%s%s = ", xml_prefix, name);
 	for(i=0;i<len;i++)
 	{
+		/* Same as "%2x", without the formatting overhead */
 		b = data[i];
-		file_putf(file_handle, "%2x", b);
+		hex[0] = (b >> 4) ? digits[b >> 4] : ' ';
+		hex[1] = digits[b & 0x0F];
+		sf_write(hex, 2);
 	}
-	//fprintf(file_handle,"\n",name);
-	file_putf(file_handle, "\n");
+	sf_write("\n", 1);
 }
 
 
@@ -759,6 +945,7 @@ bool wr_dungeon_special_ext(int Depth, cptr levelname)
 	char filename[1024];
 	ang_file* fhandle;
 	ang_file* server_handle;
+	bool server_binary = file_binary;
 	
 	path_build(filename, 1024, ANGBAND_DIR_SAVE, levelname);
 
@@ -770,11 +957,15 @@ bool wr_dungeon_special_ext(int Depth, cptr levelname)
 			server_handle = file_handle;
 			file_handle = fhandle;
 
+			/* designed levels are meant to be edited, keep them as text */
+			start_savefile(FALSE);
+
 			/* save the level */
 			wr_dungeon(Depth);
 
 			/* swap the file pointers back */
 			file_handle = server_handle;
+			file_binary = server_binary;
 
 			/* close the level file */
 			file_close(fhandle);
@@ -995,7 +1186,7 @@ static bool wr_savefile_new(player_type *p_ptr)
 	end_section("mangband_player_save");
 
 	/* Error in save */
-	if (file_error(file_handle)) return FALSE;
+	if (sf_error()) return FALSE;
 
 	/* Successful save */
 	return TRUE;
@@ -1019,6 +1210,9 @@ static bool save_player_aux(player_type *p_ptr, char *name)
 	/* Successful open */
 	if (file_handle)
 	{
+		/* Pick the format */
+		start_savefile(cfg_save_binary);
+
 		/* Write the savefile */
 		if (wr_savefile_new(p_ptr)) ok = TRUE;
 
@@ -1050,6 +1244,8 @@ bool save_player(player_type *p_ptr)
 
 	char	safe[1024];
 
+	/* Let pending autosaves land first */
+	autosave_wait();
 
 #ifdef SET_UID
 
@@ -1081,6 +1277,9 @@ bool save_player(player_type *p_ptr)
 	{
 		char temp[1024];
 
+		/* Keep the account index current */
+		account_note(p_ptr);
+
 		/* Old savefile */
 		strcpy(temp, p_ptr->savefile);
 		strcat(temp, ".old");
@@ -1138,105 +1337,285 @@ bool save_player(player_type *p_ptr)
 	return (result);
 }
 
-/* XXX XXX XXX
- * Similarly to "load_player", reads a part of player savefile and report the results.
- * 
- * This is used because we need the password information early on in the connection stage
- * (before the player structure is allocated) and the only way 
- * to get it is to read the save file. The file will be read again when it is time
- * to allocate player information and start game play.
- *
- * The actual read is performed by "rd_savefile_new_scoop_aux" from "load2.c", which
- * is a simplified code duplcation from player loading routines.
+/*
+ * Account index.
  *
- * XXX XXX XXX: the "pass" buffer might be overwriten with the hashed version of the
- * password, and must be of MAX_CHARS length.
+ * Maps each savefile (by "basename") to its owner's name and stored
+ * password, so that "scoop_player()" can check a login without opening
+ * the savefile at all.  The index lives in "save/accounts", in the
+ * savefile format.  Entries are refreshed whenever a player is saved,
+ * and the file is rewritten along with the server savefile.
  *
- * TODO: why do we have so much code here anyway?
+ * The index is only a cache: a missing entry, one which disagrees with
+ * the password given, or one for a dead character (about to be rebuilt
+ * from its bones), sends us back to the savefile itself, which then
+ * refreshes the entry.  The savefile must still exist either way.
  */
-int scoop_player(char *nick, char *pass)
+#define ACCOUNT_HASH	1024
+#define ACCOUNT_DEAD	0x01	/* Character was dead when last saved */
+
+typedef struct account_type account_type;
+struct account_type
 {
-	ang_file* fd = NULL;
-	errr	err = 0;
-	byte	vvv[4];
-	cptr	what = "generic";
+	char base[MAX_CHARS];	/* Savefile basename (the key) */
+	char name[MAX_CHARS];	/* Player name */
+	char pass[MAX_CHARS];	/* Password, as stored in the savefile */
+	byte flags;
+	account_type *next;
+};
+
+static account_type *account_hash[ACCOUNT_HASH];
+static int account_count = 0;
+static bool account_dirty = FALSE;
+
+/* Hash a savefile basename */
+static int account_key(cptr base)
+{
+	u32b h = 5381;
+	while (*base) h = (h * 33) ^ (byte)*base++;
+	return (h % ACCOUNT_HASH);
+}
 
-	char tmp[MAX_CHARS];
+static account_type *account_find(cptr base)
+{
+	account_type *a_ptr;
+	for (a_ptr = account_hash[account_key(base)]; a_ptr; a_ptr = a_ptr->next)
+	{
+		if (!strcmp(a_ptr->base, base)) return (a_ptr);
+	}
+	return (NULL);
+}
 
-	my_strcpy(tmp, nick, MAX_CHARS);
-	if (process_player_name_aux( &tmp[0] , NULL, TRUE ) < 0)
+/*
+ * Add or refresh an account
+ */
+void account_add(cptr base, cptr name, cptr pass, byte flags)
+{
+	account_type *a_ptr = account_find(base);
+
+	if (!a_ptr)
 	{
-		/* Error allready! */
-		err = -1;
+		int k = account_key(base);
+		MAKE(a_ptr, account_type);
+		my_strcpy(a_ptr->base, base, MAX_CHARS);
+		a_ptr->next = account_hash[k];
+		account_hash[k] = a_ptr;
+		account_count++;
 	}
-	
-	/* Verify the existance of the savefile */
-	if (!file_exists(tmp))
+	else if (!strcmp(a_ptr->name, name) && !strcmp(a_ptr->pass, pass) &&
+	         a_ptr->flags == flags)
 	{
-		/* Give a message */
-		plog(format("Savefile does not exist for player %s", nick));
-
-		/* Inform caller */
-		err = 1;			
+		/* Nothing new */
+		return;
 	}
 
-	/* Okay */
-	if (!err)
+	my_strcpy(a_ptr->name, name, MAX_CHARS);
+	my_strcpy(a_ptr->pass, pass, MAX_CHARS);
+	a_ptr->flags = flags;
+	account_dirty = TRUE;
+}
+
+/* Forget an account */
+static void account_remove(cptr base)
+{
+	account_type **a_ptr, *dead;
+	for (a_ptr = &account_hash[account_key(base)]; *a_ptr; a_ptr = &(*a_ptr)->next)
 	{
-		/* Open the savefile */
-		fd = file_open(tmp, MODE_READ, -1);
+		if (strcmp((*a_ptr)->base, base)) continue;
+		dead = *a_ptr;
+		*a_ptr = dead->next;
+		FREE(dead);
+		account_count--;
+		account_dirty = TRUE;
+		return;
+	}
+}
 
-		/* No file */
-		if (!fd) err = -1;
+/* Refresh the account of a player being saved */
+static void account_note(player_type *p_ptr)
+{
+	account_add(p_ptr->basename, p_ptr->name, p_ptr->pass,
+		p_ptr->death ? ACCOUNT_DEAD : 0);
+}
 
-		/* Message (below) */
-		if (err) what = "Cannot open savefile";
+/* Write the account index */
+static bool wr_accounts(void)
+{
+	account_type *a_ptr;
+	int i;
+
+	start_section("mangband_accounts");
+	write_int("count", account_count);
+	for (i = 0; i < ACCOUNT_HASH; i++)
+	{
+		for (a_ptr = account_hash[i]; a_ptr; a_ptr = a_ptr->next)
+		{
+			start_section("account");
+			write_str("base", a_ptr->base);
+			write_str("name", a_ptr->name);
+			write_str("pass", a_ptr->pass);
+			write_int("flags", a_ptr->flags);
+			end_section("account");
+		}
 	}
+	end_section("mangband_accounts");
 
-#ifdef VERIFY_SAVEFILE
+	return (!sf_error());
+}
 
-	/* Verify savefile usage */
-	if (!err)
+/*
+ * Load the account index, dropping accounts whose savefile is gone.
+ */
+void load_accounts(void)
+{
+	char buf[1024];
+	account_type *a_ptr, *next;
+	int i;
+
+	path_build(buf, sizeof(buf), ANGBAND_DIR_SAVE, "accounts");
+
+	/* Nothing yet, it fills up as players log in and get saved */
+	if (!file_exists(buf)) return;
+
+	if (rd_accounts(buf))
 	{
-		file_lock(fd);
+		plog("Account index is broken, logins will read savefiles");
 	}
 
-#endif
+	/* Freshly loaded */
+	account_dirty = FALSE;
 
-	/* Process file */
-	if (!err)
+	/* Stale entries are dropped, and written out at the next save */
+	for (i = 0; i < ACCOUNT_HASH; i++)
 	{
+		for (a_ptr = account_hash[i]; a_ptr; a_ptr = next)
+		{
+			next = a_ptr->next;
+			path_build(buf, sizeof(buf), ANGBAND_DIR_SAVE, a_ptr->base);
+			if (!file_exists(buf)) account_remove(a_ptr->base);
+		}
+	}
 
-		/* Read the first four bytes */
-		if (file_read(fd, (char*)(vvv), 4) < 4) err = -1;
+	plog(format("Loaded %d accounts", account_count));
+}
 
-		/* What */
-		if (err) what = "Cannot read savefile";
+/*
+ * Compare the password given by a client with the one stored in a
+ * savefile.  Either side may be clear text or an MD5 hash.
+ *
+ * Returns 0 on match, and -2 if the passwords do not match.  On match
+ * with a clear text stored password, the hashed version is put into
+ * "pass_word", which is assumed to be of MAX_CHARS length.
+ */
+static errr check_password(cptr pass, char *pass_word)
+{
+	char temp[80];
+	char temp2[80];
+
+	/* Here's where we do our password encryption handling */
+	my_strcpy(temp, pass, 80);
+	MD5Password(temp); /* The hashed version of our stored password */
+	my_strcpy(temp2, (const char *)pass_word, 80);
+	MD5Password(temp2); /* The hashed version of password from client */
+
+	if (strstr(pass, "$1$"))
+	{ /* Most likely an MD5 hashed password saved */
+		if (strcmp(pass, pass_word))
+		{ /* No match, might be clear text from client */
+			if (strcmp(pass, temp2))
+			{
+				/* No, it's not correct */
+				return (-2);
+			}
+			/* Old style client, but OK otherwise */
+		}
+		return (0);
+	}
 
-		/* Close the file */
-		(void)file_close(fd);
+	/* Most likely clear text password saved */
+	if (strstr(pass_word, "$1$"))
+	{ /* Most likely hashed password from new client */
+		if (strcmp(temp, pass_word))
+		{
+			/* No, it doesn't match hatched */
+			return (-2);
+		}
+	}
+	else
+	{ /* Most likely clear text from client as well */
+		if (strcmp(pass, pass_word))
+		{
+			/* No, it's not correct */
+			return (-2);
+		}
 	}
 
-	/* Process file */
-	if (!err)
+	/* Good match with clear text, save the hashed */
+	my_strcpy(pass_word, (const char *)temp, MAX_CHARS);
+	return (0);
+}
+
+/* XXX XXX XXX
+ * Similarly to "load_player", reads a part of player savefile and report the results.
+ * 
+ * This is used because we need the password information early on in the connection stage
+ * (before the player structure is allocated).  It normally comes from the account index
+ * above; only when that can't vouch for the login is the savefile read, by
+ * "rd_savefile_new_scoop_aux" from "load2.c".  The file will be read again when it is
+ * time to allocate player information and start game play.
+ *
+ * XXX XXX XXX: the "pass" buffer might be overwriten with the hashed version of the
+ * password, and must be of MAX_CHARS length.
+ *
+ * Returns 0 on match, 1 if there is no savefile yet, -1 on error and -2 if
+ * the password does not match.
+ */
+int scoop_player(char *nick, char *pass)
+{
+	errr	err;
+	account_type *a_ptr;
+	char	base[MAX_CHARS];
+	char	stored[MAX_CHARS];
+	char	tmp[1024];
+
+	my_strcpy(tmp, nick, sizeof(tmp));
+	if (process_player_name_aux(tmp, base, TRUE) < 0)
 	{
-		/* Attempt to load */
-		err = rd_savefile_new_scoop_aux(tmp, pass);
-		
-		/* Message (below) */
-		if (err == -1) what = "Cannot parse savefile";
-		if (err == -2) what = "Incorrect password";
+		/* Error allready! */
+		return (-1);
 	}
 
-#ifdef VERIFY_SAVEFILE
-	
-	/* Release lock */
-	file_unlock(fd);
+	a_ptr = account_find(base);
 
-#endif
+	/* Verify the existance of the savefile */
+	if (!file_exists(tmp))
+	{
+		/* Stale account */
+		if (a_ptr) account_remove(base);
 
-	/* Oops */
-	return (err);
+		/* Give a message */
+		plog(format("Savefile does not exist for player %s", nick));
+
+		/* Inform caller */
+		return (1);
+	}
+
+	/* The account index knows this one (dead ones ask the savefile) */
+	if (a_ptr && !(a_ptr->flags & ACCOUNT_DEAD) &&
+	    !check_password(a_ptr->pass, pass)) return (0);
+
+	/* Attempt to load */
+	err = rd_savefile_new_scoop_aux(tmp, stored);
+	if (err)
+	{
+		plog(format("Cannot parse savefile for player %s", nick));
+		return (-1);
+	}
+
+	/* Remember it */
+	account_add(base, nick, stored, a_ptr ? a_ptr->flags : 0);
+
+	return (check_password(stored, pass));
 }
 
 /*
@@ -1285,6 +1664,9 @@ bool load_player(player_type *p_ptr)
 	/* Allow empty savefile name */
 	if (!p_ptr->savefile[0]) return (TRUE);
 
+	/* Note it for the input log */
+	replay_savefile(p_ptr->savefile);
+
 	/* Verify the existance of the savefile */
 	if (!file_exists(p_ptr->savefile))
 	{
@@ -1598,7 +1980,7 @@ static bool wr_server_savefile(void)
 
 
         /* Error in save */
-        if (file_error(file_handle)) return FALSE;
+        if (sf_error()) return FALSE;
 
         /* Successful save */
         return TRUE;
@@ -1619,6 +2001,9 @@ static bool save_server_aux(char *name)
         /* Successful open */
         if (file_handle)
         {
+                /* Pick the format */
+                start_savefile(cfg_save_binary);
+
                 /* Write the savefile */
                 if (wr_server_savefile()) ok = TRUE;
 
@@ -1637,6 +2022,159 @@ static bool save_server_aux(char *name)
 }
 
 
+/* Value of a lowercase hex digit, or -1 */
+static int hex_digit(char c)
+{
+	if (c >= '0' && c <= '9') return (c - '0');
+	if (c >= 'a' && c <= 'f') return (c - 'a' + 10);
+	return (-1);
+}
+
+/*
+ * Write an untyped text value as the narrowest binary record which
+ * reads back as exactly the same text.
+ */
+static void write_text_value(char *name, char *value)
+{
+	char buf[1024];
+	hturn ht;
+	huge u;
+	s64b v;
+	int i, len = strlen(value);
+
+	/* Integers */
+	if (value[0] == '-' && sscanf(value, "%" SCNd64, &v) == 1)
+	{
+		strnfmt(buf, sizeof(buf), "%" PRId64, v);
+		if (!strcmp(buf, value) && v >= -0x7FFFFFFFL - 1)
+		{
+			write_int(name, (int)v);
+			return;
+		}
+	}
+	else if (value[0] != '-' && sscanf(value, "%" SCNu64, &u) == 1)
+	{
+		strnfmt(buf, sizeof(buf), "%" PRIu64, u);
+		if (!strcmp(buf, value))
+		{
+			if (u <= 0x7FFFFFFFL) write_int(name, (int)u);
+			else if (u <= 0xFFFFFFFFL) write_uint(name, (unsigned int)u);
+			else write_huge(name, u);
+			return;
+		}
+	}
+
+	/* Game turns */
+	if (sscanf(value, "%" SCNu64 " %" SCNu64, &ht.era, &ht.turn) == 2)
+	{
+		strnfmt(buf, sizeof(buf), "%" PRIu64 " %" PRIu64, ht.era, ht.turn);
+		if (!strcmp(buf, value))
+		{
+			write_hturn(name, &ht);
+			return;
+		}
+	}
+
+	/* Binary data, exactly as "%2x" prints it */
+	if (len && !(len % 2))
+	{
+		for (i = 0; i < len; i += 2)
+		{
+			if (value[i] != ' ' && hex_digit(value[i]) <= 0) break;
+			if (hex_digit(value[i + 1]) < 0) break;
+			buf[i / 2] = (char)((MAX(hex_digit(value[i]), 0) << 4) | hex_digit(value[i + 1]));
+		}
+		if (i == len)
+		{
+			write_binary(name, buf, len / 2);
+			return;
+		}
+	}
+
+	/* Anything else */
+	write_str(name, value);
+}
+
+/*
+ * Convert a savefile between the text and binary formats, in place.
+ * The previous file is kept as "<name>.old".
+ *
+ * Works on any savefile (player, server or level) as both formats
+ * describe themselves; nothing about the game has to be loaded.
+ */
+bool convert_savefile(cptr name)
+{
+	char safe[1024];
+	char temp[1024];
+	char rec_name[256];
+	char value[1024];
+	bool binary;
+	bool ok = TRUE;
+	int depth = 0, records = 0;
+	byte tag;
+
+	if (!rd_record_open(name, &binary))
+	{
+		plog(format("Cannot read savefile %s", name));
+		return (FALSE);
+	}
+
+	/* New savefile */
+	strnfmt(safe, sizeof(safe), "%s.new", name);
+	file_delete(safe);
+	file_handle = file_open(safe, MODE_WRITE, FTYPE_SAVE);
+	if (!file_handle)
+	{
+		rd_record_close();
+		plog(format("Cannot write savefile %s", safe));
+		return (FALSE);
+	}
+	start_savefile(!binary);
+
+	/* Copy every record across */
+	while ((tag = rd_record(rec_name, value)) != 0)
+	{
+		records++;
+		if (tag == SF_TAG_SECTION)
+		{
+			start_section(rec_name);
+			depth++;
+		}
+		else if (tag == SF_TAG_END)
+		{
+			end_section(rec_name);
+			if (--depth < 0) break;
+		}
+		else if (file_binary) write_text_value(rec_name, value);
+		else write_str(rec_name, value);
+	}
+	rd_record_close();
+
+	/* Truncated or garbled input */
+	if (depth || !records) ok = FALSE;
+
+	if (file_error(file_handle)) ok = FALSE;
+	if (!file_close(file_handle)) ok = FALSE;
+
+	if (!ok)
+	{
+		file_delete(safe);
+		plog(format("Failed to convert savefile %s (record %i)", name, records));
+		return (FALSE);
+	}
+
+	/* Preserve old savefile, activate the new one */
+	strnfmt(temp, sizeof(temp), "%s.old", name);
+	file_delete(temp);
+	file_move(name, temp);
+	file_move(safe, name);
+
+	plog(format("Converted %s to the %s format (%i records)", name,
+		binary ? "text" : "binary", records));
+	return (TRUE);
+}
+
+
 /*
  * Load the server info (artifacts created and uniques killed)
  * from a special savefile.
@@ -1655,6 +2193,9 @@ bool load_server_info(void)
 
 	path_build(buf, 1024, ANGBAND_DIR_SAVE, "server");
 
+	/* Note it for the input log */
+	replay_savefile(buf);
+
 #if !defined(MACINTOSH) && !defined(VM)
 
 	/* XXX XXX XXX Fix this */
@@ -1730,6 +2271,9 @@ bool save_server_info(void)
 	int result = FALSE;
 	char safe[1024];
 
+	/* Let pending autosaves land first */
+	autosave_wait();
+
 	/* New savefile */
 	path_build(safe, 1024, ANGBAND_DIR_SAVE, "server.new");
 
@@ -1764,6 +2308,342 @@ bool save_server_info(void)
 		result = TRUE;
 	}
 
+	/* Write the account index too, if it changed */
+	if (account_dirty)
+	{
+		path_build(safe, 1024, ANGBAND_DIR_SAVE, "accounts");
+		save_memory_begin();
+		save_memory_end(safe, wr_accounts());
+		account_dirty = FALSE;
+		autosave_wait();
+	}
+
 	/* Return the result */
 	return (result);
 }
+
+
+/*
+ * Background savefile writer.
+ *
+ * An autosave serializes everything into memory first, on the main
+ * thread, which is quick and never waits on the disk.  The buffers are
+ * then queued here, and a writer thread puts each one in "<name>.new",
+ * syncs it and moves it over "<name>" in one step, while the game keeps
+ * running.  Synchronous saves wait for the queue to drain first, so an
+ * older snapshot can never land on top of newer data.
+ *
+ * Without thread support the queue is simply written out at once.
+ */
+typedef struct save_job save_job;
+struct save_job
+{
+	char *name;		/* Target file */
+	char *buf;		/* Serialized savefile */
+	size_t len;
+	save_job *next;
+};
+
+static save_job *save_queue = NULL;	/* Jobs waiting, oldest first */
+static bool save_busy = FALSE;		/* Writer is working on a job */
+static size_t save_hint = 64 * 1024;	/* Initial buffer size */
+
+/* Statistics, for the "autosave" console command */
+static u32b save_count = 0;		/* Autosaves done */
+static u32b save_files = 0;		/* Files in the last autosave */
+static u32b save_failed = 0;		/* Files which could not be written */
+static micro save_snapshot = 0;	/* Main thread time (last autosave) */
+static micro save_write = 0;		/* Writer thread time (last autosave) */
+static u32b save_bytes = 0;		/* Bytes written (last autosave) */
+static huge save_bytes_total = 0;
+
+#if defined(WINDOWS)
+# define SAVE_THREAD
+static CRITICAL_SECTION save_mutex;
+static HANDLE save_work, save_idle;	/* Auto-reset events */
+# define save_lock()	EnterCriticalSection(&save_mutex)
+# define save_unlock()	LeaveCriticalSection(&save_mutex)
+# define save_wake_writer()	SetEvent(save_work)
+# define save_wake_waiter()	SetEvent(save_idle)
+# define save_wait_work()	(save_unlock(), WaitForSingleObject(save_work, INFINITE), save_lock())
+# define save_wait_idle()	(save_unlock(), WaitForSingleObject(save_idle, INFINITE), save_lock())
+#elif defined(HAVE_PTHREAD)
+# define SAVE_THREAD
+static pthread_mutex_t save_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t save_work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t save_idle = PTHREAD_COND_INITIALIZER;
+# define save_lock()	pthread_mutex_lock(&save_mutex)
+# define save_unlock()	pthread_mutex_unlock(&save_mutex)
+# define save_wake_writer()	pthread_cond_signal(&save_work)
+# define save_wake_waiter()	pthread_cond_broadcast(&save_idle)
+# define save_wait_work()	pthread_cond_wait(&save_work, &save_mutex)
+# define save_wait_idle()	pthread_cond_wait(&save_idle, &save_mutex)
+#else
+# define save_lock()
+# define save_unlock()
+#endif
+
+/*
+ * Write one job out.  Runs on the writer thread, so it must stay away
+ * from anything not thread-safe (plog, format, the game state).
+ */
+static void save_write_job(save_job *job)
+{
+	char safe[1024];
+	ang_file *fh;
+	bool ok;
+	micro spent;
+
+	(void)static_timer(6);
+
+	my_strcpy(safe, job->name, sizeof(safe));
+	my_strcat(safe, ".new", sizeof(safe));
+	file_delete(safe);
+
+	fh = file_open(safe, MODE_WRITE, FTYPE_SAVE);
+	ok = (fh != NULL);
+	if (fh)
+	{
+		if (!file_write(fh, job->buf, job->len)) ok = FALSE;
+		if (!file_sync(fh)) ok = FALSE;
+		if (!file_close(fh)) ok = FALSE;
+	}
+
+	/* Activate the new savefile, or forget it */
+	if (ok) ok = file_replace(safe, job->name);
+	if (!ok) file_delete(safe);
+
+	spent = static_timer(6);
+
+	save_lock();
+	save_write += spent;
+	if (ok)
+	{
+		save_bytes += job->len;
+		save_bytes_total += job->len;
+	}
+	else save_failed++;
+	save_unlock();
+
+	FREE(job->buf);
+	string_free(job->name);
+	FREE(job);
+}
+
+#ifdef SAVE_THREAD
+/* The writer thread */
+#if defined(WINDOWS)
+static DWORD WINAPI save_writer(LPVOID unused)
+#else
+static void *save_writer(void *unused)
+#endif
+{
+	save_job *job;
+
+	save_lock();
+	while (TRUE)
+	{
+		while (!save_queue) save_wait_work();
+
+		job = save_queue;
+		save_queue = job->next;
+		save_busy = TRUE;
+		save_unlock();
+
+		save_write_job(job);
+
+		save_lock();
+		save_busy = FALSE;
+		if (!save_queue) save_wake_waiter();
+	}
+
+	/* Never reached */
+	return 0;
+}
+
+/* Start the writer thread, once */
+static bool save_writer_start(void)
+{
+	static int started = 0;
+	if (started) return (started > 0);
+	started = -1;
+#if defined(WINDOWS)
+	InitializeCriticalSection(&save_mutex);
+	save_work = CreateEvent(NULL, FALSE, FALSE, NULL);
+	save_idle = CreateEvent(NULL, FALSE, FALSE, NULL);
+	if (save_work && save_idle && CreateThread(NULL, 0, save_writer, NULL, 0, NULL))
+		started = 1;
+#else
+	{
+		pthread_t thread;
+		if (!pthread_create(&thread, NULL, save_writer, NULL))
+		{
+			pthread_detach(thread);
+			started = 1;
+		}
+	}
+#endif
+	if (started < 0) plog("Cannot start the savefile writer thread, saving inline");
+	return (started > 0);
+}
+#endif
+
+/*
+ * Queue a serialized savefile for writing.  A job for the same file
+ * which has not been started yet is simply replaced.
+ */
+static void save_queue_job(cptr name, char *buf, size_t len)
+{
+	save_job *job, **tail;
+
+	save_lock();
+	for (tail = &save_queue; *tail; tail = &(*tail)->next)
+	{
+		job = *tail;
+		if (!strcmp(job->name, name))
+		{
+			FREE(job->buf);
+			job->buf = buf;
+			job->len = len;
+			save_unlock();
+			return;
+		}
+	}
+	MAKE(job, save_job);
+	job->name = (char*)string_make(name);
+	job->buf = buf;
+	job->len = len;
+	*tail = job;
+	save_unlock();
+
+#ifdef SAVE_THREAD
+	if (save_writer_start())
+	{
+		save_lock();
+		save_wake_writer();
+		save_unlock();
+		return;
+	}
+#endif
+
+	/* No thread, write it now */
+	autosave_wait();
+}
+
+/*
+ * Wait until every queued savefile is on the disk.
+ */
+void autosave_wait(void)
+{
+#ifdef SAVE_THREAD
+	if (save_writer_start())
+	{
+		save_lock();
+		while (save_queue || save_busy) save_wait_idle();
+		save_unlock();
+		return;
+	}
+#endif
+
+	/* Do it ourselves */
+	while (save_queue)
+	{
+		save_job *job = save_queue;
+		save_queue = job->next;
+		save_write_job(job);
+	}
+}
+
+/* Serialize into a fresh memory buffer */
+static void save_memory_begin(void)
+{
+	file_memory = TRUE;
+	file_handle = NULL;
+	save_size = save_hint;
+	save_buf = C_RNEW(save_size, char);
+	save_len = save_pos = 0;
+	start_savefile(cfg_save_binary);
+}
+
+/* Hand the memory buffer over to the writer */
+static void save_memory_end(cptr name, bool ok)
+{
+	file_memory = FALSE;
+	if (ok)
+	{
+		save_queue_job(name, save_buf, save_len);
+		save_files++;
+		save_hint = MAX(save_hint, save_len + save_len / 8);
+	}
+	else FREE(save_buf);
+	save_buf = NULL;
+}
+
+/*
+ * Autosave the server state and every player, without blocking on
+ * the disk.
+ */
+void autosave_game(void)
+{
+	char name[1024];
+	int i;
+
+	(void)static_timer(5);
+
+	/* New round of statistics */
+	save_lock();
+	save_files = 0;
+	save_bytes = 0;
+	save_write = 0;
+	save_unlock();
+
+	path_build(name, sizeof(name), ANGBAND_DIR_SAVE, "server");
+	save_memory_begin();
+	save_memory_end(name, wr_server_savefile());
+
+	for (i = 1; i <= NumPlayers; i++)
+	{
+		player_type *p_ptr = Players[i];
+		save_memory_begin();
+		save_memory_end(p_ptr->savefile, wr_savefile_new(p_ptr));
+		account_note(p_ptr);
+	}
+
+	/* The account index, if it changed */
+	if (account_dirty)
+	{
+		path_build(name, sizeof(name), ANGBAND_DIR_SAVE, "accounts");
+		save_memory_begin();
+		save_memory_end(name, wr_accounts());
+		account_dirty = FALSE;
+	}
+
+	save_count++;
+	save_snapshot = static_timer(5);
+}
+
+/*
+ * Describe the last autosave
+ */
+cptr autosave_status(void)
+{
+	int pending = 0;
+	save_job *job;
+
+	save_lock();
+	for (job = save_queue; job; job = job->next) pending++;
+	if (save_busy) pending++;
+	save_unlock();
+
+	return format("Autosaves: %lu, last: %lu files, %lu bytes, snapshot %ld us, "
+		"write %ld us, pending %d, failed %lu, total %" PRIu64 " bytes%s\n",
+		(unsigned long)save_count, (unsigned long)save_files,
+		(unsigned long)save_bytes, (long)save_snapshot, (long)save_write,
+		pending, (unsigned long)save_failed, save_bytes_total,
+#ifdef SAVE_THREAD
+		""
+#else
+		" (no writer thread)"
+#endif
+		);
+}
@@ -247,6 +247,9 @@ void teleport_player(player_type *p_ptr, int dis)
 	/* The player is on his new spot */
 	cave[Depth][y][x].m_idx = 0 - p_ptr->Ind;
 
+	/* Time bubble may change */
+	invalidate_time_factors(Depth);
+
 	/* Redraw the old spot */
 	everyone_lite_spot(Depth, oy, ox);
 
@@ -325,6 +328,9 @@ void teleport_player_to(player_type *p_ptr, int ny, int nx)
 	/* The player is now here */
 	cave[Depth][y][x].m_idx = 0 - p_ptr->Ind;
 
+	/* Time bubble may change */
+	invalidate_time_factors(Depth);
+
 	/* Redraw the old spot */
 	everyone_lite_spot(Depth, oy, ox);
 
@@ -458,7 +464,8 @@ void teleport_player_level(player_type *p_ptr)
 	forget_lite(p_ptr);
 	forget_view(p_ptr);
 
-	Depth = p_ptr->dun_depth = new_depth;
+	player_change_depth(p_ptr, new_depth);
+	Depth = new_depth;
 
 	/* One more player here */
 	players_on_depth[Depth]++;
@@ -572,6 +579,9 @@ void take_hit(player_type *p_ptr, int damage, cptr hit_from)
 	/* Hurt the player */
 	p_ptr->chp -= damage;
 
+	/* Time bubble may change */
+	invalidate_time_factors(p_ptr->dun_depth);
+
 	/* Update health bars */
 	update_health(0 - p_ptr->Ind);
 
@@ -1616,7 +1626,7 @@ static bool project_f(int who, int r, int Depth, int y, int x, int dam, int typ)
 				}
 
 				/* Destroy the tree */
-				c_ptr->feat = FEAT_DIRT;
+				cave_set_feat(Depth, y, x, FEAT_DIRT);
 				if (Depth == 0) trees_in_town--;
 			}
 
@@ -2185,7 +2195,7 @@ static bool project_i(int who, int r, int Depth, int y, int x, int dam, int typ)
 					object_known(o_ptr);
 
 					/* Notice */
-					if (!quiet && p_ptr->obj_vis[c_ptr->o_idx])
+					if (!quiet && idx_has(p_ptr->obj_vis, c_ptr->o_idx))
 					{
 						msg_print(p_ptr, "Click!");
 						obvious = TRUE;
@@ -2202,7 +2212,7 @@ static bool project_i(int who, int r, int Depth, int y, int x, int dam, int typ)
 	if (do_kill)
 	{
 		/* Effect "observed" */
-		if (!quiet && p_ptr->obj_vis[c_ptr->o_idx])
+		if (!quiet && idx_has(p_ptr->obj_vis, c_ptr->o_idx))
 		{
 			obvious = TRUE;
 			object_desc(p_ptr, o_name, sizeof(o_name), o_ptr, FALSE, 0);
@@ -2212,7 +2222,7 @@ static bool project_i(int who, int r, int Depth, int y, int x, int dam, int typ)
 		if (is_art || ignore)
 		{
 			/* Observe the resist */
-			if (!quiet && p_ptr->obj_vis[c_ptr->o_idx])
+			if (!quiet && idx_has(p_ptr->obj_vis, c_ptr->o_idx))
 			{
 				msg_format(p_ptr, "The %s %s unaffected!",
 				           o_name, (plural ? "are" : "is"));
@@ -2223,7 +2233,7 @@ static bool project_i(int who, int r, int Depth, int y, int x, int dam, int typ)
 		else
 		{
 			/* Describe if needed */
-			if (!quiet && p_ptr->obj_vis[c_ptr->o_idx] && note_kill)
+			if (!quiet && idx_has(p_ptr->obj_vis, c_ptr->o_idx) && note_kill)
 			{
 				msg_format(p_ptr, "The %s%s", o_name, note_kill);
 				sound(p_ptr, MSG_DESTROY);
@@ -2372,7 +2382,7 @@ static bool project_m(int who, int r, int Depth, int y, int x, int dam, int typ)
 
 	/* Set the "seen" flag */
 	if (!quiet)
-		seen = p_ptr->mon_vis[c_ptr->m_idx];
+		seen = idx_has(p_ptr->mon_vis, c_ptr->m_idx);
 	else seen = FALSE;
 
 	/* Extract radius */
@@ -2804,7 +2814,7 @@ static bool project_m(int who, int r, int Depth, int y, int x, int dam, int typ)
 			if (seen) obvious = TRUE;
 
 			/* Wake up */
-			m_ptr->csleep = 0;
+			set_monster_sleep(m_ptr, 0);
 
 			/* Heal */
 			m_ptr->hp += dam;
@@ -3387,7 +3397,7 @@ static bool project_m(int who, int r, int Depth, int y, int x, int dam, int typ)
 		update_health(c_ptr->m_idx);
 
 		/* Wake the monster up */
-		m_ptr->csleep = 0;
+		set_monster_sleep(m_ptr, 0);
 
 		/* Hurt the monster */
 		m_ptr->hp -= dam;
@@ -3415,7 +3425,7 @@ static bool project_m(int who, int r, int Depth, int y, int x, int dam, int typ)
 			else if (!quiet && dam > 0) message_pain(p_ptr, c_ptr->m_idx, dam);
 
 			/* Hack -- handle sleep */
-			if (do_sleep) m_ptr->csleep = do_sleep;
+			if (do_sleep) set_monster_sleep(m_ptr, do_sleep);
 		}
 	}
 
@@ -3440,7 +3450,7 @@ static bool project_m(int who, int r, int Depth, int y, int x, int dam, int typ)
 			else if (!quiet && dam > 0) message_pain(p_ptr, c_ptr->m_idx, dam);
 
 			/* Take note */
-			if (!quiet && (fear || do_fear) && (p_ptr->mon_vis[c_ptr->m_idx]) && !(r_ptr->flags2 & RF2_WANDERER))
+			if (!quiet && (fear || do_fear) && (idx_has(p_ptr->mon_vis, c_ptr->m_idx)) && !(r_ptr->flags2 & RF2_WANDERER))
 			{
 				/* Sound */
 				sound(p_ptr, MSG_FLEE);
@@ -3450,7 +3460,7 @@ static bool project_m(int who, int r, int Depth, int y, int x, int dam, int typ)
 			}
 
 			/* Hack -- handle sleep */
-			if (do_sleep) m_ptr->csleep = do_sleep;
+			if (do_sleep) set_monster_sleep(m_ptr, do_sleep);
 		}
 	}
 
@@ -4832,8 +4842,8 @@ bool project(int who, int rad, int Depth, int y, int x, int dam, int typ, int fl
 				if (m_idx > 0)
 				{
 					int r_idx = m_list[m_idx].r_idx;
-					if (p_ptr->mon_vis[m_idx]) monster_race_track(p_ptr, r_idx);
-					if (p_ptr->mon_vis[m_idx]) health_track(p_ptr, m_idx);
+					if (idx_has(p_ptr->mon_vis, m_idx)) monster_race_track(p_ptr, r_idx);
+					if (idx_has(p_ptr->mon_vis, m_idx)) health_track(p_ptr, m_idx);
 				}
 			}
 		}
@@ -4895,7 +4905,7 @@ bool project(int who, int rad, int Depth, int y, int x, int dam, int typ, int fl
 				/* Hack - auto-track player */
 				if (m_idx < 0)
 				{
-					if (p_ptr->play_vis[0 - m_idx]) health_track(p_ptr, m_idx);
+					if (idx_has(p_ptr->play_vis, 0 - m_idx)) health_track(p_ptr, m_idx);
 				}
 			}
 		}		
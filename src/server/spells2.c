@@ -80,6 +80,9 @@ void wipe_spell(int Depth, int cy, int cx, int r)
 
 			everyone_lite_spot(Depth, yy, xx);
 		}
+
+	/* The walls have moved, forget cached views */
+	view_stamp_on_depth[Depth]++;
 }
 
 
@@ -103,6 +106,9 @@ bool hp_player(player_type *p_ptr, int num)
 			p_ptr->chp_frac = 0;
 		}
 
+		/* Time bubble may change */
+		invalidate_time_factors(p_ptr->dun_depth);
+
 		/* Update health bars */
 		update_health(0 - p_ptr->Ind);
 
@@ -170,6 +176,9 @@ bool hp_player_quiet(player_type *p_ptr, int num)
 			p_ptr->chp_frac = 0;
 		}
 
+		/* Time bubble may change */
+		if (num) invalidate_time_factors(p_ptr->dun_depth);
+
 		/* Update health bars */
 		update_health(0 - p_ptr->Ind);
 
@@ -1034,6 +1043,7 @@ void self_knowledge(player_type *p_ptr, bool spoil)
 	/* HACK !!! --- Copy to rem_info */
 	for (k = 0; k < i; k++)
 	{
+		if (!text_info_row(p_ptr, k)) break;
 		e = strlen(info[k]);
 		for (j = 0; j < e; j++)
 		{
@@ -1365,13 +1375,13 @@ bool detect_treasure(player_type *p_ptr)
 			if (o_ptr->tval == TV_GOLD)
 			{
 				/* Notice new items */
-				if (!(p_ptr->obj_vis[c_ptr->o_idx]))
+				if (!(idx_has(p_ptr->obj_vis, c_ptr->o_idx)))
 				{
 					/* Detect */
 					detect = TRUE;
 
 					/* Hack -- memorize the item */
-					p_ptr->obj_vis[c_ptr->o_idx] = TRUE;
+					idx_on(p_ptr->obj_vis, c_ptr->o_idx);
 
 					/* Redraw */
 					lite_spot(p_ptr, y, x);
@@ -1447,13 +1457,13 @@ bool detect_objects_magic(player_type *p_ptr)
 			    ((o_ptr->to_a > 0) || (o_ptr->to_h + o_ptr->to_d > 0)))
 			{
 				/* Note new items */
-				if (!(p_ptr->obj_vis[c_ptr->o_idx]))
+				if (!(idx_has(p_ptr->obj_vis, c_ptr->o_idx)))
 				{
 					/* Detect */
 					detect = TRUE;
 
 					/* Memorize the item */
-					p_ptr->obj_vis[c_ptr->o_idx] = TRUE;
+					idx_on(p_ptr->obj_vis, c_ptr->o_idx);
 
 					/* Redraw */
 					lite_spot(p_ptr, i, j);
@@ -1482,7 +1492,7 @@ void give_detect(player_type *p_ptr, int m_idx)
 	power = 2 + ((p_ptr->lev + 2) / 5);
 
 	/* Also, let's scale down when spamming */
-	i = (m_idx < 0 ? p_ptr->play_det[0 - m_idx] : p_ptr->mon_det[m_idx]);
+	i = (m_idx < 0 ? p_ptr->play_det[0 - m_idx] : mon_det_turns(p_ptr, m_idx));
 	power = i ? 1 : power;
 
 	/* Players */
@@ -1495,8 +1505,7 @@ void give_detect(player_type *p_ptr, int m_idx)
 	/* Monsters */
 	else
 	{
-		p_ptr->mon_det[m_idx] = MIN(
-		    (int)p_ptr->mon_det[m_idx] + power, 255);
+		mon_det_set(p_ptr, m_idx, i + power);
 	}
 }
 
@@ -1548,7 +1557,7 @@ bool detect_invisible(player_type *p_ptr, bool pause)
 			give_detect(p_ptr, i);
 
 			/* Skip visible monsters */
-			if (p_ptr->mon_vis[i]) continue;
+			if (idx_has(p_ptr->mon_vis, i)) continue;
 
 			/* Take note that they are invisible */
 			l_ptr->flags2 |= RF2_INVISIBLE;
@@ -1588,7 +1597,7 @@ bool detect_invisible(player_type *p_ptr, bool pause)
 			give_detect(p_ptr, 0 - i);
 
 			/* Skip visible players */
-			if (p_ptr->play_vis[0 - i]) continue;
+			if (idx_has(p_ptr->play_vis, 0 - i)) continue;
 
 			/* Trigger detect effects */
 			flag = TRUE;
@@ -1750,7 +1759,7 @@ bool detect_creatures(player_type *p_ptr, bool pause)
 			give_detect(p_ptr, i);
 
 			/* Skip visible monsters */
-			if (p_ptr->mon_vis[i]) continue;
+			if (idx_has(p_ptr->mon_vis, i)) continue;
 
 			flag = TRUE;
 		}
@@ -1780,7 +1789,7 @@ bool detect_creatures(player_type *p_ptr, bool pause)
 			give_detect(p_ptr, 0 - i);
 
 			/* Skip visible players */
-			if (p_ptr->play_vis[i]) continue;
+			if (idx_has(p_ptr->play_vis, i)) continue;
 
 			/* Trigger detect effects */
 			flag = TRUE;
@@ -1895,13 +1904,13 @@ bool detect_objects_normal(player_type *p_ptr)
 			if (o_ptr->tval == TV_GOLD) continue;
 
 			/* Note new objects */
-			if (!(p_ptr->obj_vis[c_ptr->o_idx]))
+			if (!(idx_has(p_ptr->obj_vis, c_ptr->o_idx)))
 			{
 				/* Detect */
 				detect = TRUE;
 
 				/* Hack -- memorize it */
-				p_ptr->obj_vis[c_ptr->o_idx] = TRUE;
+				idx_on(p_ptr->obj_vis, c_ptr->o_idx);
 
 				/* Redraw */
 				lite_spot(p_ptr, i, j);
@@ -3342,7 +3351,7 @@ void aggravate_monsters(player_type *p_ptr, int who)
 			if (m_ptr->csleep)
 			{
 				/* Wake up */
-				m_ptr->csleep = 0;
+				set_monster_sleep(m_ptr, 0);
 				sleep = TRUE;
 			}
 		}
@@ -3742,6 +3751,9 @@ void destroy_area(int Depth, int y1, int x1, int r, bool full)
 			}
 		}
 	}
+
+	/* The walls have moved, forget cached views */
+	view_stamp_on_depth[Depth]++;
 }
 
 
@@ -3789,6 +3801,9 @@ static void monster_swap(int Depth, int y1, int x1, int y2, int x2)
 		p_ptr->py = y2;
 		p_ptr->px = x2;
 
+		/* Time bubble may change */
+		invalidate_time_factors(Depth);
+
 		/* Update the panel */
 		verify_panel(p_ptr);
 
@@ -3827,6 +3842,9 @@ static void monster_swap(int Depth, int y1, int x1, int y2, int x2)
 		p_ptr->py = y1;
 		p_ptr->px = x1;
 
+		/* Time bubble may change */
+		invalidate_time_factors(Depth);
+
 		/* Update the panel */
 		verify_panel(p_ptr);
 
@@ -4123,7 +4141,7 @@ void earthquake(int Depth, int cy, int cx, int r)
 					damage = (sn ? damroll(4, 8) : (m_ptr->hp + 1));
 
 					/* Monster is certainly awake */
-					m_ptr->csleep = 0;
+					set_monster_sleep(m_ptr, 0);
 
 					/* Apply damage directly */
 					m_ptr->hp -= damage;
@@ -4238,6 +4256,9 @@ void earthquake(int Depth, int cy, int cx, int r)
 		}
 	}
 
+	/* The walls have moved, forget cached views */
+	view_stamp_on_depth[Depth]++;
+
 	for (j = 0; j < count; j++)
 	{
 		/* Get player */
@@ -4341,10 +4362,10 @@ static void cave_temp_room_lite(player_type *p_ptr)
 			if (m_ptr->csleep && (randint0(100) < chance))
 			{
 				/* Wake up! */
-				m_ptr->csleep = 0;
+				set_monster_sleep(m_ptr, 0);
 
 				/* Notice the "waking up" */
-				if (p_ptr->mon_vis[c_ptr->m_idx])
+				if (idx_has(p_ptr->mon_vis, c_ptr->m_idx))
 				{
 					char m_name[80];
 
@@ -4857,8 +4878,8 @@ bool alter_reality(player_type *p_ptr, bool power)
 				/* Saving throw: perception (harder if hostile) */
 				if (randint0(127) < q_ptr->skill_fos * (pvp_okay(p_ptr, q_ptr, 0) ? 6 : 4))
 				{
-					msg_format(p_ptr, "%s sustains reality.", (p_ptr->play_los[i] ? q_ptr->name : "Someone"));
-					msg_format(q_ptr, "You resist %s's attempt to alter reality.", (q_ptr->play_los[p_ptr->Ind] ? p_ptr->name : "someone") );
+					msg_format(p_ptr, "%s sustains reality.", (idx_has(p_ptr->play_los, i) ? q_ptr->name : "Someone"));
+					msg_format(q_ptr, "You resist %s's attempt to alter reality.", (idx_has(q_ptr->play_los, p_ptr->Ind) ? p_ptr->name : "someone") );
 					return (FALSE);
 				}
 			}
@@ -1387,35 +1387,165 @@ char inkey(int Ind)
  * index, which should greatly reduce the need for inscription space.
  *
  * Note that "quark zero" is NULL and should not be "dereferenced".
+ *
+ * Quarks are found through an open addressing hash index, "quark__hash",
+ * which holds quark numbers (zero marks an empty bucket).
+ *
+ * Nothing counts references to quarks, instead, when the table gets
+ * crowded, "quark_collect()" marks every quark still held by an object,
+ * an artifact or a history event, and frees the rest.  Freed numbers are
+ * handed out again by "quark_add()".  This happens between game turns,
+ * so no quark can be held in a local variable at the time.
  */
 
+/* Quark numbers freed by the last collection */
+static s16b quark_free[QUARK_MAX];
+static int quark_free_num = 0;
+
+/* Quark table is getting full */
+static bool quark_crowded = FALSE;
+static int quark_collect_at = QUARK_MAX * 7 / 8;
+
+/* Hash a string for the quark index */
+static u32b quark_hash(cptr str)
+{
+	u32b h = 5381;
+	while (*str) h = (h * 33) ^ (byte)*str++;
+	return (h);
+}
+
 /*
  * Add a new "quark" to the set of quarks.
  */
 s16b quark_add(cptr str)
 {
+	u32b h;
 	int i;
 
 	/* Look for an existing quark */
-	for (i = 1; i < quark__num; i++)
+	for (h = quark_hash(str) & (QUARK_HASH - 1); (i = quark__hash[h]); h = (h + 1) & (QUARK_HASH - 1))
 	{
 		/* Check for equality */
 		if (streq(quark__str[i], str)) return (i);
 	}
 
+	/* Re-use a freed quark */
+	if (quark_free_num)
+	{
+		i = quark_free[--quark_free_num];
+	}
+
 	/* Paranoia -- Require room */
-	if (quark__num == QUARK_MAX) return (0);
+	else if (quark__num == QUARK_MAX)
+	{
+		/* Collect as soon as possible */
+		quark_crowded = TRUE;
+		return (0);
+	}
 
 	/* New maximal quark */
-	quark__num = i + 1;
+	else
+	{
+		i = quark__num++;
+	}
+
+	/* Time to think about collecting */
+	if (quark__num - quark_free_num > quark_collect_at) quark_crowded = TRUE;
 
 	/* Add a new quark */
 	quark__str[i] = string_make(str);
+	quark__hash[h] = i;
 
 	/* Return the index */
 	return (i);
 }
 
+/* Mark the quarks used by an object */
+static void quark_mark_object(bool *used, object_type *o_ptr)
+{
+	if (o_ptr->note < QUARK_MAX) used[o_ptr->note] = TRUE;
+	if (o_ptr->owner_name < QUARK_MAX) used[o_ptr->owner_name] = TRUE;
+	if (o_ptr->origin_player < QUARK_MAX) used[o_ptr->origin_player] = TRUE;
+}
+
+/* Mark the quarks used by a player */
+static void quark_mark_player(bool *used, player_type *p_ptr)
+{
+	history_event *evt;
+	int i;
+
+	for (i = 0; i < INVEN_TOTAL; i++)
+		quark_mark_object(used, &p_ptr->inventory[i]);
+
+	for (evt = p_ptr->charhist; evt; evt = evt->next)
+		if (evt->message < QUARK_MAX) used[evt->message] = TRUE;
+}
+
+/*
+ * Free the quarks nobody uses anymore, and rebuild the hash index.
+ */
+void quark_collect(void)
+{
+	bool *used;
+	int i, j, num;
+	u32b h;
+
+	/* Not needed */
+	if (!quark_crowded) return;
+	quark_crowded = FALSE;
+
+	C_MAKE(used, QUARK_MAX, bool);
+
+	/* Objects in the dungeon (and in houses) */
+	for (i = 1; i < o_max; i++) quark_mark_object(used, &o_list[i]);
+
+	/* Objects in the stores */
+	for (i = 0; i < MAX_STORES; i++)
+	{
+		for (j = 0; j < store[i].stock_num; j++)
+			quark_mark_object(used, &store[i].stock[j]);
+	}
+
+	/* Players' items and history, in game or still logging in */
+	for (i = 1; i <= NumPlayers; i++) quark_mark_player(used, Players[i]);
+	for (i = 0; i < players->num; i++) quark_mark_player(used, players->list[i]->data2);
+
+	/* Artifact owners */
+	for (i = 0; i < z_info->a_max; i++)
+	{
+		if (a_info[i].owner_name < QUARK_MAX) used[a_info[i].owner_name] = TRUE;
+	}
+
+	/* Free the rest, and rebuild the index */
+	C_WIPE(quark__hash, QUARK_HASH, s16b);
+	quark_free_num = 0;
+	for (i = 1; i < quark__num; i++)
+	{
+		if (quark__str[i] && !used[i])
+		{
+			string_free(quark__str[i]);
+			quark__str[i] = NULL;
+		}
+		if (!quark__str[i])
+		{
+			quark_free[quark_free_num++] = i;
+			continue;
+		}
+		for (h = quark_hash(quark__str[i]) & (QUARK_HASH - 1); quark__hash[h]; h = (h + 1) & (QUARK_HASH - 1)) ;
+		quark__hash[h] = i;
+	}
+
+	KILL(used);
+
+	/* Still crowded, do not try again every turn */
+	num = quark__num - quark_free_num;
+	quark_collect_at = MAX(QUARK_MAX * 7 / 8, num + QUARK_MAX / 16);
+	if (num > QUARK_MAX * 7 / 8)
+	{
+		plog(format("Quark table is crowded, %d inscriptions in use", num));
+	}
+}
+
 
 /*
  * This function looks up a quark
@@ -2070,7 +2200,7 @@ void msg_format_monster(int m_idx, player_type *q_ptr, u16b type, cptr fmt_vis,
 		    !(m_ptr->closest_player == qq_ptr->Ind)) continue;
 
 		/* Can he see this monster? */
-		if (qq_ptr->mon_vis[m_idx])
+		if (idx_has(qq_ptr->mon_vis, m_idx))
 		{
 			/* Send "normal" message */
 			msg_print_aux(qq_ptr, buf_vis, type);
@@ -3031,6 +3161,76 @@ void send_prepared_info(player_type *p_ptr, byte win, byte stream, byte extra_pa
 	p_ptr->last_info_line = -1;
 }
 
+/*
+ * Like "send_prepared_info()", but only send the lines which differ
+ * from what "sent" remembers sending last time. The client keeps the
+ * rows past its last line around (it just doesn't show them), and so
+ * does "sent".
+ */
+void send_prepared_diff(player_type *p_ptr, byte win, byte stream, sent_text_type *sent)
+{
+	byte old_term = p_ptr->remote_term;
+	int wid = MIN(p_ptr->stream_wid[stream], SENT_TEXT_WID);
+	int last = MIN(p_ptr->last_info_line, p_ptr->stream_hgt[stream] - 1);
+	bool active = FALSE;
+	bool reset;
+	int i;
+
+	/* Forget everything */
+	if (!sent->rows)
+	{
+		C_MAKE(sent->rows, SENT_TEXT_HGT, cave_view_type[SENT_TEXT_WID]);
+	}
+	else if (!sent->known)
+	{
+		C_WIPE(sent->rows, SENT_TEXT_HGT, cave_view_type[SENT_TEXT_WID]);
+	}
+
+	/* A different line count needs a NTERM_CLEAR and the last line */
+	reset = (!sent->known || last != sent->last_line);
+
+	for (i = 0; i <= last; i++)
+	{
+		/* Compare with the copy */
+		if (i < SENT_TEXT_HGT)
+		{
+			if (!(reset && i == last) &&
+			    !memcmp(sent->rows[i], p_ptr->info[i], wid * sizeof(cave_view_type)))
+				continue;
+			C_COPY(sent->rows[i], p_ptr->info[i], wid, cave_view_type);
+		}
+
+		if (!active)
+		{
+			send_term_info(p_ptr, NTERM_ACTIVATE, win);
+			if (reset) send_term_info(p_ptr, NTERM_CLEAR, 0);
+			active = TRUE;
+		}
+		stream_line_as(p_ptr, stream, i, i);
+	}
+
+	/* Empty window */
+	if (reset && !active)
+	{
+		send_term_info(p_ptr, NTERM_ACTIVATE, win);
+		send_term_info(p_ptr, NTERM_CLEAR, 0);
+		active = TRUE;
+	}
+
+	/* Refresh, restore active term */
+	if (active)
+	{
+		send_term_info(p_ptr, NTERM_FRESH, 0);
+		send_term_info(p_ptr, NTERM_ACTIVATE, old_term);
+	}
+
+	sent->last_line = last;
+	sent->known = TRUE;
+
+	/* Hack -- erase 'prepared info' */
+	p_ptr->last_info_line = -1;
+}
+
 void send_prepared_popup(player_type *p_ptr, cptr header)
 {
 	int i;
@@ -3084,6 +3284,14 @@ void text_out_done()
 	player_type	*p_ptr = player_textout;
 	player_textout = NULL;
 
+	/* Paranoia -- make sure the last line exists */
+	if (!text_info_row(p_ptr, p_ptr->cur_hgt))
+	{
+		p_ptr->last_info_line = -1;
+		p_ptr->cur_hgt = MAX_HGT;
+		return;
+	}
+
 	/* BAD HACK -- notify client about abrupt endings */
 	if (p_ptr->cur_hgt >= MAX_TXT_INFO-1)
 	{
@@ -3111,39 +3319,86 @@ void text_out_done()
 	p_ptr->cur_wid = MAX_WID;
 }
 
+/*
+ * Make sure row "row" of the player's "info" buffer exists.
+ *
+ * The buffer starts small (see "player_alloc()") and grows in
+ * chunks, up to MAX_TXT_INFO rows. New rows are blank. Returns
+ * FALSE if the row is out of bounds.
+ */
+bool text_info_row(player_type *p_ptr, int row)
+{
+	cave_view_type (*old)[MAX_WID] = p_ptr->info;
+	int rows, i, j;
+
+	/* Paranoia */
+	if (row < 0 || row >= MAX_TXT_INFO) return FALSE;
+
+	/* Already there */
+	if (row < p_ptr->info_rows) return TRUE;
+
+	/* Round up to the next chunk */
+	rows = MIN((row / TEXT_INFO_CHUNK + 1) * TEXT_INFO_CHUNK, MAX_TXT_INFO);
+
+	/* Grow */
+	C_MAKE(p_ptr->info, rows, cave_view_type[MAX_WID]);
+	if (old) C_COPY(p_ptr->info, old, p_ptr->info_rows, cave_view_type[MAX_WID]);
+	for (j = p_ptr->info_rows; j < rows; j++)
+	{
+		for (i = 0; i < MAX_WID; i++)
+		{
+			p_ptr->info[j][i].c = ' ';
+			p_ptr->info[j][i].a = TERM_DARK;
+		}
+	}
+	p_ptr->info_rows = rows;
+
+	/* Hack -- text streams point into the buffer */
+	if (old)
+	{
+		for (i = 0; i < MAX_STREAMS; i++)
+		{
+			if (p_ptr->stream_cave[i] == &old[0][0])
+				p_ptr->stream_cave[i] = &p_ptr->info[0][0];
+		}
+		FREE(old);
+	}
+
+	return TRUE;
+}
+
 /* Taking (bad) ques from client code, here we copy one
  * buffer into another, instead of just storing pointer
  * to the correct buffer somewhere... */
 /* The reason is all the current functions are hard-wired
  * to use p_ptr->info, so instead of massive overhaul (like making
  * *IT* a pointer), we add a literal workaround. */
+/* The copy only lives until "text_out_load()" */
 /* TODO: Kill this. */
 void text_out_save(player_type *p_ptr)
 {
-	int i, j;
-	/* memcpy is for cowards */
-	for (j = 0; j < MAX_TXT_INFO; j++)
+	int rows = MIN(p_ptr->last_info_line + 1, p_ptr->info_rows);
+
+	p_ptr->last_file_line = rows - 1;
+	if (rows <= 0) return;
+
+	/* The copy is kept around, sub-windows need it every turn */
+	if (rows > p_ptr->file_rows)
 	{
-		for (i = 0; i < MAX_WID; i++)
-		{
-			p_ptr->file[j][i].a = p_ptr->info[j][i].a;
-			p_ptr->file[j][i].c = p_ptr->info[j][i].c;
-		}
+		if (p_ptr->file) KILL(p_ptr->file);
+		C_MAKE(p_ptr->file, p_ptr->info_rows, cave_view_type[MAX_WID]);
+		p_ptr->file_rows = p_ptr->info_rows;
 	}
-	p_ptr->last_file_line = p_ptr->last_info_line;
+	C_COPY(p_ptr->file, p_ptr->info, rows, cave_view_type[MAX_WID]);
 }
 void text_out_load(player_type *p_ptr)
 {
-	/* mindless code duplication. */
-	int i, j;
+	int rows = p_ptr->last_file_line + 1;
 
-	for (j = 0; j < MAX_TXT_INFO; j++)
+	if (p_ptr->file && rows > 0)
 	{
-		for (i = 0; i < MAX_WID; i++)
-		{
-			p_ptr->info[j][i].a = p_ptr->file[j][i].a;
-			p_ptr->info[j][i].c = p_ptr->file[j][i].c;
-		}
+		if (text_info_row(p_ptr, rows - 1))
+			C_COPY(p_ptr->info, p_ptr->file, rows, cave_view_type[MAX_WID]);
 	}
 	p_ptr->last_info_line = p_ptr->last_file_line;
 	/* I hope you'll delete those functions ASAP */
@@ -3176,6 +3431,7 @@ void text_out_c(byte a, cptr buf)
 	{
 		/* Problem -- Out of stack space :( */
 		if (p_ptr->cur_hgt >= MAX_TXT_INFO-1) break;
+		if (!text_info_row(p_ptr, p_ptr->cur_hgt)) break;
 
 #if 0
 		/* Add 1 space between stuff (auto-separate) */
@@ -3250,8 +3506,8 @@ void text_out_c(byte a, cptr buf)
 			line_buf[i] = ' ';
 		}
 
-		/* Dump it */
-		for (i = p_ptr->cur_wid-j; i < 80; i++)
+		/* Dump it (an ignored '\n' leaves us at -1) */
+		for (i = MAX(p_ptr->cur_wid-j, 0); i < 80; i++)
 		{
 			p_ptr->info[p_ptr->cur_hgt][i].c = line_buf[i];
 			p_ptr->info[p_ptr->cur_hgt][i].a = a;
@@ -3283,7 +3539,7 @@ void text_out(cptr str)
 void c_prt(player_type *p_ptr, byte attr, cptr str, int row, int col)
 {
 	/* Paranoia */
-	if (row > MAX_TXT_INFO) return;
+	if (!text_info_row(p_ptr, row)) return;
 
 	while (*str)
 	{
@@ -3305,6 +3561,7 @@ void prt(player_type *p_ptr, cptr str, int row, int col)
 void clear_line(player_type *p_ptr, int row)
 {
 	int i;
+	if (!text_info_row(p_ptr, row)) return;
 	for (i = 0; i < 80; i++)
 	{
 		p_ptr->info[row][i].c = ' ';
@@ -3314,7 +3571,8 @@ void clear_line(player_type *p_ptr, int row)
 void clear_from(player_type *p_ptr, int row)
 {
 	int i;
-	while (row < MAX_TXT_INFO)
+	/* Rows past "info_rows" are blank already */
+	while (row < p_ptr->info_rows)
 	{
 		for (i = 0; i < 80; i++)
 		{
@@ -53,6 +53,9 @@ u16b sf_saves;			/* Number of "saves" during this life */
 cptr arg_config_file = NULL;	/* Command arg -- Desired config file */
 bool arg_wizard;		/* Command arg -- Enter wizard mode */
 bool arg_fiddle;		/* Command arg -- Enter fiddle mode */
+cptr arg_record_file = NULL;	/* Command arg -- Record input to this file */
+cptr arg_replay_file = NULL;	/* Command arg -- Replay input from this file */
+bool arg_replay_fast;		/* Command arg -- Replay as fast as possible */
 bool arg_force_original;	/* Command arg -- Force original keyset */
 bool arg_force_roguelike;	/* Command arg -- Force roguelike keyset */
 
@@ -110,6 +113,24 @@ byte level_rand_x[MAX_DEPTH];
 s16b players_on_world[MAX_DEPTH + MAX_WILD];
 s16b *players_on_depth=&(players_on_world[MAX_WILD]);  /* How many players are at each depth */
 
+player_type *p_first_on_world[MAX_DEPTH + MAX_WILD];
+player_type **p_first_on_depth=&(p_first_on_world[MAX_WILD]);  /* First player at each depth */
+s16b m_first_on_world[MAX_DEPTH + MAX_WILD];
+s16b *m_first_on_depth=&(m_first_on_world[MAX_WILD]);  /* First monster at each depth */
+s16b m_num_on_world[MAX_DEPTH + MAX_WILD];
+s16b *m_num_on_depth=&(m_num_on_world[MAX_WILD]);  /* How many monsters are at each depth */
+flow_type *flow_on_world[MAX_DEPTH + MAX_WILD];
+flow_type **flow_on_depth=&(flow_on_world[MAX_WILD]);  /* Monster flow at each depth */
+u32b view_stamp_on_world[MAX_DEPTH + MAX_WILD];
+u32b *view_stamp_on_depth=&(view_stamp_on_world[MAX_WILD]);  /* Bumped when cached views go stale */
+u32b bubble_stamp_on_world[MAX_DEPTH + MAX_WILD];
+u32b *bubble_stamp_on_depth=&(bubble_stamp_on_world[MAX_WILD]);  /* Bumped when time bubbles may change */
+
+u32b view_updates;	/* View updates done */
+u32b view_partial;	/* ... of which only some octants */
+u32b view_shared;	/* ... of which copied from another player */
+u32b view_grids;	/* Grids evaluated by them */
+
 s16b special_levels[MAX_SPECIAL_LEVELS]; /* List of depths which are special static levels */
 
 char summon_kin_type;		/* Hack -- See summon_specific() */
@@ -155,8 +176,8 @@ bool scan_objects;		/* Hack -- optimize multi-hued code, etc */
 /*s16b inven_cnt;*/			/* Number of items in inventory */
 /*s16b equip_cnt;*/			/* Number of items in equipment */
 
-s32b o_nxt = 1;			/* Object free scanner */
-s32b m_nxt = 1;			/* Monster free scanner */
+s32b o_free_num = 0;		/* Object free stack size */
+s32b m_free_num = 0;		/* Monster free stack size */
 
 s32b o_max = 1;			/* Object heap size */
 s32b m_max = 1;			/* Monster heap size */
@@ -192,6 +213,8 @@ s32b cfg_retire_timer = -1;
 bool cfg_ironman = 0;
 bool cfg_more_towns = 0;
 bool cfg_town_wall = 0;
+bool cfg_monster_flow = 1;
+s16b cfg_level_pool = 8;
 s32b cfg_unique_respawn_time = 300;
 s32b cfg_unique_max_respawn_time = 50000;
 s16b cfg_max_townies = 100;
@@ -210,6 +233,8 @@ bool cfg_party_share_kill = FALSE;
 bool cfg_party_share_win = TRUE;
 s16b cfg_party_sharelevel = -1;
 bool cfg_instance_closed = FALSE;
+bool cfg_save_binary = FALSE;
+char * cfg_tick_trace = NULL;
 
 
 
@@ -365,6 +390,11 @@ s16b quark__num;
  */
 cptr *quark__str;
 
+/*
+ * The hash index of the quarks [QUARK_HASH]
+ */
+s16b *quark__hash;
+
 
 /*
  * The next "free" index to use
@@ -427,6 +457,12 @@ s16b o_fast[MAX_O_IDX];
  */
 s16b m_fast[MAX_M_IDX];
 
+/*
+ * The stacks of free (dead and excised) object and monster indexes
+ */
+s16b o_free[MAX_O_IDX];
+s16b m_free[MAX_M_IDX];
+
 
 /*
  * The array of "cave grids" [MAX_WID][MAX_HGT].
@@ -633,6 +669,7 @@ char *r_name;
 char *r_text;
 char *r_char_s; /* copy of r_info characters */
 byte *r_attr_s; /* copy of r_info attributes */
+u16b *r_count_s; /* race counters for "display_monlist()", kept zeroed */
 
 
 /*
@@ -179,38 +179,29 @@ void init_wild_info()
 
 void wild_apply_day(int Depth)
 {
-	int x,y;
-	cave_type *c_ptr;
+	int i;
+	cave_type *c_ptr = &cave[Depth][0][0];
 
-	/* scan the level */
-	for (y = 0; y < MAX_HGT; y++)
+	/* scan the level (rows are contiguous) */
+	for (i = 0; i < MAX_HGT * MAX_WID; i++, c_ptr++)
 	{
-		for (x = 0; x < MAX_WID; x++)
-		{
-			c_ptr = &cave[Depth][y][x];
-			c_ptr->info |= CAVE_GLOW;
-		}
+		c_ptr->info |= CAVE_GLOW;
 	}
 }
 
 void wild_apply_night(int Depth)
 {
-	int x,y;
-	cave_type *c_ptr;
+	int i;
+	cave_type *c_ptr = &cave[Depth][0][0];
 
-	/* scan the level */
-	for (y = 0; y < MAX_HGT; y++)
+	/* scan the level (rows are contiguous) */
+	for (i = 0; i < MAX_HGT * MAX_WID; i++, c_ptr++)
 	{
-		for (x = 0; x < MAX_WID; x++)
+		/* Darken the features */
+		if (!(c_ptr->info & CAVE_ROOM))
 		{
-			c_ptr = &cave[Depth][y][x];
-			
-			/* Darken the features */
-			if (!(c_ptr->info & CAVE_ROOM))
-			{
-				/* Darken the grid */
-				c_ptr->info &= ~CAVE_GLOW;
-			}
+			/* Darken the grid */
+			c_ptr->info &= ~CAVE_GLOW;
 		}
 	}
 }
@@ -1191,7 +1191,7 @@ static void cursor_redraw(player_type *p_ptr)
 		}
 
 		/* Tracking an unseen player */
-		else if (!p_ptr->play_vis[0 - p_ptr->cursor_who])
+		else if (!idx_has(p_ptr->play_vis, 0 - p_ptr->cursor_who))
 		{
 			/* Should not be possible */
 			vis = 0;
@@ -1214,7 +1214,7 @@ static void cursor_redraw(player_type *p_ptr)
 	}
 
 	/* Tracking an unseen monster */
-	else if (!p_ptr->mon_vis[p_ptr->cursor_who])
+	else if (!idx_has(p_ptr->mon_vis, p_ptr->cursor_who))
 	{
 		/* Reset cursor */
 		vis = 0;
@@ -1309,7 +1309,7 @@ static void health_redraw(player_type *p_ptr)
 		}
 
 		/* Tracking an unseen player */
-		else if (!p_ptr->play_vis[0 - p_ptr->health_who])
+		else if (!idx_has(p_ptr->play_vis, 0 - p_ptr->health_who))
 		{
 			/* Indicate that the player health is "unknown" */
 			attr = TERM_WHITE;
@@ -1356,7 +1356,7 @@ static void health_redraw(player_type *p_ptr)
 	}
 
 	/* Tracking an unseen monster */
-	else if (!p_ptr->mon_vis[p_ptr->health_who])
+	else if (!idx_has(p_ptr->mon_vis, p_ptr->health_who))
 	{
 		/* Indicate that the monster health is "unknown" */
 		attr = TERM_WHITE;
@@ -1424,8 +1424,8 @@ static void fix_monlist(player_type *p_ptr)
 	/* Prepare 'visible monsters' list */
 	display_monlist(p_ptr);
 
-	/* Send it */
-	send_prepared_info(p_ptr, NTERM_WIN_MONLIST, STREAM_MONLIST_TEXT, 0);
+	/* Send what changed */
+	send_prepared_diff(p_ptr, NTERM_WIN_MONLIST, STREAM_MONLIST_TEXT, &p_ptr->sent_monlist);
 
 	/* HACK -- Load other player info */
 	text_out_load(p_ptr);
@@ -1448,8 +1448,8 @@ static void fix_itemlist(player_type *p_ptr)
 	/* Prepare 'visible monsters' list */
 	display_itemlist(p_ptr);
 
-	/* Send it */
-	send_prepared_info(p_ptr, NTERM_WIN_ITEMLIST, STREAM_ITEMLIST_TEXT, 0);
+	/* Send what changed */
+	send_prepared_diff(p_ptr, NTERM_WIN_ITEMLIST, STREAM_ITEMLIST_TEXT, &p_ptr->sent_itemlist);
 
 	/* HACK -- Load other player info */
 	text_out_load(p_ptr);
@@ -2034,6 +2034,9 @@ static void calc_hitpoints(player_type *p_ptr)
 		/* Check bounds (sometimes chp = mhp + 1) */
 		if (p_ptr->chp > p_ptr->mhp) p_ptr->chp = p_ptr->mhp;
 
+		/* Time bubble may change */
+		invalidate_time_factors(p_ptr->dun_depth);
+
 		/* Display hitpoints (later) */
 		p_ptr->redraw |= (PR_HP);
 
@@ -3208,7 +3211,16 @@ void update_stuff(player_type *p_ptr)
 
 	if (p_ptr->update & PU_VIEW)
 	{
-		p_ptr->update &= ~(PU_VIEW);
+		p_ptr->update &= ~(PU_VIEW | PU_VIEW_OCT);
+
+		/* Not just walls or doors, recalculate everything */
+		p_ptr->view_dirty = 0;
+		update_view(p_ptr);
+	}
+
+	if (p_ptr->update & PU_VIEW_OCT)
+	{
+		p_ptr->update &= ~(PU_VIEW_OCT);
 		update_view(p_ptr);
 	}
 
@@ -3222,7 +3234,7 @@ void update_stuff(player_type *p_ptr)
 	if (p_ptr->update & PU_FLOW)
 	{
 		p_ptr->update &= ~(PU_FLOW);
-		update_flow();
+		update_flow(p_ptr);
 	}
 
 
@@ -3534,6 +3546,25 @@ void window_stuff(player_type *p_ptr)
 		fix_monster(p_ptr);
 	}
 
+	/* Note: PW_MONLIST and PW_ITEMLIST wait for "window_stuff_tick()" */
+}
+
+
+/*
+ * Handle the "p_ptr->window" flags which are only worth doing once
+ * per game turn (see "dungeon()"). In a fight, "update_mon()" sets
+ * PW_MONLIST after almost every move.
+ */
+void window_stuff_tick(player_type *p_ptr)
+{
+	if (p_ptr->conn == -1 || !IS_PLAYING(p_ptr)) return;
+
+	/* Hack -- delay updating */
+	if (p_ptr->new_level_flag) return;
+
+	/* Let a congested client catch up first */
+	if (player_congested(p_ptr)) return;
+
 	/* Display monster list */
 	if (p_ptr->window & PW_MONLIST)
 	{
@@ -3571,9 +3602,15 @@ void handle_stuff(player_type *p_ptr)
 		p_ptr->redraw_inven = 0;
 	}
 
+	/* Let a congested client catch up first (retried every turn) */
+	if (player_congested(p_ptr)) return;
+
 	/* Redraw stuff */
 	if (p_ptr->redraw) redraw_stuff(p_ptr);
 
 	/* Window stuff */
 	if (p_ptr->window) window_stuff(p_ptr);
+
+	/* Send changed map grids */
+	if (p_ptr->tile_dirty_any) stream_flush_tiles(p_ptr);
 }
@@ -355,6 +355,9 @@ bool set_paralyzed(player_type *p_ptr, int v)
 	/* Nothing to notice */
 	if (!notice) return (FALSE);
 
+	/* Time bubble may change */
+	invalidate_time_factors(p_ptr->dun_depth);
+
 	/* Disturb */
 	if (option_p(p_ptr,DISTURB_STATE)) disturb(p_ptr, 0, 0);
 
@@ -2159,7 +2162,7 @@ void monster_death(player_type *p_ptr, int m_idx)
 		q_ptr = Players[i];
 		if (q_ptr->in_hack)
 		{
-			bool visible = (q_ptr->mon_vis[m_idx] || unique);
+			bool visible = (idx_has(q_ptr->mon_vis, m_idx) || unique);
 
 			/* Take note of the killer (message) */
 			if (unique && !same_player(q_ptr, p_ptr))
@@ -2683,6 +2686,9 @@ void player_death(player_type *p_ptr)
 	{
 		p_ptr->death = FALSE;
 		p_ptr->chp = p_ptr->chp_frac = 0;
+
+		/* Time bubble may change */
+		invalidate_time_factors(p_ptr->dun_depth);
 		return;
 	}
 
@@ -2792,6 +2798,9 @@ void player_death(player_type *p_ptr)
 	p_ptr->chp = p_ptr->mhp;
 	p_ptr->chp_frac = 0;
 
+	/* Time bubble may change */
+	invalidate_time_factors(p_ptr->dun_depth);
+
 	/* Ghost! */
 	if (p_ptr->fruit_bat != -1)
 	{
@@ -2938,13 +2947,13 @@ bool mon_take_hit(player_type *p_ptr, int m_idx, int dam, bool *fear, cptr note)
 	if (m_idx == 0) return TRUE;
 
 	/* Remember that he hurt it */
-	p_ptr->mon_hrt[m_idx] = TRUE;
+	idx_on(p_ptr->mon_hrt, m_idx);
 
 	/* Redraw (later) if needed */
 	update_health(m_idx);
 
 	/* Wake it up */
-	m_ptr->csleep = 0;
+	set_monster_sleep(m_ptr, 0);
 
 	/* Hurt it */
 	m_ptr->hp -= dam;
@@ -2981,7 +2990,7 @@ bool mon_take_hit(player_type *p_ptr, int m_idx, int dam, bool *fear, cptr note)
 		}
 
 		/* Death by physical attack -- invisible monster */
-		else if (!p_ptr->mon_vis[m_idx])
+		else if (!idx_has(p_ptr->mon_vis, m_idx))
 		{
 			msg_format_near(p_ptr, "%s has killed %s.", p_ptr->name, m_name);
 			msg_format(p_ptr, "You have killed %s.", m_name);
@@ -3052,7 +3061,7 @@ bool mon_take_hit(player_type *p_ptr, int m_idx, int dam, bool *fear, cptr note)
 		//if (r_ptr->flags1 & RF1_UNIQUE) r_ptr->max_num = 0;
 
 		/* Recall even invisible uniques or winners */
-		if (p_ptr->mon_vis[m_idx] || (r_ptr->flags1 & RF1_UNIQUE))
+		if (idx_has(p_ptr->mon_vis, m_idx) || (r_ptr->flags1 & RF1_UNIQUE))
 		{
 			/* Count kills by all players */
 			if (r_ptr->r_tkills < MAX_SHORT) r_ptr->r_tkills++;
@@ -3544,7 +3553,7 @@ bool target_able(player_type *p_ptr, int m_idx)
 		m_ptr = &m_list[m_idx];
 
 		/* Monster must be visible */
-		if (!p_ptr->mon_vis[m_idx]) return (FALSE);
+		if (!idx_has(p_ptr->mon_vis, m_idx)) return (FALSE);
 
 		/* Monster must be projectable */
 		if (!projectable(p_ptr->dun_depth, p_ptr->py, p_ptr->px, m_ptr->fy, m_ptr->fx)) return (FALSE);
@@ -3829,21 +3838,21 @@ static bool target_set_interactive_accept(player_type *p_ptr, int y, int x)
 	if (c_ptr->m_idx < 0)
 	{
 		/* Visible monsters */
-		if (p_ptr->play_vis[0 - c_ptr->m_idx]) return (TRUE);
+		if (idx_has(p_ptr->play_vis, 0 - c_ptr->m_idx)) return (TRUE);
 	}
 	
 	/* Visible monsters */
 	if (c_ptr->m_idx > 0)
 	{
 		/* Visible monsters */
-		if (p_ptr->mon_vis[c_ptr->m_idx]) return (TRUE);
+		if (idx_has(p_ptr->mon_vis, c_ptr->m_idx)) return (TRUE);
 	}
 	
 	/* Objects */
 	if (c_ptr->o_idx)
 	{
 		/* Memorized object */
-		if (p_ptr->obj_vis[c_ptr->o_idx]) return (TRUE);	
+		if (idx_has(p_ptr->obj_vis, c_ptr->o_idx)) return (TRUE);	
 	}
 #if 0
 	/* Scan all objects in the grid */
@@ -4067,7 +4076,7 @@ static void target_set_interactive_aux(player_type *p_ptr, int y, int x, int mod
 	}
 
 	/* Visible player */
-	else if (m_idx < 0 && p_ptr->play_vis[0 - m_idx])
+	else if (m_idx < 0 && idx_has(p_ptr->play_vis, 0 - m_idx))
 	{
 		player_type *q_ptr = Players[0 - m_idx];
 	
@@ -4104,7 +4113,7 @@ static void target_set_interactive_aux(player_type *p_ptr, int y, int x, int mod
 	}
 
 	/* Visible monster */
-	else if (m_idx > 0 && p_ptr->mon_vis[m_idx])
+	else if (m_idx > 0 && idx_has(p_ptr->mon_vis, m_idx))
 	{
 		monster_type *m_ptr = &m_list[m_idx];
 		char m_name[80];
@@ -4140,7 +4149,7 @@ static void target_set_interactive_aux(player_type *p_ptr, int y, int x, int mod
 	}
 
 	/* Visible Object */
-	else if (o_idx > 0 && p_ptr->obj_vis[o_idx])
+	else if (o_idx > 0 && idx_has(p_ptr->obj_vis, o_idx))
 	{
 		object_type *o_ptr = &o_list[o_idx];
 		
@@ -5122,7 +5131,7 @@ bool monsters_in_los(player_type *p_ptr)
 	for (i = 1; i < m_max; i++)
 	{
 		/* Check this monster */
-		if ((p_ptr->mon_los[i] && !m_list[i].csleep))
+		if ((idx_has(p_ptr->mon_los, i) && !m_list[i].csleep))
 		{
 			los = TRUE;
 			break;
@@ -5137,7 +5146,7 @@ bool monsters_in_los(player_type *p_ptr)
 		if (p_ptr->conn <= -1) break; /* Can't check hostility */
 
 		/* Check this player */
-		if ((p_ptr->play_los[i]) && !q_ptr->paralyzed)
+		if ((idx_has(p_ptr->play_los, i)) && !q_ptr->paralyzed)
 		{
 			if (check_hostile(p_ptr, q_ptr))
 			{
@@ -5149,6 +5158,21 @@ bool monsters_in_los(player_type *p_ptr)
 	return los;
 }
 
+/* Time bubble "generations". Each player caches the result of his last
+ * full base_time_factor() call together with the game turn, his level and
+ * the level's bubble generation it was computed in. A chain of bubbles
+ * never leaves its level, so a change only needs to bump the generation
+ * of the level it happened on; the new turn catches anything else.
+ *
+ * Forget the cached time bubble factors of all players on a level. This
+ * must be called whenever something that feeds into a time bubble changes
+ * -- player HP, position or paralysis, monsters or players entering/leaving
+ * LoS or waking up, players arriving or leaving, resting or running. */
+void invalidate_time_factors(int Depth)
+{
+	bubble_stamp_on_depth[Depth]++;
+}
+
 /* Determine the speed of a given players "time bubble" and return a percentage 
  * scaling factor which should be applied to any amount of energy granted to 
  * players/monsters within the bubble.
@@ -5159,17 +5183,26 @@ bool monsters_in_los(player_type *p_ptr)
  * each others range. Forming a time bubble chain. :)
  * 
  * When calling this function pass slowest as zero, which acts as a flag
- * that this is the main call, not a recursive call.
+ * that this is the main call, not a recursive call. The result of the
+ * main call is memoized for the rest of the turn, or until the next
+ * invalidate_time_factors() on its level, so calling it once per monster
+ * per turn is cheap.
  */
 int base_time_factor(player_type *p_ptr, int slowest)
 {
 	player_type * q_ptr;
 	int i, dist, health, timefactor;
-	bool los;
+	bool los, initial = (slowest ? FALSE : TRUE);
 	
 	/* If this is the initial call, reset all players time bubble check */
-	if(!slowest)
+	if(initial)
 	{
+		/* Hack -- use cached value */
+		if ((p_ptr->bubble_depth == p_ptr->dun_depth) &&
+		    (p_ptr->bubble_stamp == bubble_stamp_on_depth[p_ptr->dun_depth]) &&
+		    ht_eq(&p_ptr->bubble_turn, &turn))
+			return p_ptr->bubble_factor;
+
 		for (i = 1; i <= NumPlayers; i++)
 		{
 			q_ptr = Players[i];
@@ -5244,6 +5277,15 @@ int base_time_factor(player_type *p_ptr, int slowest)
 			if(slowest < timefactor) timefactor = slowest;
 		}
 	}		
+
+	/* Remember result of the main call */
+	if (initial)
+	{
+		p_ptr->bubble_factor = timefactor;
+		p_ptr->bubble_depth = p_ptr->dun_depth;
+		p_ptr->bubble_stamp = bubble_stamp_on_depth[p_ptr->dun_depth];
+		p_ptr->bubble_turn = turn;
+	}
 		
 	return timefactor;
 }